@@ -0,0 +1,324 @@
+﻿/*! \file baseline.cpp
+    \brief ベンチマークの結果を基準として保存し、新しい結果と比較する関数の実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+// boost::property_treeが古い形式でboost/bind.hppを読み込み、警告が出るのを抑える
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+
+#include "baseline.h"
+#include <algorithm>                            // for std::max, std::min, std::sort
+#include <cmath>                                // for std::erfc, std::fabs, std::sqrt
+#include <fstream>                              // for std::ofstream
+#include <map>                                  // for std::map
+#include <system_error>                         // for std::system_error
+#include <utility>                              // for std::pair
+#include <boost/format.hpp>                     // for boost::format
+#include <boost/property_tree/json_parser.hpp>  // for boost::property_tree::read_json
+#include <boost/property_tree/ptree.hpp>        // for boost::property_tree::ptree
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            Mann–Whitney U検定で、Uの厳密な分布を求める標本の大きさの積の上限
+        */
+        static auto constexpr EXACTMAX = static_cast<std::size_t>(2500);
+
+        //! A function.
+        /*!
+            同順位がないときの、Mann–Whitney U検定の両側p値を、Uの厳密な分布から求める
+            Uがkになる並べ方の数は、q二項係数[n1 + n2, n1]_qのq^kの係数になる
+            \param n1 一つ目の標本の大きさ
+            \param n2 二つ目の標本の大きさ
+            \param u 一つ目の標本のU統計量
+            \return 両側p値
+        */
+        double mann_whitney_exact_p(std::size_t n1, std::size_t n2, double u);
+
+        //! A function.
+        /*!
+            同順位がないときに、Mann–Whitney U検定の両側p値が取り得る最小の値を求める
+            \param n1 一つ目の標本の大きさ
+            \param n2 二つ目の標本の大きさ
+            \return 両側p値の最小値（2 / C(n1 + n2, n1)）
+        */
+        double mann_whitney_min_p(std::size_t n1, std::size_t n2);
+
+        //! A function.
+        /*!
+            マイクロベンチマークの結果を識別する文字列を返す
+            \param name ベンチマークの名称
+            \param size 問題の大きさ
+            \return 識別する文字列
+        */
+        std::string micro_key(std::string const & name, std::uint64_t size);
+
+        //! A function.
+        /*!
+            スケーリングの結果を識別する文字列を返す
+            \param mode スケーリングの種類
+            \param threads スレッド数
+            \param trials 試行回数
+            \return 識別する文字列
+        */
+        std::string scaling_key(std::string const & mode, std::int32_t threads, std::uint64_t trials);
+
+        //! A function.
+        /*!
+            標本の可変長配列をJSONの配列にして出力する
+            \param os 出力先のストリーム
+            \param samples 標本の可変長配列
+        */
+        void write_samples(std::ostream & os, std::vector<double> const & samples);
+    }
+
+    // #region 非メンバ関数
+
+    std::vector<Comparison> compare_baseline(
+        std::string const & filename,
+        std::vector<BenchResult> const & micro,
+        std::vector<ScalingResult> const & scaling,
+        double alpha,
+        double threshold)
+    {
+        namespace pt = boost::property_tree;
+
+        pt::ptree root;
+        pt::read_json(filename, root);
+
+        // 基準の標本を、識別する文字列で引けるようにする
+        std::map<std::string, std::vector<double>> base;
+        auto const read_samples = [](pt::ptree const & node) {
+            std::vector<double> samples;
+            for (auto const & s : node.get_child("samples")) {
+                samples.push_back(s.second.get_value<double>());
+            }
+
+            return samples;
+        };
+
+        if (auto const m = root.get_child_optional("micro")) {
+            for (auto const & e : *m) {
+                base[micro_key(e.second.get<std::string>("name"), e.second.get<std::uint64_t>("size"))] = read_samples(e.second);
+            }
+        }
+
+        if (auto const s = root.get_child_optional("scaling")) {
+            for (auto const & e : *s) {
+                base[scaling_key(e.second.get<std::string>("mode"), e.second.get<std::int32_t>("threads"), e.second.get<std::uint64_t>("trials"))] = read_samples(e.second);
+            }
+        }
+
+        std::vector<Comparison> comparisons;
+        auto const compare = [&base, &comparisons, alpha, threshold](std::string const & key, std::vector<double> const & samples) {
+            auto const med = median(samples);
+            auto const itr = base.find(key);
+            if (itr == base.end()) {
+                comparisons.push_back({ key, false, false, 0.0, med, 1.0, false, false });
+
+                return;
+            }
+
+            // 繰り返しの回数が少なすぎると、どれだけ差があってもp値がalpha未満にならない
+            auto const testable = mann_whitney_min_p(itr->second.size(), samples.size()) < alpha;
+            auto const basemedian = median(itr->second);
+            auto const p = mann_whitney_p(itr->second, samples);
+
+            comparisons.push_back({
+                key,
+                true,
+                testable,
+                basemedian,
+                med,
+                p,
+                testable && p < alpha && med >= basemedian * (1.0 + threshold),
+                testable && p < alpha && med * (1.0 + threshold) <= basemedian });
+        };
+
+        for (auto const & r : micro) {
+            compare(micro_key(r.name, r.size), r.samples);
+        }
+
+        for (auto const & r : scaling) {
+            compare(scaling_key(r.mode, r.threads, r.trials), r.samples);
+        }
+
+        return comparisons;
+    }
+
+    double mann_whitney_p(std::vector<double> const & x, std::vector<double> const & y)
+    {
+        auto const n1 = static_cast<double>(x.size());
+        auto const n2 = static_cast<double>(y.size());
+        if (x.empty() || y.empty()) {
+            return 1.0;
+        }
+
+        // 二つの標本をまとめて順位を付ける（値とxの標本かどうか）
+        std::vector<std::pair<double, bool>> all;
+        all.reserve(x.size() + y.size());
+        for (auto v : x) {
+            all.emplace_back(v, true);
+        }
+        for (auto v : y) {
+            all.emplace_back(v, false);
+        }
+
+        std::sort(all.begin(), all.end(), [](auto const & a, auto const & b) { return a.first < b.first; });
+
+        // 同順位には平均の順位を付け、xの順位の和と同順位の補正項を求める
+        auto rankx = 0.0;
+        auto ties = 0.0;
+        for (auto i = 0U; i < all.size();) {
+            auto j = i;
+            while (j < all.size() && all[j].first == all[i].first) {
+                j++;
+            }
+
+            auto const t = static_cast<double>(j - i);
+            auto const rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+            for (auto k = i; k < j; k++) {
+                if (all[k].second) {
+                    rankx += rank;
+                }
+            }
+
+            ties += t * t * t - t;
+            i = j;
+        }
+
+        auto const n = n1 + n2;
+        auto const u = rankx - n1 * (n1 + 1.0) / 2.0;
+        if (ties <= 0.0 && x.size() * y.size() <= EXACTMAX) {
+            return mann_whitney_exact_p(x.size(), y.size(), u);
+        }
+
+        auto const mu = n1 * n2 / 2.0;
+        auto const sigma = std::sqrt(n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0))));
+        if (sigma <= 0.0) {
+            return 1.0;
+        }
+
+        auto const z = std::max(std::fabs(u - mu) - 0.5, 0.0) / sigma;
+
+        return std::erfc(z / std::sqrt(2.0));
+    }
+
+    void print_comparisons(std::ostream & os, std::vector<Comparison> const & comparisons)
+    {
+        os << boost::format("%-44s %14s %14s %8s %10s  %s\n") % "benchmark" % "baseline" % "current" % "ratio" % "p-value" % "判定";
+
+        for (auto const & c : comparisons) {
+            if (!c.found) {
+                os << boost::format("%-44s %14s %14.3f %8s %10s  %s\n") % c.key % "n/a" % c.median % "n/a" % "n/a" % "基準なし";
+
+                continue;
+            }
+
+            os << boost::format("%-44s %14.3f %14.3f %8.3f %10.2e  %s\n")
+                  % c.key
+                  % c.basemedian
+                  % c.median
+                  % (c.basemedian > 0.0 ? c.median / c.basemedian : 0.0)
+                  % c.pvalue
+                  % (!c.testable ? "標本不足" : c.slower ? "遅くなった" : c.faster ? "速くなった" : "有意差なし");
+        }
+    }
+
+    void save_baseline(std::string const & filename, std::vector<BenchResult> const & micro, std::vector<ScalingResult> const & scaling)
+    {
+        std::ofstream ofs(filename);
+        if (!ofs) {
+            throw std::system_error(std::make_error_code(std::errc::io_error), filename);
+        }
+
+        ofs << "{\"version\":1,\n\"micro\":[";
+        for (auto i = 0U; i < micro.size(); i++) {
+            auto const & r = micro[i];
+            ofs << boost::format("%s\n{\"name\":\"%s\",\"size\":%d,\"unit\":\"%s\",\"median_ns\":%.17g,\"mad_ns\":%.17g,\"samples\":")
+                   % (i ? "," : "") % r.name % r.size % r.unit % r.median % r.mad;
+            write_samples(ofs, r.samples);
+            ofs << '}';
+        }
+
+        ofs << "],\n\"scaling\":[";
+        for (auto i = 0U; i < scaling.size(); i++) {
+            auto const & r = scaling[i];
+            ofs << boost::format("%s\n{\"mode\":\"%s\",\"threads\":%d,\"trials\":%d,\"median_ms\":%.17g,\"mad_ms\":%.17g,\"rss_kB\":%d,\"samples\":")
+                   % (i ? "," : "") % r.mode % r.threads % r.trials % r.median % r.mad % r.rss;
+            write_samples(ofs, r.samples);
+            ofs << '}';
+        }
+
+        ofs << "]}\n";
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        double mann_whitney_exact_p(std::size_t n1, std::size_t n2, double u)
+        {
+            // q二項係数を、∏_{k = 1}^{n1} (1 - q^(n2 + k)) / (1 - q^k)として一つずつ掛けて求める
+            // 途中の多項式も全てq二項係数なので、係数は全て0以上の整数になる
+            std::vector<double> c(n1 * n2 + 1, 0.0);
+            c[0] = 1.0;
+            for (auto k = 1U; k <= n1; k++) {
+                auto const a = n2 + k;
+                for (auto i = c.size() - 1; i >= a; i--) {
+                    c[i] -= c[i - a];
+                }
+
+                for (auto i = static_cast<std::size_t>(k); i < c.size(); i++) {
+                    c[i] += c[i - k];
+                }
+            }
+
+            // Uの分布は(n1 * n2) / 2について対称なので、近い方の裾の確率を二倍する
+            auto const lower = static_cast<std::size_t>(std::min(u, static_cast<double>(n1 * n2) - u) + 0.5);
+            auto tail = 0.0, total = 0.0;
+            for (auto i = 0U; i < c.size(); i++) {
+                tail += i <= lower ? c[i] : 0.0;
+                total += c[i];
+            }
+
+            return std::min(2.0 * tail / total, 1.0);
+        }
+
+        double mann_whitney_min_p(std::size_t n1, std::size_t n2)
+        {
+            if (!n1 || !n2) {
+                return 1.0;
+            }
+
+            // C(n1 + n2, n1)
+            auto combinations = 1.0;
+            for (auto k = 1U; k <= n1; k++) {
+                combinations = combinations * static_cast<double>(n2 + k) / static_cast<double>(k);
+            }
+
+            return std::min(2.0 / combinations, 1.0);
+        }
+
+        std::string micro_key(std::string const & name, std::uint64_t size)
+        {
+            return (boost::format("micro/%s/%d") % name % size).str();
+        }
+
+        std::string scaling_key(std::string const & mode, std::int32_t threads, std::uint64_t trials)
+        {
+            return (boost::format("scaling/%s/%d/%d") % mode % threads % trials).str();
+        }
+
+        void write_samples(std::ostream & os, std::vector<double> const & samples)
+        {
+            os << '[';
+            for (auto i = 0U; i < samples.size(); i++) {
+                os << boost::format("%s%.17g") % (i ? "," : "") % samples[i];
+            }
+            os << ']';
+        }
+    }
+}
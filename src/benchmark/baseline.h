@@ -0,0 +1,126 @@
+﻿/*! \file baseline.h
+    \brief ベンチマークの結果を基準として保存し、新しい結果と比較する関数の宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BASELINE_H_
+#define _BASELINE_H_
+
+#pragma once
+
+#include "benchrunner.h"
+#include "scaling.h"
+#include <ostream>              // for std::ostream
+#include <string>               // for std::string
+#include <vector>               // for std::vector
+
+namespace benchmark {
+    //! A structure.
+    /*!
+        一つのベンチマークの、基準と新しい結果の比較を格納する構造体
+    */
+    struct Comparison {
+        //! A public member variable.
+        /*!
+            ベンチマークを識別する文字列（"micro/名称/大きさ"または"scaling/種類/スレッド数/試行回数"）
+        */
+        std::string key;
+
+        //! A public member variable.
+        /*!
+            基準にこのベンチマークがあったかどうか（なければ、基準の中央値とp値は比較しない）
+        */
+        bool found;
+
+        //! A public member variable.
+        /*!
+            標本の大きさで到達できる最小のp値が有意水準未満かどうか（未満でなければ、遅くなったかどうかは判定しない）
+        */
+        bool testable;
+
+        //! A public member variable.
+        /*!
+            基準の中央値
+        */
+        double basemedian;
+
+        //! A public member variable.
+        /*!
+            新しい結果の中央値
+        */
+        double median;
+
+        //! A public member variable.
+        /*!
+            Mann–Whitney U検定の両側p値
+        */
+        double pvalue;
+
+        //! A public member variable.
+        /*!
+            有意に遅くなったかどうか
+        */
+        bool slower;
+
+        //! A public member variable.
+        /*!
+            有意に速くなったかどうか
+        */
+        bool faster;
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        新しい結果を、JSONファイルに保存された基準と比較する
+        中央値の比が1 + threshold以上で、かつp値がalpha未満なら「遅くなった」とする
+        基準にないベンチマークは、比較せずに「基準なし」として返す
+        繰り返しの回数が少なく、p値がalpha未満になり得ないベンチマークは、判定せずに「標本不足」として返す
+        \param filename 基準のJSONファイル名
+        \param micro マイクロベンチマークの結果
+        \param scaling スケーリングの結果
+        \param alpha 有意水準
+        \param threshold 遅くなったとみなす中央値の比の増分
+        \return 比較の結果の可変長配列
+    */
+    std::vector<Comparison> compare_baseline(
+        std::string const & filename,
+        std::vector<BenchResult> const & micro,
+        std::vector<ScalingResult> const & scaling,
+        double alpha,
+        double threshold);
+
+    //! A function.
+    /*!
+        Mann–Whitney U検定の両側p値を求める
+        同順位がなく標本が小さければUの厳密な分布から、そうでなければ正規近似（同順位と連続性の補正付き）で求める
+        \param x 一つ目の標本
+        \param y 二つ目の標本
+        \return 両側p値（標本が空か、全て同じ値なら1）
+    */
+    double mann_whitney_p(std::vector<double> const & x, std::vector<double> const & y);
+
+    //! A function.
+    /*!
+        比較の結果を表にして出力する
+        \param os 出力先のストリーム
+        \param comparisons 比較の結果の可変長配列
+    */
+    void print_comparisons(std::ostream & os, std::vector<Comparison> const & comparisons);
+
+    //! A function.
+    /*!
+        結果を、繰り返しごとの標本も含めてJSONファイルに保存する
+        \param filename ファイル名
+        \param micro マイクロベンチマークの結果
+        \param scaling スケーリングの結果
+    */
+    void save_baseline(std::string const & filename, std::vector<BenchResult> const & micro, std::vector<ScalingResult> const & scaling);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _BASELINE_H_
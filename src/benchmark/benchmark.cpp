@@ -0,0 +1,394 @@
+﻿/*! \file benchmark.cpp
+    \brief カーネル、乱数、集計関数のマイクロベンチマークと、シミュレーションのスケーリングの計測、MCとRQMCの同じ経過時間での精度の比較
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "baseline.h"
+#include "benchrunner.h"
+#include "convergence.h"
+#include "scaling.h"
+#include "../checkpoint/trialtrace.h"
+#include "../mabinogi_roulette_MC/montecarlo/geometric.h"
+#include "../mabinogi_roulette_MC/montecarlo/montecarlo.h"
+#include "../mabinogi_roulette_MC/myrandom/myrand.h"
+#include "../mabinogi_roulette_MC/myrandom/myrandsfmt.h"
+#include "../mabinogi_roulette_MC/statistics/statistics.h"
+#include <algorithm>                            // for std::any_of
+#include <cstdint>                              // for std::int32_t, std::int64_t, std::uint64_t
+#include <cstdlib>                              // for EXIT_FAILURE
+#include <exception>                            // for std::exception
+#include <iostream>                             // for std::cerr, std::cout
+#include <random>                               // for std::mt19937_64, std::uniform_int_distribution
+#include <string>                               // for std::string
+#include <vector>                               // for std::vector
+#include <boost/format.hpp>                     // for boost::format
+#include <boost/program_options.hpp>            // for boost::program_options
+#include <tbb/task_arena.h>                     // for tbb::this_task_arena::max_concurrency
+
+namespace {
+    //! A global variable.
+    /*!
+        計測した処理の結果を書き込んで、最適化で処理が消えないようにするための変数
+    */
+    volatile std::int64_t sink;
+
+    //! A function.
+    /*!
+        マスが埋まる順番と幾何分布の待ち時間から一回の試行を作るカーネルを、一様乱数の組の生成も含めて計測する
+        \param runner ベンチマークを実行するオブジェクト
+        \param name ベンチマークの名称
+        \param trials 一回の計測で行う試行回数
+    */
+    template <typename MyRandom>
+    void bench_geometric(benchmark::BenchRunner & runner, std::string const & name, std::uint64_t trials);
+
+    //! A function.
+    /*!
+        ビンゴのカーネルを計測する
+        \param runner ベンチマークを実行するオブジェクト
+        \param name ベンチマークの名称
+        \param trials 一回の計測で行う試行回数
+    */
+    template <typename MyRandom>
+    void bench_kernel(benchmark::BenchRunner & runner, std::string const & name, std::uint64_t trials);
+
+    //! A function.
+    /*!
+        自作乱数クラスを計測する
+        \param runner ベンチマークを実行するオブジェクト
+        \param name ベンチマークの名称
+        \param count 一回の計測で生成する乱数の個数
+    */
+    template <typename MyRandom>
+    void bench_rng(benchmark::BenchRunner & runner, std::string const & name, std::uint64_t count);
+
+    //! A function.
+    /*!
+        集計関数を計測する
+        \param runner ベンチマークを実行するオブジェクト
+        \param trials 合成データの試行回数
+    */
+    void bench_statistics(benchmark::BenchRunner & runner, std::uint64_t trials);
+
+    //! A function.
+    /*!
+        モンテカルロ・シミュレーションの結果と同じ形の合成データを生成する
+        乱数で、行・列とマスが埋まった回数が単調に増える列を作る
+        \param trials 試行回数
+        \return 行・列が埋まったときの結果と、マスが埋まったときの結果のstd::pair
+    */
+    std::pair<statistics::mcresult_t, statistics::mcresult_t> make_synthetic(std::uint64_t trials);
+
+    //! A function.
+    /*!
+        マイクロベンチマークを実行する
+        \param vm コマンドラインオプション
+        \param runner ベンチマークを実行するオブジェクト
+    */
+    void run_micro(boost::program_options::variables_map const & vm, benchmark::BenchRunner & runner);
+}
+
+int main(int argc, char * argv[])
+{
+    namespace po = boost::program_options;
+
+    // コマンドラインオプションの定義
+    po::options_description desc("オプション");
+    desc.add_options()
+        ("help,h", "ヘルプを表示する")
+        ("suite", po::value<std::string>()->default_value("micro"), "実行するベンチマーク（micro、scaling、rqmc、all）")
+        ("warmup", po::value<std::int32_t>()->default_value(2), "計測の前に捨てる実行の回数")
+        ("repetitions", po::value<std::int32_t>()->default_value(11), "計測する回数")
+        ("cpu", po::value<std::int32_t>()->default_value(0), "固定する論理CPUの番号（負なら固定しない）")
+        ("kernel-trials", po::value<std::uint64_t>()->default_value(10000), "カーネルの一回の計測で行う試行回数")
+        ("rng-count", po::value<std::uint64_t>()->default_value(1000000), "乱数の一回の計測で生成する個数")
+        ("min-trials", po::value<std::uint64_t>()->default_value(10000), "集計関数の合成データの最小の試行回数")
+        ("max-trials", po::value<std::uint64_t>()->default_value(1000000), "集計関数の合成データの最大の試行回数（10倍ずつ増やす。1e8では数十GBのメモリが必要）")
+        ("max-threads", po::value<std::int32_t>()->default_value(tbb::this_task_arena::max_concurrency()), "スケーリングを測る最大のスレッド数（1, 2, 4, …と倍にしていく）")
+        ("strong-trials", po::value<std::vector<std::uint64_t>>()->multitoken()->default_value({ 100000 }, "100000"), "強スケーリングを測る試行回数の合計（複数指定できる）")
+        ("weak-trials", po::value<std::vector<std::uint64_t>>()->multitoken()->default_value({ 25000 }, "25000"), "弱スケーリングを測るスレッドあたりの試行回数（複数指定できる）")
+        ("scaling-repetitions", po::value<std::int32_t>()->default_value(5), "スケーリングの一つの構成を計測する回数（基準と有意水準0.01で比較するには5回以上）")
+        ("rqmc-points", po::value<std::vector<std::uint64_t>>()->multitoken()->default_value({ 1024, 16384 }, "1024 16384"), "MCとRQMCを比べる、一つの複製の点の数（複数指定できる）")
+        ("rqmc-replicates", po::value<std::uint64_t>()->default_value(16), "MCとRQMCを比べるときの独立な複製の数")
+        ("seed", po::value<std::uint64_t>()->default_value(1), "MCとRQMCを比べるときの乱数のシード")
+        ("csv", "結果を表ではなくcsv形式で出力する")
+        ("save-baseline", po::value<std::string>(), "結果を基準としてJSONファイルに保存する")
+        ("compare-baseline", po::value<std::string>(), "結果をJSONファイルに保存された基準と比較し、有意に遅くなっていたら異常終了する")
+        ("alpha", po::value<double>()->default_value(0.01), "基準と比較するときの有意水準")
+        ("threshold", po::value<double>()->default_value(0.05), "遅くなったとみなす中央値の比の増分（0.05なら5%以上）");
+
+    // コマンドラインオプションを解析
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (po::error const & e) {
+        std::cerr << e.what() << '\n' << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc;
+
+        return 0;
+    }
+
+    auto const suite = vm["suite"].as<std::string>();
+    if (suite != "micro" && suite != "scaling" && suite != "rqmc" && suite != "all") {
+        std::cerr << boost::format("不明なベンチマークです: %s\n") % suite << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    benchmark::BenchRunner runner(vm["warmup"].as<std::int32_t>(), vm["repetitions"].as<std::int32_t>());
+    benchmark::ScalingRunner scaling(
+        vm["scaling-repetitions"].as<std::int32_t>(),
+        benchmark::thread_counts(vm["max-threads"].as<std::int32_t>()));
+
+    if (suite == "micro" || suite == "all") {
+        run_micro(vm, runner);
+
+        if (vm.count("csv")) {
+            runner.print_csv(std::cout);
+        }
+        else {
+            runner.print_table(std::cout);
+        }
+    }
+
+    if (suite == "scaling" || suite == "all") {
+        for (auto const trials : vm["strong-trials"].as<std::vector<std::uint64_t>>()) {
+            scaling.strong(trials);
+        }
+
+        for (auto const trials : vm["weak-trials"].as<std::vector<std::uint64_t>>()) {
+            scaling.weak(trials);
+        }
+
+        if (vm.count("csv")) {
+            scaling.print_csv(std::cout);
+        }
+        else {
+            scaling.print_table(std::cout);
+        }
+    }
+
+    if (suite == "rqmc" || suite == "all") {
+        benchmark::ConvergenceRunner convergence(vm["rqmc-replicates"].as<std::uint64_t>(), vm["seed"].as<std::uint64_t>());
+        for (auto const points : vm["rqmc-points"].as<std::vector<std::uint64_t>>()) {
+            convergence.measure(points);
+        }
+
+        if (vm.count("csv")) {
+            convergence.print_csv(std::cout);
+        }
+        else {
+            convergence.print_table(std::cout);
+        }
+    }
+
+    try {
+        if (vm.count("save-baseline")) {
+            benchmark::save_baseline(vm["save-baseline"].as<std::string>(), runner.results(), scaling.results());
+        }
+
+        if (vm.count("compare-baseline")) {
+            auto const comparisons = benchmark::compare_baseline(
+                vm["compare-baseline"].as<std::string>(),
+                runner.results(),
+                scaling.results(),
+                vm["alpha"].as<double>(),
+                vm["threshold"].as<double>());
+
+            benchmark::print_comparisons(std::cout, comparisons);
+
+            if (std::any_of(comparisons.begin(), comparisons.end(), [](auto const & c) { return !c.found; })) {
+                std::cerr << "基準にないベンチマークは比較していません（基準なし）\n";
+            }
+
+            if (std::any_of(comparisons.begin(), comparisons.end(), [](auto const & c) { return c.found && !c.testable; })) {
+                std::cerr << boost::format("繰り返しの回数が少なく、p値が有意水準%g未満になり得ないベンチマークは判定していません（標本不足）。repetitionsまたはscaling-repetitionsを増やしてください\n")
+                             % vm["alpha"].as<double>();
+            }
+
+            if (std::any_of(comparisons.begin(), comparisons.end(), [](auto const & c) { return c.slower; })) {
+                std::cerr << "基準より有意に遅くなったベンチマークがあります\n";
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    catch (std::exception const & e) {
+        std::cerr << e.what() << '\n';
+
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
+
+namespace {
+    void run_micro(boost::program_options::variables_map const & vm, benchmark::BenchRunner & runner)
+    {
+        // 計測の間だけ、このスレッドを一つの論理CPUに固定する
+        benchmark::ScopedThreadPin const pin(vm["cpu"].as<std::int32_t>());
+        if (!pin.pinned() && vm["cpu"].as<std::int32_t>() >= 0) {
+            std::cerr << boost::format("論理CPU %dに固定できませんでした\n") % vm["cpu"].as<std::int32_t>();
+        }
+
+        auto const kerneltrials = vm["kernel-trials"].as<std::uint64_t>();
+        bench_kernel<myrandom::MyRandSfmt>(runner, "montecarloImpl/MyRandSfmt", kerneltrials);
+        bench_kernel<myrandom::MyRand>(runner, "montecarloImpl/MyRand", kerneltrials);
+        bench_geometric<myrandom::MyRandSfmt>(runner, "montecarloGeometric/MyRandSfmt", kerneltrials);
+        bench_geometric<myrandom::MyRand>(runner, "montecarloGeometric/MyRand", kerneltrials);
+
+        auto const rngcount = vm["rng-count"].as<std::uint64_t>();
+        bench_rng<myrandom::MyRandSfmt>(runner, "MyRandSfmt::myrand", rngcount);
+        bench_rng<myrandom::MyRand>(runner, "MyRand::myrand", rngcount);
+
+        runner.run("makeboard", kerneltrials, kerneltrials, "board", [kerneltrials] {
+            std::int64_t s = 0;
+            for (auto i = 0ULL; i < kerneltrials; i++) {
+                s += montecarlo::makeboard().front().first;
+            }
+
+            sink = s;
+        });
+
+        for (auto trials = vm["min-trials"].as<std::uint64_t>(); trials && trials <= vm["max-trials"].as<std::uint64_t>(); trials *= 10) {
+            bench_statistics(runner, trials);
+        }
+    }
+
+    template <typename MyRandom>
+    void bench_geometric(benchmark::BenchRunner & runner, std::string const & name, std::uint64_t trials)
+    {
+        MyRandom mr(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE));
+
+        runner.run(name, trials, trials, "trial", [&mr, trials] {
+            montecarlo::uniforms_t u;
+            std::int64_t s = 0;
+            for (auto i = 0ULL; i < trials; i++) {
+                montecarlo::fill_uniforms(mr, u);
+                s += montecarlo::montecarloGeometric(u).first.back().first;
+            }
+
+            sink = s;
+        });
+    }
+
+    template <typename MyRandom>
+    void bench_kernel(benchmark::BenchRunner & runner, std::string const & name, std::uint64_t trials)
+    {
+        MyRandom mr(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE));
+
+        runner.run(name, trials, trials, "trial", [&mr, trials] {
+            std::int64_t s = 0;
+            for (auto i = 0ULL; i < trials; i++) {
+                checkpoint::TrialTrace<false> trace;
+                s += montecarlo::montecarloImpl(mr, trace).first.back().first;
+            }
+
+            sink = s;
+        });
+    }
+
+    template <typename MyRandom>
+    void bench_rng(benchmark::BenchRunner & runner, std::string const & name, std::uint64_t count)
+    {
+        MyRandom mr(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE));
+
+        runner.run(name, count, count, "number", [&mr, count] {
+            std::int64_t s = 0;
+            for (auto i = 0ULL; i < count; i++) {
+                s += mr.myrand();
+            }
+
+            sink = s;
+        });
+    }
+
+    void bench_statistics(benchmark::BenchRunner & runner, std::uint64_t trials)
+    {
+        auto const [linedata, celldata] = make_synthetic(trials);
+
+        runner.run("eval_average/line", trials, trials, "trial", [&linedata = linedata] {
+            sink = static_cast<std::int64_t>(statistics::eval_average(linedata, montecarlo::ROWCOLUMN).first[0]);
+        });
+
+        runner.run("eval_average/cell", trials, trials, "trial", [&celldata = celldata] {
+            sink = static_cast<std::int64_t>(statistics::eval_average(celldata, montecarlo::BOARDSIZE).first[0]);
+        });
+
+        runner.run("eval_median", trials, trials, "trial", [&linedata = linedata] {
+            sink = statistics::eval_median(linedata, 0);
+        });
+
+        runner.run("eval_mode", trials, trials, "trial", [&linedata = linedata] {
+            sink = statistics::eval_mode(linedata, 0).first;
+        });
+
+        runner.run("eval_std_deviation", trials, trials, "trial", [&linedata = linedata] {
+            sink = static_cast<std::int64_t>(statistics::eval_std_deviation(24.0, linedata, 0));
+        });
+
+        // 全ての行・列（マス）の平均、中央値、最頻値、標準偏差を、ヒストグラムから求める
+        runner.run("eval_histograms/line", trials, trials, "trial", [&linedata = linedata] {
+            auto const [hists, fillavg] = statistics::eval_histograms(linedata, montecarlo::ROWCOLUMN);
+
+            auto s = static_cast<std::int64_t>(fillavg[0]);
+            for (auto const & h : hists) {
+                s += static_cast<std::int64_t>(h.mean() + h.std_deviation()) + h.median() + h.mode();
+            }
+
+            sink = s;
+        });
+
+        runner.run("eval_histograms/cell", trials, trials, "trial", [&celldata = celldata] {
+            auto const [hists, fillavg] = statistics::eval_histograms(celldata, montecarlo::BOARDSIZE);
+
+            auto s = static_cast<std::int64_t>(fillavg[0]);
+            for (auto const & h : hists) {
+                s += static_cast<std::int64_t>(h.mean() + h.std_deviation()) + h.median() + h.mode();
+            }
+
+            sink = s;
+        });
+    }
+
+    std::pair<statistics::mcresult_t, statistics::mcresult_t> make_synthetic(std::uint64_t trials)
+    {
+        std::pair<statistics::mcresult_t, statistics::mcresult_t> data;
+        data.first.reserve(trials);
+        data.second.reserve(trials);
+
+        // 実行するたびに同じデータになるように、シードは固定する
+        std::mt19937_64 engine(1);
+        std::uniform_int_distribution<std::int32_t> step(1, 4);
+
+        for (auto i = 0ULL; i < trials; i++) {
+            std::vector<montecarlo::mypair2> lines, cells;
+            lines.reserve(montecarlo::ROWCOLUMN);
+            cells.reserve(montecarlo::BOARDSIZE);
+
+            auto n = 0;
+            for (auto j = 0U; j < montecarlo::BOARDSIZE; j++) {
+                n += step(engine);
+                cells.emplace_back(n, static_cast<std::int32_t>(j * montecarlo::ROWCOLUMN / montecarlo::BOARDSIZE));
+
+                if (j >= montecarlo::BOARDSIZE - montecarlo::ROWCOLUMN) {
+                    lines.emplace_back(n, static_cast<std::int32_t>(j + 1));
+                }
+            }
+
+            data.first.push_back(std::move(lines));
+            data.second.push_back(std::move(cells));
+        }
+
+        return data;
+    }
+}
@@ -0,0 +1,150 @@
+﻿/*! \file benchrunner.cpp
+    \brief マイクロベンチマークを実行して、結果を集計するクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchrunner.h"
+#include <algorithm>            // for std::max_element, std::min_element, std::nth_element
+#include <cmath>                // for std::fabs
+#include <cstring>              // for std::memcpy
+#include <utility>              // for std::move
+#include <boost/format.hpp>     // for boost::format
+
+#ifdef _WIN32
+    #include <Windows.h>        // for GetCurrentThread, SetThreadAffinityMask
+#elif defined(__linux__)
+    #include <pthread.h>        // for pthread_getaffinity_np, pthread_self, pthread_setaffinity_np
+    #include <sched.h>          // for cpu_set_t, CPU_SET, CPU_ZERO
+#endif
+
+namespace benchmark {
+    // #region コンストラクタ・デストラクタ
+
+    BenchRunner::BenchRunner(std::int32_t warmup, std::int32_t repetitions)
+        : repetitions_(repetitions > 0 ? repetitions : 1), warmup_(warmup > 0 ? warmup : 0)
+    {
+    }
+
+    ScopedThreadPin::ScopedThreadPin(std::int32_t cpu)
+        : oldmask_(), pinned_(false)
+    {
+        if (cpu < 0) {
+            return;
+        }
+
+#ifdef _WIN32
+        if (cpu < 64) {
+            if (auto const old = ::SetThreadAffinityMask(::GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu)) {
+                oldmask_[0] = static_cast<std::uint64_t>(old);
+                pinned_ = true;
+            }
+        }
+#elif defined(__linux__)
+        static_assert(sizeof(cpu_set_t) <= sizeof(oldmask_), "cpu_set_t is too large");
+
+        cpu_set_t old;
+        if (::pthread_getaffinity_np(::pthread_self(), sizeof(old), &old)) {
+            return;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (!::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set)) {
+            std::memcpy(oldmask_.data(), &old, sizeof(old));
+            pinned_ = true;
+        }
+#endif
+    }
+
+    ScopedThreadPin::~ScopedThreadPin()
+    {
+        if (!pinned_) {
+            return;
+        }
+
+#ifdef _WIN32
+        ::SetThreadAffinityMask(::GetCurrentThread(), static_cast<DWORD_PTR>(oldmask_[0]));
+#elif defined(__linux__)
+        cpu_set_t old;
+        std::memcpy(&old, oldmask_.data(), sizeof(old));
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(old), &old);
+#endif
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void BenchRunner::print_table(std::ostream & os) const
+    {
+        // 名称は機械で読むことも考えて英数字にしてあるので、見出しも揃える
+        os << boost::format("%-32s %12s %-8s %6s %14s %12s %14s\n")
+              % "name" % "size" % "unit" % "reps" % "median(ns)" % "MAD(ns)" % "min(ns)";
+
+        for (auto const & r : results_) {
+            os << boost::format("%-32s %12d %-8s %6d %14.3f %12.3f %14.3f\n")
+                  % r.name % r.size % r.unit % r.samples.size() % r.median % r.mad % r.min;
+        }
+    }
+
+    void BenchRunner::print_csv(std::ostream & os) const
+    {
+        os << "name,size,unit,repetitions,median_ns,mad_ns,min_ns\n";
+
+        for (auto const & r : results_) {
+            os << boost::format("%s,%d,%s,%d,%.3f,%.3f,%.3f\n")
+                  % r.name % r.size % r.unit % r.samples.size() % r.median % r.mad % r.min;
+        }
+    }
+
+    BenchResult const & BenchRunner::record(std::string const & name, std::uint64_t size, std::string const & unit, std::vector<double> && samples)
+    {
+        auto const med = median(samples);
+        auto const m = mad(samples, med);
+        auto const mn = samples.empty() ? 0.0 : *std::min_element(samples.begin(), samples.end());
+
+        results_.push_back({ name, size, unit, std::move(samples), med, m, mn });
+
+        return results_.back();
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    double mad(std::vector<double> const & samples, double med)
+    {
+        std::vector<double> dev;
+        dev.reserve(samples.size());
+
+        for (auto s : samples) {
+            dev.push_back(std::fabs(s - med));
+        }
+
+        return median(std::move(dev));
+    }
+
+    double median(std::vector<double> samples)
+    {
+        if (samples.empty()) {
+            return 0.0;
+        }
+
+        auto const n = samples.size();
+        auto const mid = samples.begin() + n / 2;
+        std::nth_element(samples.begin(), mid, samples.end());
+
+        if (n % 2) {
+            return *mid;
+        }
+
+        // 要素が偶数個なら、中央二つの平均
+        auto const lower = *std::max_element(samples.begin(), mid);
+        return (lower + *mid) / 2.0;
+    }
+
+    // #endregion 非メンバ関数
+}
@@ -0,0 +1,322 @@
+﻿/*! \file benchrunner.h
+    \brief マイクロベンチマークを実行して、結果を集計するクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BENCHRUNNER_H_
+#define _BENCHRUNNER_H_
+
+#pragma once
+
+#include "../checkpoint/tscclock.h"
+#include <array>                // for std::array
+#include <cstdint>              // for std::int32_t, std::uint64_t
+#include <ostream>              // for std::ostream
+#include <string>               // for std::string
+#include <utility>              // for std::move
+#include <vector>               // for std::vector
+
+namespace benchmark {
+    //! A structure.
+    /*!
+        一つのベンチマークの結果を格納する構造体
+    */
+    struct BenchResult {
+        //! A public member variable.
+        /*!
+            ベンチマークの名称
+        */
+        std::string name;
+
+        //! A public member variable.
+        /*!
+            問題の大きさ（試行回数など）
+        */
+        std::uint64_t size;
+
+        //! A public member variable.
+        /*!
+            一回あたりの時間の単位の名称（"trial"、"number"など）
+        */
+        std::string unit;
+
+        //! A public member variable.
+        /*!
+            繰り返しごとの、単位あたりの時間(nsec)
+        */
+        std::vector<double> samples;
+
+        //! A public member variable.
+        /*!
+            samplesの中央値(nsec)
+        */
+        double median;
+
+        //! A public member variable.
+        /*!
+            samplesの中央値からの絶対偏差の中央値(nsec)
+        */
+        double mad;
+
+        //! A public member variable.
+        /*!
+            samplesの最小値(nsec)
+        */
+        double min;
+    };
+
+    //! A class.
+    /*!
+        ウォームアップの後に同じ処理を繰り返し計測し、中央値と中央絶対偏差を求めるクラス
+    */
+    class BenchRunner final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param warmup 計測の前に捨てる実行の回数
+            \param repetitions 計測する回数
+        */
+        BenchRunner(std::int32_t warmup, std::int32_t repetitions);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~BenchRunner() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            計測した結果を表にして出力する
+            \param os 出力先のストリーム
+        */
+        void print_table(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            計測した結果をcsv形式で出力する
+            \param os 出力先のストリーム
+        */
+        void print_csv(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            計測した結果を返す
+            \return 計測した結果の可変長配列
+        */
+        std::vector<BenchResult> const & results() const
+        {
+            return results_;
+        }
+
+        //! A public member function.
+        /*!
+            funcをウォームアップの後に繰り返し呼んで、一回の呼び出しの時間をitemsで割ったものを記録する
+            \param name ベンチマークの名称
+            \param size 問題の大きさ
+            \param items 一回の呼び出しで処理する単位の数
+            \param unit 単位の名称
+            \param func 計測する関数オブジェクト
+            \return 計測した結果
+        */
+        template <typename Function>
+        BenchResult const & run(std::string const & name, std::uint64_t size, std::uint64_t items, std::string const & unit, Function func);
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            計測した時間から結果を求めて記録する
+            \param name ベンチマークの名称
+            \param size 問題の大きさ
+            \param unit 単位の名称
+            \param samples 単位あたりの時間(nsec)の可変長配列
+            \return 記録した結果
+        */
+        BenchResult const & record(std::string const & name, std::uint64_t size, std::string const & unit, std::vector<double> && samples);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            計測する回数
+        */
+        std::int32_t const repetitions_;
+
+        //! A private member variable.
+        /*!
+            計測した結果の可変長配列
+        */
+        std::vector<BenchResult> results_;
+
+        //! A private member variable (constant).
+        /*!
+            計測の前に捨てる実行の回数
+        */
+        std::int32_t const warmup_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        BenchRunner() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        BenchRunner(BenchRunner const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        BenchRunner & operator=(BenchRunner const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class.
+    /*!
+        生存している間だけ、生成したスレッドを一つの論理CPUに固定するクラス
+        固定したまま作ったスレッドは固定を引き継ぐので、TBBのワーカーが作られる前に破棄すること
+    */
+    class ScopedThreadPin final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param cpu 論理CPUの番号（負なら固定しない）
+        */
+        explicit ScopedThreadPin(std::int32_t cpu);
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            固定する前の状態に戻す
+        */
+        ~ScopedThreadPin();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            固定できたかどうかを返す
+            \return 固定できたかどうか
+        */
+        bool pinned() const
+        {
+            return pinned_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            固定する前の、論理CPUの集合のビットマスク（1024個目の論理CPUまで）
+        */
+        std::array<std::uint64_t, 16> oldmask_;
+
+        //! A private member variable.
+        /*!
+            固定できたかどうか
+        */
+        bool pinned_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ScopedThreadPin() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ScopedThreadPin(ScopedThreadPin const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ScopedThreadPin & operator=(ScopedThreadPin const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        中央値からの絶対偏差の中央値を求める
+        \param samples 標本の可変長配列
+        \param med 標本の中央値
+        \return 中央絶対偏差
+    */
+    double mad(std::vector<double> const & samples, double med);
+
+    //! A function.
+    /*!
+        中央値を求める
+        \param samples 標本の可変長配列
+        \return 中央値（標本が空なら0）
+    */
+    double median(std::vector<double> samples);
+
+    // #endregion 非メンバ関数
+
+    template <typename Function>
+    BenchResult const & BenchRunner::run(std::string const & name, std::uint64_t size, std::uint64_t items, std::string const & unit, Function func)
+    {
+        for (auto i = 0; i < warmup_; i++) {
+            func();
+        }
+
+        std::vector<double> samples;
+        samples.reserve(repetitions_);
+
+        for (auto i = 0; i < repetitions_; i++) {
+            auto const start = checkpoint::TscClock::now();
+            func();
+            auto const end = checkpoint::TscClock::now_serialized();
+
+            samples.push_back(static_cast<double>((end - start).count()) / static_cast<double>(items));
+        }
+
+        return record(name, size, unit, std::move(samples));
+    }
+}
+
+#endif  // _BENCHRUNNER_H_
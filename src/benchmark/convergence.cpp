@@ -0,0 +1,166 @@
+﻿/*! \file convergence.cpp
+    \brief 幾何分布のカーネルで、単純なモンテカルロ法と乱択準モンテカルロ法の精度を同じ経過時間で比べるクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "convergence.h"
+#include "../checkpoint/tscclock.h"
+#include "../mabinogi_roulette_MC/montecarlo/geometric.h"
+#include "../mabinogi_roulette_MC/montecarlo/trialblock.h"
+#include "../mabinogi_roulette_MC/myrandom/myrandsobol.h"
+#include "../mabinogi_roulette_MC/statistics/batchmeans.h"
+#include "../mabinogi_roulette_MC/statistics/levelaccumulator.h"
+#include <algorithm>                    // for std::max
+#include <chrono>                       // for std::chrono::duration
+#include <iostream>                     // for std::cerr
+#include <optional>                     // for std::make_optional
+#include <utility>                      // for std::make_pair, std::pair
+#include <boost/format.hpp>             // for boost::format
+#include <tbb/enumerable_thread_specific.h> // for tbb::enumerable_thread_specific
+#include <tbb/parallel_for.h>           // for tbb::parallel_for
+
+namespace benchmark {
+    namespace {
+        //! A function.
+        /*!
+            可変長配列の最大値を求める
+            \param v 可変長配列
+            \return 最大値
+        */
+        double max_element(std::vector<double> const & v);
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    ConvergenceRunner::ConvergenceRunner(std::uint64_t replicates, std::uint64_t seed)
+        : replicates_(std::max(replicates, static_cast<std::uint64_t>(2))), seed_(seed)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void ConvergenceRunner::measure(std::uint64_t points)
+    {
+        auto const mc = run(false, points);
+        auto rqmc = run(true, points);
+
+        // 効率1 / (標準誤差^2 × 経過時間)の比（同じ経過時間での分散の比）
+        auto const gain = [](double se, double time, double basese, double basetime) {
+            return se > 0.0 && time > 0.0 ? (basese * basese * basetime) / (se * se * time) : 0.0;
+        };
+
+        rqmc.linegain = gain(rqmc.linese, rqmc.time, mc.linese, mc.time);
+        rqmc.cellgain = gain(rqmc.cellse, rqmc.time, mc.cellse, mc.time);
+
+        results_.push_back(mc);
+        results_.push_back(rqmc);
+    }
+
+    void ConvergenceRunner::print_csv(std::ostream & os) const
+    {
+        os << "method,points,replicates,time_ms,line_se,cell_se,line_gain,cell_gain\n";
+
+        for (auto const & r : results_) {
+            os << boost::format("%s,%d,%d,%.3f,%.6e,%.6e,%.3f,%.3f\n")
+                  % r.method % r.points % r.replicates % r.time % r.linese % r.cellse % r.linegain % r.cellgain;
+        }
+    }
+
+    void ConvergenceRunner::print_table(std::ostream & os) const
+    {
+        os << boost::format("%-6s %10s %10s %12s %12s %12s %10s %10s\n")
+              % "method" % "points" % "replicates" % "time(ms)" % "line SE" % "cell SE" % "line gain" % "cell gain";
+
+        for (auto const & r : results_) {
+            os << boost::format("%-6s %10d %10d %12.3f %12.4e %12.4e %10.2f %10.2f\n")
+                  % r.method % r.points % r.replicates % r.time % r.linese % r.cellse % r.linegain % r.cellgain;
+        }
+    }
+
+    ConvergenceResult ConvergenceRunner::run(bool rqmc, std::uint64_t points) const
+    {
+        std::cerr << boost::format("計測中: %s, 複製ごとに%d点, %d個の複製\n") % (rqmc ? "RQMC" : "MC") % points % replicates_;
+
+        ConvergenceResult r = { rqmc ? "RQMC" : "MC", points, replicates_, 0.0, 0.0, 0.0, 1.0, 1.0 };
+        std::pair<statistics::BatchMeans, statistics::BatchMeans> batches(montecarlo::ROWCOLUMN, montecarlo::BOARDSIZE);
+
+        auto const start = checkpoint::TscClock::now();
+        for (auto rep = static_cast<std::uint64_t>(0); rep < replicates_; rep++) {
+            auto const exemplar = std::make_pair(
+                statistics::LevelAccumulator(montecarlo::ROWCOLUMN),
+                statistics::LevelAccumulator(montecarlo::BOARDSIZE));
+            tbb::enumerable_thread_specific< std::pair<statistics::LevelAccumulator, statistics::LevelAccumulator> > accumulators(exemplar);
+
+            // 一様乱数の組から一回の試行を行い、このスレッドの集計結果に加える
+            auto const trial = [&accumulators](montecarlo::uniforms_t const & u) {
+                auto const res = montecarlo::montecarloGeometric(u);
+
+                auto & acc = accumulators.local();
+                acc.first.add(res.first);
+                acc.second.add(res.second);
+            };
+
+            if (rqmc) {
+                myrandom::MyRandSobol<montecarlo::GEOMETRICDIM> const sobol(seed_, rep);
+                tbb::parallel_for(
+                    static_cast<std::uint64_t>(0),
+                    points,
+                    [&sobol, &trial](auto i) {
+                    montecarlo::uniforms_t u;
+                    sobol.point(static_cast<std::uint32_t>(i), u);
+                    trial(u);
+                });
+            }
+            else {
+                // シミュレーション本体と同じく、SEEDBLOCK個の試行のブロックごとに乱数を初期化する
+                // 複製ごとの試行の番号は、ブロックの境界から始める
+                auto const begin = rep * ((points + montecarlo::SEEDBLOCK - 1) / montecarlo::SEEDBLOCK * montecarlo::SEEDBLOCK);
+                montecarlo::for_each_trial(
+                    begin,
+                    begin + points,
+                    static_cast<std::uint64_t>(1),
+                    std::make_optional(seed_),
+                    true,
+                    [&trial](std::uint64_t, montecarlo::blockrand_t * mr) {
+                    montecarlo::uniforms_t u;
+                    montecarlo::fill_uniforms(*mr, u);
+                    trial(u);
+                });
+            }
+
+            auto mcresult = exemplar;
+            for (auto const & acc : accumulators) {
+                mcresult.first.merge(acc.first);
+                mcresult.second.merge(acc.second);
+            }
+
+            batches.first.add(mcresult.first);
+            batches.second.add(mcresult.second);
+        }
+        auto const end = checkpoint::TscClock::now_serialized();
+
+        r.time = std::chrono::duration<double, std::milli>(end - start).count();
+        r.linese = max_element(batches.first.mean_se());
+        r.cellse = max_element(batches.second.mean_se());
+
+        return r;
+    }
+
+    // #endregion メンバ関数
+
+    namespace {
+        double max_element(std::vector<double> const & v)
+        {
+            auto m = 0.0;
+            for (auto const x : v) {
+                m = std::max(m, x);
+            }
+
+            return m;
+        }
+    }
+}
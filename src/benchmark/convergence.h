@@ -0,0 +1,187 @@
+﻿/*! \file convergence.h
+    \brief 幾何分布のカーネルで、単純なモンテカルロ法と乱択準モンテカルロ法の精度を同じ経過時間で比べるクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CONVERGENCE_H_
+#define _CONVERGENCE_H_
+
+#pragma once
+
+#include <cstdint>              // for std::uint64_t
+#include <ostream>              // for std::ostream
+#include <string>               // for std::string
+#include <vector>               // for std::vector
+
+namespace benchmark {
+    //! A structure.
+    /*!
+        一つの構成（方法と複製ごとの点の数）の計測結果を格納する構造体
+    */
+    struct ConvergenceResult {
+        //! A public member variable.
+        /*!
+            方法（"MC"または"RQMC"）
+        */
+        std::string method;
+
+        //! A public member variable.
+        /*!
+            一つの複製の点（試行）の数
+        */
+        std::uint64_t points;
+
+        //! A public member variable.
+        /*!
+            複製の数
+        */
+        std::uint64_t replicates;
+
+        //! A public member variable.
+        /*!
+            全ての複製の経過時間(msec)
+        */
+        double time;
+
+        //! A public member variable.
+        /*!
+            行・列の平均試行回数の標準誤差の最大値(回)
+        */
+        double linese;
+
+        //! A public member variable.
+        /*!
+            マスの平均試行回数の標準誤差の最大値(回)
+        */
+        double cellse;
+
+        //! A public member variable.
+        /*!
+            同じ点の数のMCに対する、行・列の効率（1 / (標準誤差^2 × 経過時間)）の比
+            同じ経過時間で比べた分散の比になる
+        */
+        double linegain;
+
+        //! A public member variable.
+        /*!
+            同じ点の数のMCに対する、マスの効率（1 / (標準誤差^2 × 経過時間)）の比
+        */
+        double cellgain;
+    };
+
+    //! A class.
+    /*!
+        幾何分布のカーネルの一様乱数の組を、試行のブロックごとに初期化した自作乱数クラス（シミュレーション本体と同じ）で作る単純なモンテカルロ法と、
+        複製ごとにスクランブルしたSobol列で作る乱択準モンテカルロ法を、同じ点の数で実行し、
+        独立な複製の間のばらつきから求めた標準誤差と経過時間から、同じ経過時間での精度を比べるクラス
+    */
+    class ConvergenceRunner final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param replicates 複製の数（2以上）
+            \param seed 乱数のシード
+        */
+        ConvergenceRunner(std::uint64_t replicates, std::uint64_t seed);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ConvergenceRunner() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            一つの複製の点の数を指定して、単純なモンテカルロ法と乱択準モンテカルロ法を計測する
+            \param points 一つの複製の点の数
+        */
+        void measure(std::uint64_t points);
+
+        //! A public member function.
+        /*!
+            計測した結果をcsv形式で出力する
+            \param os 出力先のストリーム
+        */
+        void print_csv(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            計測した結果を表にして出力する
+            \param os 出力先のストリーム
+        */
+        void print_table(std::ostream & os) const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            一つの方法を計測する
+            \param rqmc 乱択準モンテカルロ法ならtrue
+            \param points 一つの複製の点の数
+            \return 計測結果（linegainとcellgainは未設定）
+        */
+        ConvergenceResult run(bool rqmc, std::uint64_t points) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            複製の数
+        */
+        std::uint64_t const replicates_;
+
+        //! A private member variable.
+        /*!
+            計測した結果の可変長配列
+        */
+        std::vector<ConvergenceResult> results_;
+
+        //! A private member variable (constant).
+        /*!
+            乱数のシード
+        */
+        std::uint64_t const seed_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ConvergenceRunner() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ConvergenceRunner(ConvergenceRunner const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ConvergenceRunner & operator=(ConvergenceRunner const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _CONVERGENCE_H_
@@ -0,0 +1,183 @@
+﻿/*! \file scaling.cpp
+    \brief スレッド数を変えてシミュレーションを実行し、スケーリングを測るクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "scaling.h"
+#include "benchrunner.h"
+#include "../checkpoint/checkpoint.h"
+#include "../checkpoint/trialtrace.h"
+#include "../mabinogi_roulette_MC/montecarlo/montecarlo.h"
+#include "../mabinogi_roulette_MC/montecarlo/trialblock.h"
+#include "../mabinogi_roulette_MC/statistics/levelaccumulator.h"
+#include <algorithm>                    // for std::max
+#include <chrono>                       // for std::chrono::duration
+#include <iostream>                     // for std::cerr
+#include <optional>                     // for std::nullopt
+#include <utility>                      // for std::make_pair, std::pair
+#include <boost/format.hpp>             // for boost::format
+#include <tbb/enumerable_thread_specific.h> // for tbb::enumerable_thread_specific
+#include <tbb/global_control.h>         // for tbb::global_control
+
+#ifdef __GLIBC__
+    #include <malloc.h>                 // for malloc_trim
+#endif
+
+namespace benchmark {
+    namespace {
+        //! A function.
+        /*!
+            計測のための道具を外した、シミュレーション本体と同じ並列化したモンテカルロ・シミュレーション
+            本体と同じmontecarlo::for_each_trialで、SEEDBLOCK個の試行のブロックごとに乱数を初期化する
+            \param trials 試行回数
+            \return 行・列とマスの、(n + 1)個目ごとの集計結果
+        */
+        std::pair<statistics::LevelAccumulator, statistics::LevelAccumulator> simulate(std::uint64_t trials);
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    ScalingRunner::ScalingRunner(std::int32_t repetitions, std::vector<std::int32_t> const & threads)
+        : repetitions_(repetitions > 0 ? repetitions : 1), threads_(threads)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void ScalingRunner::print_csv(std::ostream & os) const
+    {
+        os << "mode,threads,trials,repetitions,median_ms,mad_ms,speedup,efficiency,rss_kB\n";
+
+        for (auto const & r : results_) {
+            os << boost::format("%s,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%d\n")
+                  % r.mode % r.threads % r.trials % r.samples.size() % r.median % r.mad % r.speedup % r.efficiency % r.rss;
+        }
+    }
+
+    void ScalingRunner::print_table(std::ostream & os) const
+    {
+        os << boost::format("%-6s %7s %12s %6s %12s %10s %8s %10s %10s\n")
+              % "mode" % "threads" % "trials" % "reps" % "median(ms)" % "MAD(ms)" % "speedup" % "efficiency" % "RSS(kB)";
+
+        for (auto const & r : results_) {
+            os << boost::format("%-6s %7d %12d %6d %12.3f %10.3f %8.2f %9.1f%% %10d\n")
+                  % r.mode % r.threads % r.trials % r.samples.size() % r.median % r.mad % r.speedup % (100.0 * r.efficiency) % r.rss;
+        }
+    }
+
+    void ScalingRunner::strong(std::uint64_t trials)
+    {
+        auto base = 0.0;
+        for (auto const threads : threads_) {
+            auto r = measure("strong", threads, trials);
+            if (threads == threads_.front()) {
+                base = r.median * static_cast<double>(threads);
+            }
+
+            r.speedup = r.median > 0.0 ? base / r.median : 0.0;
+            r.efficiency = r.speedup / static_cast<double>(threads);
+            results_.push_back(std::move(r));
+        }
+    }
+
+    void ScalingRunner::weak(std::uint64_t trialsperthread)
+    {
+        auto base = 0.0;
+        for (auto const threads : threads_) {
+            auto r = measure("weak", threads, trialsperthread * static_cast<std::uint64_t>(threads));
+            if (threads == threads_.front()) {
+                base = r.median;
+            }
+
+            // 仕事の量がスレッド数に比例するので、速度向上率にはスレッド数を掛ける
+            r.efficiency = r.median > 0.0 ? base / r.median : 0.0;
+            r.speedup = r.efficiency * static_cast<double>(threads);
+            results_.push_back(std::move(r));
+        }
+    }
+
+    ScalingResult ScalingRunner::measure(std::string const & mode, std::int32_t threads, std::uint64_t trials) const
+    {
+        std::cerr << boost::format("計測中: %s, %dスレッド, %d試行\n") % mode % threads % trials;
+
+        // この構成の間だけ、TBBのスレッド数を制限する
+        tbb::global_control const gc(tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(threads));
+
+        ScalingResult r = { mode, threads, trials, {}, 0.0, 0.0, 0.0, 0.0, 0 };
+
+        for (auto i = 0; i < repetitions_; i++) {
+#ifdef __GLIBC__
+            // 前の構成で解放したメモリをOSに返しておき、この構成で増えた分だけを測る
+            ::malloc_trim(0);
+#endif
+            auto const before = checkpoint::currentmem();
+
+            auto const start = checkpoint::TscClock::now();
+            auto const res = simulate(trials);
+            auto const end = checkpoint::TscClock::now_serialized();
+
+            r.samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            r.rss = std::max(r.rss, checkpoint::currentmem() - before);
+        }
+
+        r.median = median(r.samples);
+        r.mad = mad(r.samples, r.median);
+
+        return r;
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    std::vector<std::int32_t> thread_counts(std::int32_t maxthreads)
+    {
+        std::vector<std::int32_t> threads;
+        for (auto n = 1; n < maxthreads; n *= 2) {
+            threads.push_back(n);
+        }
+
+        threads.push_back(maxthreads > 0 ? maxthreads : 1);
+
+        return threads;
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        std::pair<statistics::LevelAccumulator, statistics::LevelAccumulator> simulate(std::uint64_t trials)
+        {
+            auto const exemplar = std::make_pair(
+                statistics::LevelAccumulator(montecarlo::ROWCOLUMN),
+                statistics::LevelAccumulator(montecarlo::BOARDSIZE));
+            tbb::enumerable_thread_specific< std::pair<statistics::LevelAccumulator, statistics::LevelAccumulator> > accumulators(exemplar);
+
+            montecarlo::for_each_trial(
+                static_cast<std::uint64_t>(0),
+                trials,
+                static_cast<std::uint64_t>(1),
+                std::nullopt,
+                true,
+                [&accumulators](std::uint64_t, montecarlo::blockrand_t * mr) {
+                checkpoint::TrialTrace<false> trace;
+                auto const res = montecarlo::montecarloImpl(*mr, trace);
+
+                auto & acc = accumulators.local();
+                acc.first.add(res.first);
+                acc.second.add(res.second);
+            });
+
+            auto mcresult = exemplar;
+            for (auto const & acc : accumulators) {
+                mcresult.first.merge(acc.first);
+                mcresult.second.merge(acc.second);
+            }
+
+            return mcresult;
+        }
+    }
+}
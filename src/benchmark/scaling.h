@@ -0,0 +1,222 @@
+﻿/*! \file scaling.h
+    \brief スレッド数を変えてシミュレーションを実行し、スケーリングを測るクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _SCALING_H_
+#define _SCALING_H_
+
+#pragma once
+
+#include <cstdint>              // for std::int32_t, std::int64_t, std::uint64_t
+#include <ostream>              // for std::ostream
+#include <string>               // for std::string
+#include <vector>               // for std::vector
+
+namespace benchmark {
+    //! A structure.
+    /*!
+        一つの構成（スレッド数と試行回数）の計測結果を格納する構造体
+    */
+    struct ScalingResult {
+        //! A public member variable.
+        /*!
+            スケーリングの種類（"strong"または"weak"）
+        */
+        std::string mode;
+
+        //! A public member variable.
+        /*!
+            スレッド数
+        */
+        std::int32_t threads;
+
+        //! A public member variable.
+        /*!
+            試行回数の合計
+        */
+        std::uint64_t trials;
+
+        //! A public member variable.
+        /*!
+            繰り返しごとの経過時間(msec)
+        */
+        std::vector<double> samples;
+
+        //! A public member variable.
+        /*!
+            経過時間の中央値(msec)
+        */
+        double median;
+
+        //! A public member variable.
+        /*!
+            経過時間の中央絶対偏差(msec)
+        */
+        double mad;
+
+        //! A public member variable.
+        /*!
+            同じ種類・同じ系列の1スレッドの構成に対する速度向上率
+            強スケーリングでは T(1) / T(n)、弱スケーリングでは n * T(1) / T(n)
+        */
+        double speedup;
+
+        //! A public member variable.
+        /*!
+            並列化効率（speedup / スレッド数）
+        */
+        double efficiency;
+
+        //! A public member variable.
+        /*!
+            実行中に増えた常駐セットサイズ(kB)（結果を保持している状態で計測）
+        */
+        std::int64_t rss;
+    };
+
+    //! A class.
+    /*!
+        tbb::global_controlでスレッド数を制限してシミュレーションを実行し、
+        強スケーリングと弱スケーリングを測るクラス
+    */
+    class ScalingRunner final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param repetitions 一つの構成を計測する回数
+            \param threads 計測するスレッド数の可変長配列（先頭は1でなければならない）
+        */
+        ScalingRunner(std::int32_t repetitions, std::vector<std::int32_t> const & threads);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ScalingRunner() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            計測した結果をcsv形式で出力する
+            \param os 出力先のストリーム
+        */
+        void print_csv(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            計測した結果を表にして出力する
+            \param os 出力先のストリーム
+        */
+        void print_table(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            計測した結果を返す
+            \return 計測した結果の可変長配列
+        */
+        std::vector<ScalingResult> const & results() const
+        {
+            return results_;
+        }
+
+        //! A public member function.
+        /*!
+            試行回数の合計を固定して、スレッド数を変えて計測する（強スケーリング）
+            \param trials 試行回数の合計
+        */
+        void strong(std::uint64_t trials);
+
+        //! A public member function.
+        /*!
+            スレッドあたりの試行回数を固定して、スレッド数を変えて計測する（弱スケーリング）
+            \param trialsperthread スレッドあたりの試行回数
+        */
+        void weak(std::uint64_t trialsperthread);
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            一つの構成を計測する
+            \param mode スケーリングの種類
+            \param threads スレッド数
+            \param trials 試行回数の合計
+            \return 計測結果（speedupとefficiencyは未設定）
+        */
+        ScalingResult measure(std::string const & mode, std::int32_t threads, std::uint64_t trials) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            一つの構成を計測する回数
+        */
+        std::int32_t const repetitions_;
+
+        //! A private member variable.
+        /*!
+            計測した結果の可変長配列
+        */
+        std::vector<ScalingResult> results_;
+
+        //! A private member variable (constant).
+        /*!
+            計測するスレッド数の可変長配列
+        */
+        std::vector<std::int32_t> const threads_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ScalingRunner() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ScalingRunner(ScalingRunner const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ScalingRunner & operator=(ScalingRunner const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        1, 2, 4, …と倍にしていき、最後にmaxthreadsを加えたスレッド数の列を返す
+        \param maxthreads 最大のスレッド数
+        \return スレッド数の可変長配列
+    */
+    std::vector<std::int32_t> thread_counts(std::int32_t maxthreads);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _SCALING_H_
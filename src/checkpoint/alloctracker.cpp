@@ -0,0 +1,418 @@
+﻿/*! \file alloctracker.cpp
+    \brief メモリ確保を計測するための関数とクラスの実装
+    _CHECK_ALLOCATIONが定義されているときは、グローバルなoperator newとoperator deleteを置き換える
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "alloctracker.h"
+
+#ifdef _CHECK_ALLOCATION
+    #include <algorithm>            // for std::max, std::min
+    #include <atomic>               // for std::atomic
+    #include <cstddef>              // for std::max_align_t
+    #include <cstdio>               // for std::fputs
+    #include <cstdlib>              // for std::abort, std::free, std::malloc
+    #include <iostream>             // for std::cout
+    #include <new>                  // for std::align_val_t, std::bad_alloc, std::nothrow_t
+    #include <boost/format.hpp>     // for boost::format
+
+    #ifdef _MSC_VER
+        #include <malloc.h>         // for _aligned_free, _aligned_malloc
+    #endif
+
+namespace checkpoint {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            スレッドごとに計測結果を記録する枠の数（これを超えたスレッドは最後の枠を共有する）
+        */
+        static auto constexpr MAXTHREADS = 256;
+
+        //! A structure.
+        /*!
+            一つのスレッドのメモリ確保の計測結果を記録する枠
+            書き込むのはそのスレッドだけだが、他のスレッドから読むためアトミック変数にする
+        */
+        struct AllocationSlot {
+            //! A public member variable.
+            /*!
+                メモリを確保した回数
+            */
+            std::atomic<std::int64_t> count;
+
+            //! A public member variable.
+            /*!
+                確保したメモリの合計(byte)
+            */
+            std::atomic<std::int64_t> bytes;
+
+            //! A public member variable.
+            /*!
+                メモリを解放した回数
+            */
+            std::atomic<std::int64_t> freecount;
+
+            //! A public member variable.
+            /*!
+                解放したメモリの合計(byte)
+            */
+            std::atomic<std::int64_t> freebytes;
+        };
+
+        //! A function.
+        /*!
+            メモリを確保して、確保したことを記録する
+            \param size 確保するメモリの量(byte)
+            \param align アラインメント
+            \return 確保したメモリの先頭アドレス（確保できなかった場合はnullptr）
+        */
+        void * allocate(std::size_t size, std::size_t align) noexcept;
+
+        //! A function.
+        /*!
+            メモリを解放して、解放したことを記録する
+            \param p 解放するメモリの先頭アドレス
+            \param align 確保したときのアラインメント
+        */
+        void deallocate(void * p, std::size_t align) noexcept;
+
+        //! A function.
+        /*!
+            呼び出したスレッドの枠を返す
+            \return 呼び出したスレッドの枠
+        */
+        AllocationSlot & this_thread_slot() noexcept;
+
+        //! A global variable.
+        /*!
+            スレッドごとの枠（静的記憶域なので0で初期化される）
+        */
+        AllocationSlot slots[MAXTHREADS];
+
+        //! A global variable.
+        /*!
+            使われている枠の数
+        */
+        std::atomic<std::int32_t> slotnum(0);
+
+        //! A global variable.
+        /*!
+            違反したときに異常終了するかどうか
+        */
+        std::atomic<bool> strictmode(false);
+
+        //! A global variable.
+        /*!
+            メモリ確保を禁止した区間でメモリを確保した回数
+        */
+        std::atomic<std::int64_t> violations(0);
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドの枠の番号（まだ決まっていなければ-1）
+        */
+        thread_local std::int32_t slotindex = -1;
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドでメモリ確保を禁止している区間の名称（禁止していなければnullptr）
+        */
+        thread_local char const * scopename = nullptr;
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    NoAllocationScope::NoAllocationScope(char const * name)
+        : outer_(scopename)
+    {
+        scopename = name;
+    }
+
+    NoAllocationScope::~NoAllocationScope()
+    {
+        scopename = outer_;
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region 非メンバ関数
+
+    bool allocation_tracking_enabled()
+    {
+        return true;
+    }
+
+    AllocationStatistics allocation_statistics()
+    {
+        AllocationStatistics as = {};
+
+        auto const num = std::min(slotnum.load(), MAXTHREADS);
+        for (auto i = 0; i < num; i++) {
+            as.count += slots[i].count.load(std::memory_order_relaxed);
+            as.bytes += slots[i].bytes.load(std::memory_order_relaxed);
+            as.freecount += slots[i].freecount.load(std::memory_order_relaxed);
+            as.freebytes += slots[i].freebytes.load(std::memory_order_relaxed);
+        }
+
+        return as;
+    }
+
+    std::int64_t no_allocation_violations()
+    {
+        return violations.load();
+    }
+
+    void print_allocation_statistics()
+    {
+        std::cout << "スレッドごとのメモリ確保\n";
+
+        auto const num = std::min(slotnum.load(), MAXTHREADS);
+        for (auto i = 0; i < num; i++) {
+            std::cout << boost::format("  スレッド%d: 確保 = %d回 (%.1f kB), 解放 = %d回 (%.1f kB)\n")
+                         % i
+                         % slots[i].count.load(std::memory_order_relaxed)
+                         % (static_cast<double>(slots[i].bytes.load(std::memory_order_relaxed)) / 1024.0)
+                         % slots[i].freecount.load(std::memory_order_relaxed)
+                         % (static_cast<double>(slots[i].freebytes.load(std::memory_order_relaxed)) / 1024.0);
+        }
+
+        std::cout << boost::format("メモリ確保を禁止した区間でのメモリ確保 = %d回\n") % violations.load();
+    }
+
+    void set_strict_no_allocation(bool strict)
+    {
+        strictmode = strict;
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        void * allocate(std::size_t size, std::size_t align) noexcept
+        {
+            if (scopename) {
+                violations.fetch_add(1, std::memory_order_relaxed);
+
+                if (strictmode.load(std::memory_order_relaxed)) {
+                    // ここでメモリを確保しないように、std::coutではなくstd::fputsを使う
+                    std::fputs("メモリ確保を禁止した区間でメモリを確保しました: ", stderr);
+                    std::fputs(scopename, stderr);
+                    std::fputs("\n", stderr);
+                    std::abort();
+                }
+            }
+
+            // 確保したメモリの量を、ユーザーに渡す領域の直前に記録する
+            auto const header = std::max(align, alignof(std::max_align_t));
+
+#ifdef _MSC_VER
+            auto const raw = static_cast<char *>(::_aligned_malloc(header + size, header));
+#else
+            auto const raw = static_cast<char *>(
+                header > alignof(std::max_align_t) ?
+                std::aligned_alloc(header, (header + size + header - 1) / header * header) :
+                std::malloc(header + size));
+#endif
+            if (!raw) {
+                return nullptr;
+            }
+
+            auto const p = raw + header;
+            reinterpret_cast<std::size_t *>(p)[-1] = size;
+
+            auto & slot = this_thread_slot();
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            slot.bytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+
+            return p;
+        }
+
+        void deallocate(void * p, std::size_t align) noexcept
+        {
+            if (!p) {
+                return;
+            }
+
+            auto const header = std::max(align, alignof(std::max_align_t));
+            auto const size = reinterpret_cast<std::size_t *>(p)[-1];
+
+            auto & slot = this_thread_slot();
+            slot.freecount.fetch_add(1, std::memory_order_relaxed);
+            slot.freebytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+
+#ifdef _MSC_VER
+            ::_aligned_free(static_cast<char *>(p) - header);
+#else
+            std::free(static_cast<char *>(p) - header);
+#endif
+        }
+
+        AllocationSlot & this_thread_slot() noexcept
+        {
+            if (slotindex < 0) {
+                slotindex = std::min(slotnum.fetch_add(1, std::memory_order_relaxed), MAXTHREADS - 1);
+            }
+
+            return slots[slotindex];
+        }
+    }
+}
+
+// #region グローバルなoperator newとoperator deleteの置き換え
+
+void * operator new(std::size_t size)
+{
+    if (auto const p = checkpoint::allocate(size, alignof(std::max_align_t))) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void * operator new(std::size_t size, std::nothrow_t const &) noexcept
+{
+    return checkpoint::allocate(size, alignof(std::max_align_t));
+}
+
+void * operator new[](std::size_t size, std::nothrow_t const &) noexcept
+{
+    return checkpoint::allocate(size, alignof(std::max_align_t));
+}
+
+void * operator new(std::size_t size, std::align_val_t align)
+{
+    if (auto const p = checkpoint::allocate(size, static_cast<std::size_t>(align))) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size, std::align_val_t align)
+{
+    return operator new(size, align);
+}
+
+void * operator new(std::size_t size, std::align_val_t align, std::nothrow_t const &) noexcept
+{
+    return checkpoint::allocate(size, static_cast<std::size_t>(align));
+}
+
+void * operator new[](std::size_t size, std::align_val_t align, std::nothrow_t const &) noexcept
+{
+    return checkpoint::allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void * p) noexcept
+{
+    checkpoint::deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete[](void * p) noexcept
+{
+    checkpoint::deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    checkpoint::deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete[](void * p, std::size_t) noexcept
+{
+    checkpoint::deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void * p, std::nothrow_t const &) noexcept
+{
+    checkpoint::deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete[](void * p, std::nothrow_t const &) noexcept
+{
+    checkpoint::deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void * p, std::align_val_t align) noexcept
+{
+    checkpoint::deallocate(p, static_cast<std::size_t>(align));
+}
+
+void operator delete[](void * p, std::align_val_t align) noexcept
+{
+    checkpoint::deallocate(p, static_cast<std::size_t>(align));
+}
+
+void operator delete(void * p, std::size_t, std::align_val_t align) noexcept
+{
+    checkpoint::deallocate(p, static_cast<std::size_t>(align));
+}
+
+void operator delete[](void * p, std::size_t, std::align_val_t align) noexcept
+{
+    checkpoint::deallocate(p, static_cast<std::size_t>(align));
+}
+
+void operator delete(void * p, std::align_val_t align, std::nothrow_t const &) noexcept
+{
+    checkpoint::deallocate(p, static_cast<std::size_t>(align));
+}
+
+void operator delete[](void * p, std::align_val_t align, std::nothrow_t const &) noexcept
+{
+    checkpoint::deallocate(p, static_cast<std::size_t>(align));
+}
+
+// #endregion グローバルなoperator newとoperator deleteの置き換え
+
+#else
+
+namespace checkpoint {
+    // #region コンストラクタ・デストラクタ
+
+    NoAllocationScope::NoAllocationScope(char const *)
+        : outer_(nullptr)
+    {
+    }
+
+    NoAllocationScope::~NoAllocationScope()
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region 非メンバ関数
+
+    bool allocation_tracking_enabled()
+    {
+        return false;
+    }
+
+    AllocationStatistics allocation_statistics()
+    {
+        return AllocationStatistics{};
+    }
+
+    std::int64_t no_allocation_violations()
+    {
+        return 0;
+    }
+
+    void print_allocation_statistics()
+    {
+    }
+
+    void set_strict_no_allocation(bool)
+    {
+    }
+
+    // #endregion 非メンバ関数
+}
+
+#endif
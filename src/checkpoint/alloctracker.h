@@ -0,0 +1,156 @@
+﻿/*! \file alloctracker.h
+    \brief メモリ確保を計測するための関数とクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ALLOCTRACKER_H_
+#define _ALLOCTRACKER_H_
+
+#pragma once
+
+#include <cstdint>              // for std::int64_t
+
+namespace checkpoint {
+    //! A structure.
+    /*!
+        メモリ確保の計測結果を格納する構造体
+    */
+    struct AllocationStatistics {
+        //! A public member variable.
+        /*!
+            メモリを確保した回数
+        */
+        std::int64_t count;
+
+        //! A public member variable.
+        /*!
+            確保したメモリの合計(byte)
+        */
+        std::int64_t bytes;
+
+        //! A public member variable.
+        /*!
+            メモリを解放した回数
+        */
+        std::int64_t freecount;
+
+        //! A public member variable.
+        /*!
+            解放したメモリの合計(byte)
+        */
+        std::int64_t freebytes;
+
+        //! A public member function.
+        /*!
+            確保されたまま解放されていないメモリの量を返す
+            \return 確保されたまま解放されていないメモリの量(byte)
+        */
+        std::int64_t live() const
+        {
+            return bytes - freebytes;
+        }
+    };
+
+    //! A class.
+    /*!
+        生成されてから破棄されるまでの間、そのスレッドでのメモリ確保を禁止するクラス
+        禁止された区間でメモリを確保すると違反として数え、厳格モードならその場で異常終了する
+        _CHECK_ALLOCATIONが定義されていないときは何もしない
+    */
+    class NoAllocationScope final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param name 区間の名称（違反したときのメッセージに使う）
+        */
+        explicit NoAllocationScope(char const * name);
+
+        //! A destructor.
+        /*!
+            デストラクタ
+        */
+        ~NoAllocationScope();
+
+        // #endregion コンストラクタ・デストラクタ
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            外側の区間の名称
+        */
+        char const * const outer_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        NoAllocationScope() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        NoAllocationScope(NoAllocationScope const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        NoAllocationScope & operator=(NoAllocationScope const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        メモリ確保を計測しているかどうか（_CHECK_ALLOCATIONを定義してビルドしたかどうか）を返す
+        \return メモリ確保を計測しているかどうか
+    */
+    bool allocation_tracking_enabled();
+
+    //! A function.
+    /*!
+        全てのスレッドのメモリ確保の計測結果の合計を返す
+        \return 全てのスレッドのメモリ確保の計測結果の合計
+    */
+    AllocationStatistics allocation_statistics();
+
+    //! A function.
+    /*!
+        メモリ確保を禁止した区間でメモリを確保した回数を返す
+        \return メモリ確保を禁止した区間でメモリを確保した回数
+    */
+    std::int64_t no_allocation_violations();
+
+    //! A function.
+    /*!
+        スレッドごとのメモリ確保の計測結果と、禁止された区間での違反の回数を表示する
+    */
+    void print_allocation_statistics();
+
+    //! A function.
+    /*!
+        メモリ確保を禁止した区間でメモリを確保したときに、その場で異常終了するかどうかを設定する
+        \param strict 異常終了するかどうか
+    */
+    void set_strict_no_allocation(bool strict);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _ALLOCTRACKER_H_
@@ -6,12 +6,15 @@
 */
 
 #include "checkpoint.h"
+#include "chrometrace.h"
+#include <algorithm>            // for std::min
 #include <iostream>             // for std::cout
+#include <new>                  // for placement new
 #include <system_error>         // for std::system_category
+#include <utility>              // for std::move
 #include <boost/assert.hpp>     // for boost::assert
 #include <boost/cast.hpp>       // for boost::numeric_cast
 #include <boost/format.hpp>     // for boost::format
-#include <boost/optional.hpp>   // for boost::optional
 
 #ifdef _WIN32
     #include <Windows.h>        // for GetCurrentProcess
@@ -20,61 +23,243 @@
 	#pragma comment(lib, "Psapi.Lib")
 #else
     #include <errno.h>          // for errno 
+    #include <fstream>          // for std::ifstream
     #include <sys/resource.h>   // for getrusage
+    #include <unistd.h>         // for sysconf
 #endif
 
 namespace checkpoint {
+    namespace {
+        //! A function.
+        /*!
+            二つのチェックポイントの間のCPU時間と、実効並列度を表示する
+            \param prev 直前のチェックポイント
+            \param cur このチェックポイント
+            \param wall 二つのチェックポイントの間の経過時間(msec)
+        */
+        template <typename Timestamp>
+        void print_cputime(Timestamp const & prev, Timestamp const & cur, double wall);
+
+        //! A function.
+        /*!
+            二つのチェックポイントの間のハードウェアパフォーマンスカウンタの増分を表示する
+            \param prev 直前のチェックポイントでのカウンタの値
+            \param cur このチェックポイントでのカウンタの値
+            \param trials 二つのチェックポイントの間に行った試行回数
+        */
+        void print_perf(PerfValues const & prev, PerfValues const & cur, std::int64_t trials);
+
+        //! A function.
+        /*!
+            二つのチェックポイントの間のメモリ確保の回数と量を表示する
+            \param prev 直前のチェックポイントでのメモリ確保の計測結果
+            \param cur このチェックポイントでのメモリ確保の計測結果
+        */
+        void print_alloc(AllocationStatistics const & prev, AllocationStatistics const & cur);
+    }
+
     CheckPoint::CheckPoint()
         : cfp(
-            reinterpret_cast<CheckPoint::CheckPointFastImpl *>(
-                FastArenaObject<sizeof(CheckPoint::CheckPointFastImpl)>::operator new(0)))
+            ::new(FastArenaObject<sizeof(CheckPoint::CheckPointFastImpl)>::operator new(0))
+                CheckPoint::CheckPointFastImpl())
 	{
+        // このスレッドのハードウェアパフォーマンスカウンタを、最初のチェックポイントより前に開いておく
+        this_thread_recorder();
 	}
 
-    void CheckPoint::checkpoint(char const * action, std::int32_t line)
-	{
-		BOOST_ASSERT(cfp->cur < static_cast<std::int32_t>(CheckPoint::CheckPointFastImpl::N));
+    void CheckPoint::add_report(std::function<void()> report)
+    {
+        std::lock_guard<std::mutex> lock(cfp->mtx);
+        cfp->reports.push_back(std::move(report));
+    }
 
-		auto const p = cfp->points.begin() + cfp->cur;
+    void CheckPoint::checkpoint(char const * action, std::int32_t line, std::int64_t trials)
+	{
+        auto const realtime = Clock::now();
+        auto const perf = perf_counters_sum();
+        auto const alloc = allocation_statistics();
+        auto const processcpu = process_cputime();
 
-        p->action = action;
-        p->line = line;
-		p->realtime = std::chrono::high_resolution_clock::now();
+        // 記録クラスを持っている全てのスレッドのCPU時間
+        std::vector<std::int64_t> threadcpu;
+        for (auto const r : thread_recorders()) {
+            threadcpu.push_back(r->cpuclock().now());
+        }
 
-		cfp->cur++;
+        std::lock_guard<std::mutex> lock(cfp->mtx);
+        cfp->points.push_back(Timestamp{ line, action, realtime, perf, trials, alloc, processcpu, std::move(threadcpu) });
 	}
 	
 	void CheckPoint::checkpoint_print() const
 	{
         using namespace std::chrono;
 
-        boost::optional<high_resolution_clock::time_point> prevreal(boost::none);
+        {
+            std::lock_guard<std::mutex> lock(cfp->mtx);
 
-        auto itr = cfp->points.begin();
-		for (auto i = 0; i < cfp->cur; ++i, ++itr) {
-			if (prevreal) {
-				auto const realtime(duration_cast<duration<double, std::milli>>(itr->realtime - *prevreal));
-				std::cout << itr->action
-                          << boost::format(" elapsed time = %.4f (msec)\n") % realtime.count();
-			}
+            // 直前のチェックポイント
+            Timestamp const * prev = nullptr;
 
-            prevreal = boost::optional<high_resolution_clock::time_point>(itr->realtime);
-		}
+            for (auto const & p : cfp->points) {
+                if (prev) {
+                    auto const realtime(duration_cast<duration<double, std::milli>>(p.realtime - prev->realtime));
+                    std::cout << p.action
+                              << boost::format(" elapsed time = %.4f (msec)\n") % realtime.count();
+
+                    print_cputime(*prev, p, realtime.count());
+
+                    print_perf(prev->perf, p.perf, p.trials);
+
+                    if (allocation_tracking_enabled()) {
+                        print_alloc(prev->alloc, p.alloc);
+                    }
+                }
+
+                prev = &p;
+            }
+        }
+
+        print_phase_statistics();
+
+        if (allocation_tracking_enabled()) {
+            print_allocation_statistics();
+        }
+
+        // 登録した関数からこのオブジェクトを使えるように、ロックを外してから呼ぶ
+        std::vector<std::function<void()>> reports;
+        {
+            std::lock_guard<std::mutex> lock(cfp->mtx);
+            reports = cfp->reports;
+        }
+
+        for (auto const & report : reports) {
+            report();
+        }
 	}
 
+    std::vector<TraceMark> CheckPoint::marks() const
+    {
+        std::lock_guard<std::mutex> lock(cfp->mtx);
+
+        std::vector<TraceMark> v;
+        for (auto const & p : cfp->points) {
+            v.push_back(TraceMark{ p.action, p.realtime });
+        }
+
+        return v;
+    }
+
+    void CheckPoint::output_chrome_trace(std::string const & filename) const
+    {
+        write_chrome_trace(marks(), filename);
+    }
+
     void CheckPoint::totalpassageoftime() const
     {
         using namespace std::chrono;
 
+        std::lock_guard<std::mutex> lock(cfp->mtx);
+
+        BOOST_ASSERT(!cfp->points.empty());
+
         auto const realtime = duration_cast<duration<double, std::milli>>(
-            cfp->points[cfp->cur - 1].realtime - cfp->points[0].realtime);
+            cfp->points.back().realtime - cfp->points.front().realtime);
 
         std::cout << boost::format("Total elapsed time = %.4f (msec)") % realtime.count() << std::endl;
     }
 
     // #region 非メンバ関数
 
+    namespace {
+        template <typename Timestamp>
+        void print_cputime(Timestamp const & prev, Timestamp const & cur, double wall)
+        {
+            if (prev.processcpu < 0 || cur.processcpu < 0 || wall <= 0.0) {
+                return;
+            }
+
+            auto const cpu = static_cast<double>(cur.processcpu - prev.processcpu) * 1.0E-6;
+            std::cout << boost::format("    CPU時間 = %.4f (msec), 実効並列度 = %.2f (コア)\n") % cpu % (cpu / wall);
+
+            // 二つのチェックポイントの間に動いたスレッドが複数あれば、スレッドごとのCPU時間も表示する
+            std::vector<std::pair<std::size_t, double>> busy;
+            for (auto i = 0U; i < cur.threadcpu.size(); i++) {
+                auto const before = i < prev.threadcpu.size() ? prev.threadcpu[i] : 0;
+                if (cur.threadcpu[i] >= 0 && before >= 0 && cur.threadcpu[i] > before) {
+                    busy.emplace_back(i, static_cast<double>(cur.threadcpu[i] - before) * 1.0E-6);
+                }
+            }
+
+            if (busy.size() > 1) {
+                std::cout << "    スレッドごとのCPU時間 (msec):";
+                for (auto const & b : busy) {
+                    std::cout << boost::format(" %d = %.1f,") % b.first % b.second;
+                }
+
+                std::cout << '\n';
+            }
+        }
+
+        void print_alloc(AllocationStatistics const & prev, AllocationStatistics const & cur)
+        {
+            std::cout << boost::format("    メモリ確保 = %d回 (%.1f kB), 解放 = %d回 (%.1f kB), 生存量 = %.1f kB\n")
+                         % (cur.count - prev.count)
+                         % (static_cast<double>(cur.bytes - prev.bytes) / 1024.0)
+                         % (cur.freecount - prev.freecount)
+                         % (static_cast<double>(cur.freebytes - prev.freebytes) / 1024.0)
+                         % (static_cast<double>(cur.live()) / 1024.0);
+        }
+
+        void print_perf(PerfValues const & prev, PerfValues const & cur, std::int64_t trials)
+        {
+            if (!cur.any()) {
+                return;
+            }
+
+            // 直前のチェックポイントからの増分（使えないカウンタは負の値にする）
+            std::array<double, PERFEVENTNUM> delta;
+            for (auto i = 0U; i < PERFEVENTNUM; i++) {
+                delta[i] = cur.valid[i] ?
+                    static_cast<double>(cur.value[i] - std::min(prev.value[i], cur.value[i])) :
+                    -1.0;
+            }
+
+            std::cout << "   ";
+            for (auto i = 0U; i < PERFEVENTNUM; i++) {
+                if (delta[i] >= 0.0) {
+                    std::cout << boost::format(" %s = %.4g,") % PERFEVENTNAME[i] % delta[i];
+                }
+            }
+
+            if (delta[0] > 0.0 && delta[1] >= 0.0) {
+                std::cout << boost::format(" IPC = %.3f") % (delta[1] / delta[0]);
+            }
+            std::cout << '\n';
+
+            if (trials > 0) {
+                std::cout << "    1試行あたり:";
+                for (auto i = 0U; i < PERFEVENTNUM; i++) {
+                    if (delta[i] >= 0.0) {
+                        std::cout << boost::format(" %s = %.4g,") % PERFEVENTNAME[i] % (delta[i] / static_cast<double>(trials));
+                    }
+                }
+                std::cout << '\n';
+            }
+        }
+    }
+
 #ifdef _WIN32
+    std::int64_t currentmem()
+    {
+        PROCESS_MEMORY_COUNTERS memInfo = { 0 };
+
+        if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &memInfo, sizeof(memInfo))) {
+            throw std::system_error(std::error_code(::GetLastError(), std::system_category()));
+        }
+
+        return static_cast<std::int64_t>(memInfo.WorkingSetSize >> 10);
+    }
+
     void usedmem()
 	{
 		PROCESS_MEMORY_COUNTERS memInfo = { 0 };
@@ -89,6 +274,25 @@ namespace checkpoint {
                   << std::endl; 
 	}
 #else
+    std::int64_t currentmem()
+    {
+        // 2番目の値が、ページ単位の常駐セットサイズ
+        std::ifstream ifs("/proc/self/statm");
+        std::int64_t size, resident;
+        if (ifs >> size >> resident) {
+            return resident * static_cast<std::int64_t>(::sysconf(_SC_PAGESIZE)) / 1024;
+        }
+
+        // /proc/self/statmがない環境では、ピークの値で代用する
+        struct rusage r;
+
+        if (getrusage(RUSAGE_SELF, &r)) {
+            throw std::system_error(errno, std::system_category());
+        }
+
+        return static_cast<std::int64_t>(r.ru_maxrss);
+    }
+
     void usedmem()
 	{
 	    struct rusage r;
@@ -10,12 +10,18 @@
 
 #pragma once
 
+#include "alloctracker.h"
+#include "chrometrace.h"
 #include "fastarenaobject.h"
-#include <array>				// for std::array			
-#include <chrono>               // for std::chrono               
+#include "perfcounter.h"
+#include "profiler.h"
 #include <cstdint>              // for std::int32_t, std::int64_t
+#include <functional>           // for std::function
 #include <memory>               // for std::unique_ptr
+#include <mutex>                // for std::mutex
+#include <string>               // for std::string
 #include <utility>              // for std::pair
+#include <vector>               // for std::vector
 
 namespace checkpoint {
     //! A class.
@@ -44,9 +50,39 @@ namespace checkpoint {
 
             //! A public member variable.
             /*!
-                チェックポイントの時間
+                チェックポイントの時間（ScopedTimerと同じ時計で計測する）
             */
-            std::chrono::high_resolution_clock::time_point realtime;
+            Clock::time_point realtime;
+
+            //! A public member variable.
+            /*!
+                チェックポイントの時点での、全てのスレッドのハードウェアパフォーマンスカウンタの値の合計
+            */
+            PerfValues perf;
+
+            //! A public member variable.
+            /*!
+                直前のチェックポイントからこのチェックポイントまでに行った試行回数
+            */
+            std::int64_t trials;
+
+            //! A public member variable.
+            /*!
+                チェックポイントの時点での、全てのスレッドのメモリ確保の計測結果の合計
+            */
+            AllocationStatistics alloc;
+
+            //! A public member variable.
+            /*!
+                チェックポイントの時点での、プロセスのCPU時間(nsec)（計測できなければ-1）
+            */
+            std::int64_t processcpu;
+
+            //! A public member variable.
+            /*!
+                チェックポイントの時点での、スレッドの通し番号ごとのCPU時間(nsec)（計測できなければ-1）
+            */
+            std::vector<std::int64_t> threadcpu;
 	    };
                 
         //! A struct.
@@ -60,7 +96,7 @@ namespace checkpoint {
             /*!
                 唯一のコンストラクタ
             */
-            CheckPointFastImpl() : cur(0) {}
+            CheckPointFastImpl() = default;
 
             //! A destructor.
             /*!
@@ -72,23 +108,23 @@ namespace checkpoint {
 
             // #region メンバ変数
 
-            //! A public static member variable (constant).
+            //! A public member variable.
             /*!
-                チェックポイントの数
+                pointsを保護するミューテックス
             */
-            static std::size_t const N = 30;
-
+            mutable std::mutex mtx;
+		
             //! A public member variable.
             /*!
-                現在の場所
+                チェックポイントの情報の可変長配列
             */
-		    std::int32_t cur;
-		
+            std::vector<CheckPoint::Timestamp> points;
+
             //! A public member variable.
             /*!
-                チェックポイントの情報の配列
+                checkpoint_print()の最後に呼ぶ、追加の集計結果を表示する関数の可変長配列
             */
-            std::array<CheckPoint::Timestamp, N> points;
+            std::vector<std::function<void()>> reports;
 
             // #endregion メンバ変数
 	    };
@@ -101,6 +137,7 @@ namespace checkpoint {
         template <typename T>
         struct fastpimpl_deleter {
             void operator()(T * p) const {
+                p->~T();
                 FastArenaObject<sizeof(CheckPointFastImpl)>::
                     operator delete(reinterpret_cast<void *>(p));
             }
@@ -127,20 +164,49 @@ namespace checkpoint {
 
         // #region メンバ関数
 
+        //! A public member function.
+        /*!
+            checkpoint_print()の最後に、追加の集計結果を表示する関数を登録する
+            登録した関数が参照するオブジェクトは、checkpoint_print()を呼ぶまで生存していなければならない
+            \param report 追加の集計結果を表示する関数
+        */
+        void add_report(std::function<void()> report);
+
         //! A public member function.
         /*!
             チェックポイントを設定する
-            \param line 行数
+            複数のスレッドから同時に呼んでもよい
             \param action チェックポイントの名称
+            \param line 行数
+            \param trials 直前のチェックポイントからこのチェックポイントまでに行った試行回数（0なら試行あたりの値を表示しない）
         */
-        void checkpoint(char const * action, std::int32_t line);
+        void checkpoint(char const * action, std::int32_t line, std::int64_t trials = 0);
 
         //! A public member function.
         /*!
             直前のチェックポイントから計測した、経過時間を表示する
+            CPU時間と、それを経過時間で割った実効並列度も表示する
+            ハードウェアパフォーマンスカウンタが使えれば、IPCと試行あたりのミスも表示する
+            メモリ確保を計測していれば、その回数と量も表示する
+            ScopedTimerで計測した区間があれば、その集計結果も表示する
+            add_reportで登録した関数があれば、最後にそれらを登録した順に呼ぶ
         */
         void checkpoint_print() const;
 
+        //! A public member function.
+        /*!
+            これまでに設定したチェックポイントの名称と時刻を返す
+            \return チェックポイントの情報の可変長配列
+        */
+        std::vector<TraceMark> marks() const;
+
+        //! A public member function.
+        /*!
+            チェックポイントと、ScopedTimerで計測した区間をトレースイベント形式のJSONで出力する
+            \param filename 出力するファイル名
+        */
+        void output_chrome_trace(std::string const & filename) const;
+
         //! A public member function.
         /*!
             最初のチェックポイントから最後のチェックポイント
@@ -182,6 +248,13 @@ namespace checkpoint {
 
     // #region 非メンバ関数
 
+    //! A function.
+    /*!
+        自分自身のプロセスの現在のメモリ使用量を求める
+        \return 現在のメモリ使用量(kB)
+    */
+    std::int64_t currentmem();
+
     //! A function.
     /*!
         自分自身のプロセスのメモリ使用量を計測する    
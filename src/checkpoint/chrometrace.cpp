@@ -0,0 +1,165 @@
+﻿/*! \file chrometrace.cpp
+    \brief 計測結果をChromeのトレースイベント形式で出力する関数の実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "chrometrace.h"
+#include <algorithm>            // for std::min
+#include <cstdint>              // for std::uint64_t
+#include <fstream>              // for std::ofstream
+#include <iostream>             // for std::cerr
+#include <system_error>         // for std::system_category
+#include <boost/format.hpp>     // for boost::format
+
+namespace checkpoint {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            チェックポイントのトラックのスレッドID
+        */
+        static auto constexpr MARKTID = 0;
+
+        //! A function.
+        /*!
+            文字列をJSONの文字列としてエスケープする
+            \param str エスケープする文字列
+            \return エスケープされた文字列（前後の引用符を含む）
+        */
+        std::string escape(char const * str);
+
+        //! A function.
+        /*!
+            時刻を、基準の時刻からのマイクロ秒に変換する
+            \param origin 基準の時刻
+            \param t 変換する時刻
+            \return 基準の時刻からのマイクロ秒
+        */
+        double to_usec(Clock::time_point origin, Clock::time_point t);
+    }
+
+    // #region 非メンバ関数
+
+    void write_chrome_trace(std::vector<TraceMark> const & marks, std::string const & filename)
+    {
+        auto const recorders = thread_recorders();
+
+        // 全ての記録の中で最も古い時刻を基準にする
+        auto origin = Clock::time_point::max();
+        if (!marks.empty()) {
+            origin = marks.front().time;
+        }
+
+        for (auto const r : recorders) {
+            r->events().for_each([&origin](auto const & e) { origin = std::min(origin, e.start); });
+            r->counters().for_each([&origin](auto const & c) { origin = std::min(origin, c.time); });
+        }
+
+        // リングバッファがあふれて上書きされた、古い区間とカウンタの数
+        std::uint64_t droppedevents = 0, droppedcounters = 0;
+        std::size_t capacity = 0;
+        for (auto const r : recorders) {
+            droppedevents += r->events().dropped();
+            droppedcounters += r->counters().dropped();
+            capacity = r->events().capacity();
+        }
+
+        std::ofstream ofs(filename);
+        if (!ofs) {
+            throw std::system_error(std::make_error_code(std::errc::io_error), filename);
+        }
+
+        ofs << boost::format("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"ring_capacity\":%d,\"dropped_events\":%d,\"dropped_counters\":%d},\"traceEvents\":[\n")
+               % capacity
+               % droppedevents
+               % droppedcounters;
+
+        // トラックの名前（スレッドのトラックには、上書きされた区間とカウンタの数も付ける）
+        ofs << boost::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"チェックポイント\"}}")
+               % MARKTID;
+        for (auto const r : recorders) {
+            ofs << boost::format(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"スレッド%d\",\"dropped_events\":%d,\"dropped_counters\":%d}}")
+                   % (r->index() + 1)
+                   % r->index()
+                   % r->events().dropped()
+                   % r->counters().dropped();
+        }
+
+        // チェックポイントの間（名称は、その間の終わりのチェックポイントの名称）
+        for (auto i = 1U; i < marks.size(); i++) {
+            ofs << boost::format(",\n{\"name\":%s,\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}")
+                   % escape(marks[i].action)
+                   % MARKTID
+                   % to_usec(origin, marks[i - 1].time)
+                   % to_usec(marks[i - 1].time, marks[i].time);
+        }
+
+        // スレッドごとの区間とカウンタ
+        for (auto const r : recorders) {
+            auto const tid = r->index() + 1;
+
+            r->events().for_each([&ofs, origin, tid](auto const & e) {
+                ofs << boost::format(",\n{\"name\":%s,\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}")
+                       % escape(e.name)
+                       % tid
+                       % to_usec(origin, e.start)
+                       % to_usec(e.start, e.end);
+            });
+
+            r->counters().for_each([&ofs, origin](auto const & c) {
+                ofs << boost::format(",\n{\"name\":%s,\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%.17g}}")
+                       % escape(c.name)
+                       % to_usec(origin, c.time)
+                       % c.value;
+            });
+        }
+
+        ofs << "\n]}\n";
+
+        if (droppedevents || droppedcounters) {
+            std::cerr << boost::format("トレースのリングバッファ（スレッドごとに%d個）があふれ、古い区間%d個とカウンタ%d個が失われました（%sには新しい方だけが残っています）\n")
+                         % capacity
+                         % droppedevents
+                         % droppedcounters
+                         % filename;
+        }
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        std::string escape(char const * str)
+        {
+            std::string s("\"");
+
+            for (; *str; ++str) {
+                switch (*str) {
+                case '"':
+                    s += "\\\"";
+                    break;
+
+                case '\\':
+                    s += "\\\\";
+                    break;
+
+                default:
+                    if (static_cast<unsigned char>(*str) < 0x20) {
+                        s += (boost::format("\\u%04x") % static_cast<int>(*str)).str();
+                    }
+                    else {
+                        s += *str;
+                    }
+                    break;
+                }
+            }
+
+            return s + "\"";
+        }
+
+        double to_usec(Clock::time_point origin, Clock::time_point t)
+        {
+            return std::chrono::duration<double, std::micro>(t - origin).count();
+        }
+    }
+}
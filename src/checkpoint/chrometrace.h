@@ -0,0 +1,53 @@
+﻿/*! \file chrometrace.h
+    \brief 計測結果をChromeのトレースイベント形式で出力する関数の宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CHROMETRACE_H_
+#define _CHROMETRACE_H_
+
+#pragma once
+
+#include "profiler.h"
+#include <string>               // for std::string
+#include <vector>               // for std::vector
+
+namespace checkpoint {
+    //! A structure.
+    /*!
+        トレースに出力するチェックポイントの情報を格納する構造体
+    */
+    struct TraceMark {
+        //! A public member variable.
+        /*!
+            チェックポイントの名称
+        */
+        char const * action;
+
+        //! A public member variable.
+        /*!
+            チェックポイントの時刻
+        */
+        Clock::time_point time;
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        チェックポイントと、全てのスレッドの区間とカウンタをトレースイベント形式のJSONで出力する
+        chrome://tracingやPerfettoで読み込める
+        チェックポイントの間は一つのトラックに、区間はスレッドごとのトラックに、カウンタはカウンタのトラックに並ぶ
+        リングバッファがあふれて上書きされた区間とカウンタの数は、otherDataとスレッドのトラックの名前に書き出し、標準エラー出力にも表示する
+        他のスレッドが記録している最中に呼んではならない
+        \param marks チェックポイントの情報の可変長配列
+        \param filename 出力するファイル名
+    */
+    void write_chrome_trace(std::vector<TraceMark> const & marks, std::string const & filename);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _CHROMETRACE_H_
@@ -0,0 +1,143 @@
+﻿/*! \file cputime.cpp
+    \brief CPU時間を計測するための関数とクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "cputime.h"
+
+#ifdef _WIN32
+    #include <Windows.h>            // for DuplicateHandle, GetProcessTimes, GetThreadTimes
+#else
+    #include <pthread.h>            // for pthread_getcpuclockid, pthread_self
+    #include <time.h>               // for clock_gettime
+#endif
+
+namespace checkpoint {
+    namespace {
+#ifdef _WIN32
+        //! A function.
+        /*!
+            FILETIMEで表された時間をナノ秒に変換する
+            \param ft FILETIMEで表された時間（100nsec単位）
+            \return 時間(nsec)
+        */
+        std::int64_t filetime_to_nsec(FILETIME const & ft);
+#else
+        //! A function.
+        /*!
+            指定された時計の時刻をナノ秒で返す
+            \param clock 時計のID
+            \return 時刻(nsec)（読めなければ-1）
+        */
+        std::int64_t clock_nsec(clockid_t clock);
+#endif
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    ThreadCpuClock::ThreadCpuClock()
+        : handle_(0), valid_(false)
+    {
+#ifdef _WIN32
+        // GetCurrentThreadは疑似ハンドルを返すので、他のスレッドからも使える本物のハンドルを作る
+        HANDLE h;
+        if (::DuplicateHandle(::GetCurrentProcess(), ::GetCurrentThread(), ::GetCurrentProcess(), &h, THREAD_QUERY_LIMITED_INFORMATION, FALSE, 0)) {
+            handle_ = reinterpret_cast<std::uintptr_t>(h);
+            valid_ = true;
+        }
+#else
+        clockid_t clock;
+        if (!::pthread_getcpuclockid(::pthread_self(), &clock)) {
+            handle_ = static_cast<std::uintptr_t>(clock);
+            valid_ = true;
+        }
+#endif
+    }
+
+    ThreadCpuClock::~ThreadCpuClock()
+    {
+#ifdef _WIN32
+        if (valid_) {
+            ::CloseHandle(reinterpret_cast<HANDLE>(handle_));
+        }
+#endif
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    std::int64_t ThreadCpuClock::now() const
+    {
+        if (!valid_) {
+            return -1;
+        }
+
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!::GetThreadTimes(reinterpret_cast<HANDLE>(handle_), &creation, &exit, &kernel, &user)) {
+            return -1;
+        }
+
+        return filetime_to_nsec(kernel) + filetime_to_nsec(user);
+#else
+        // スレッドが終了していれば、clock_gettimeは失敗する
+        return clock_nsec(static_cast<clockid_t>(handle_));
+#endif
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    std::int64_t process_cputime()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!::GetProcessTimes(::GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+            return -1;
+        }
+
+        return filetime_to_nsec(kernel) + filetime_to_nsec(user);
+#else
+        return clock_nsec(CLOCK_PROCESS_CPUTIME_ID);
+#endif
+    }
+
+    std::int64_t thread_cputime()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+            return -1;
+        }
+
+        return filetime_to_nsec(kernel) + filetime_to_nsec(user);
+#else
+        return clock_nsec(CLOCK_THREAD_CPUTIME_ID);
+#endif
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+#ifdef _WIN32
+        std::int64_t filetime_to_nsec(FILETIME const & ft)
+        {
+            return ((static_cast<std::int64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 100;
+        }
+#else
+        std::int64_t clock_nsec(clockid_t clock)
+        {
+            timespec ts;
+            if (::clock_gettime(clock, &ts)) {
+                return -1;
+            }
+
+            return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + static_cast<std::int64_t>(ts.tv_nsec);
+        }
+#endif
+    }
+}
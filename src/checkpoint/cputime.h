@@ -0,0 +1,105 @@
+﻿/*! \file cputime.h
+    \brief CPU時間を計測するための関数とクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CPUTIME_H_
+#define _CPUTIME_H_
+
+#pragma once
+
+#include <cstdint>              // for std::int64_t, std::uintptr_t
+
+namespace checkpoint {
+    //! A class.
+    /*!
+        生成したスレッドのCPU時間を、他のスレッドからも読めるようにするクラス
+    */
+    class ThreadCpuClock final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            呼び出したスレッドのCPU時間を計測の対象にする
+        */
+        ThreadCpuClock();
+
+        //! A destructor.
+        /*!
+            デストラクタ
+        */
+        ~ThreadCpuClock();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            対象のスレッドのCPU時間を返す
+            \return 対象のスレッドのCPU時間(nsec)（計測できなければ-1）
+        */
+        std::int64_t now() const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            対象のスレッドのCPU時間を読むためのハンドル（Linuxではclockid_t、WindowsではHANDLE）
+        */
+        std::uintptr_t handle_;
+
+        //! A private member variable.
+        /*!
+            handle_が有効かどうか
+        */
+        bool valid_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ThreadCpuClock(ThreadCpuClock const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ThreadCpuClock & operator=(ThreadCpuClock const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        自分自身のプロセスの、全てのスレッドのCPU時間の合計を返す
+        \return プロセスのCPU時間(nsec)（計測できなければ-1）
+    */
+    std::int64_t process_cputime();
+
+    //! A function.
+    /*!
+        呼び出したスレッドのCPU時間を返す
+        \return スレッドのCPU時間(nsec)（計測できなければ-1）
+    */
+    std::int64_t thread_cputime();
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _CPUTIME_H_
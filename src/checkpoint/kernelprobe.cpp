@@ -0,0 +1,131 @@
+﻿/*! \file kernelprobe.cpp
+    \brief シミュレーションのカーネルの中を計測するためのクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "kernelprobe.h"
+#include <algorithm>            // for std::min
+#include <iostream>             // for std::cout
+#include <memory>               // for std::unique_ptr
+#include <mutex>                // for std::lock_guard, std::mutex
+#include <boost/format.hpp>     // for boost::format
+
+namespace checkpoint {
+    namespace {
+        //! A function.
+        /*!
+            全てのスレッドの計測結果を返す
+            \return 全てのスレッドの計測結果の可変長配列
+        */
+        std::vector<std::unique_ptr<KernelProbeValues>> & probe_values();
+
+        //! A function.
+        /*!
+            probe_values()を保護するミューテックスを返す
+            \return probe_values()を保護するミューテックス
+        */
+        std::mutex & probe_values_mutex();
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドの計測結果
+        */
+        thread_local KernelProbeValues * current_values = nullptr;
+    }
+
+    // #region 非メンバ関数
+
+    KernelProbeValues kernel_probe_sum()
+    {
+        std::lock_guard<std::mutex> lock(probe_values_mutex());
+
+        KernelProbeValues sum = {};
+        for (auto const & v : probe_values()) {
+            sum.trials += v->trials;
+
+            for (auto i = 0U; i < KERNELCOUNTERMAX; i++) {
+                sum.counts[i] += v->counts[i];
+            }
+
+            for (auto i = 0U; i < KERNELSTAGEMAX; i++) {
+                sum.ticks[i] += v->ticks[i];
+            }
+        }
+
+        return sum;
+    }
+
+    void print_kernel_probe(std::vector<char const *> const & counternames, std::vector<char const *> const & stagenames)
+    {
+        if constexpr (!KERNELPROBEENABLED) {
+            return;
+        }
+
+        auto const sum = kernel_probe_sum();
+        if (!sum.trials) {
+            return;
+        }
+
+        auto const trials = static_cast<double>(sum.trials);
+
+        std::cout << boost::format("カーネルの中の計測結果（試行あたりの平均, 試行 = %d回）\n") % sum.trials;
+
+        auto const countnum = std::min<std::size_t>(counternames.size(), KERNELCOUNTERMAX);
+        for (auto i = 0U; i < countnum; i++) {
+            std::cout << boost::format("  %s = %.2f回\n") % counternames[i] % (static_cast<double>(sum.counts[i]) / trials);
+        }
+
+        auto const stagenum = std::min<std::size_t>(stagenames.size(), KERNELSTAGEMAX);
+
+        auto total = 0.0;
+        for (auto i = 0U; i < stagenum; i++) {
+            total += static_cast<double>(sum.ticks[i]);
+        }
+
+        if (total <= 0.0) {
+            return;
+        }
+
+        auto const tickspernsec = TscClock::ticks_per_nsec();
+        for (auto i = 0U; i < stagenum; i++) {
+            auto const ticks = static_cast<double>(sum.ticks[i]);
+            std::cout << boost::format("  段階「%s」 = %.1f (%s), %.1f (nsec), %.1f%%\n")
+                         % stagenames[i]
+                         % (ticks / trials)
+                         % (TscClock::usetsc() ? "TSCサイクル" : "nsec")
+                         % (ticks / trials / tickspernsec)
+                         % (100.0 * ticks / total);
+        }
+    }
+
+    KernelProbeValues & this_thread_probe_values()
+    {
+        if (!current_values) {
+            std::lock_guard<std::mutex> lock(probe_values_mutex());
+
+            auto & v = probe_values();
+            v.push_back(std::make_unique<KernelProbeValues>());
+            current_values = v.back().get();
+        }
+
+        return *current_values;
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        std::vector<std::unique_ptr<KernelProbeValues>> & probe_values()
+        {
+            static std::vector<std::unique_ptr<KernelProbeValues>> v;
+            return v;
+        }
+
+        std::mutex & probe_values_mutex()
+        {
+            static std::mutex mtx;
+            return mtx;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+﻿/*! \file kernelprobe.h
+    \brief シミュレーションのカーネルの中を計測するためのクラスの宣言
+    _CHECK_KERNEL_PERFORMが定義されていないときは、何もしないクラスになる
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _KERNELPROBE_H_
+#define _KERNELPROBE_H_
+
+#pragma once
+
+#include "tscclock.h"
+#include <array>                // for std::array
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::uint64_t
+#include <vector>               // for std::vector
+
+namespace checkpoint {
+    //! A global variable (constant expression).
+    /*!
+        カーネルの中を計測するかどうか（_CHECK_KERNEL_PERFORMを定義してビルドしたかどうか）
+    */
+#ifdef _CHECK_KERNEL_PERFORM
+    static auto constexpr KERNELPROBEENABLED = true;
+#else
+    static auto constexpr KERNELPROBEENABLED = false;
+#endif
+
+    //! A global variable (constant expression).
+    /*!
+        数えられるイベントの種類の最大数
+    */
+    static auto constexpr KERNELCOUNTERMAX = 16U;
+
+    //! A global variable (constant expression).
+    /*!
+        時間を計測できる段階の種類の最大数
+    */
+    static auto constexpr KERNELSTAGEMAX = 8U;
+
+    //! A structure.
+    /*!
+        一つのスレッドの、カーネルの中の計測結果を格納する構造体
+        書き込むのはそのスレッドだけなので、アトミック変数にはしない
+    */
+    struct KernelProbeValues {
+        //! A public member variable.
+        /*!
+            カーネルを呼んだ回数（試行回数）
+        */
+        std::uint64_t trials;
+
+        //! A public member variable.
+        /*!
+            イベントの種類ごとの回数
+        */
+        std::array<std::uint64_t, KERNELCOUNTERMAX> counts;
+
+        //! A public member variable.
+        /*!
+            段階ごとの時間（TscClock::ticksの単位）
+        */
+        std::array<std::uint64_t, KERNELSTAGEMAX> ticks;
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        全てのスレッドの、カーネルの中の計測結果の合計を求める
+        他のスレッドが計測している最中に呼んではならない
+        \return 全てのスレッドの計測結果の合計
+    */
+    KernelProbeValues kernel_probe_sum();
+
+    //! A function.
+    /*!
+        カーネルの中の計測結果を、試行あたりの平均の表にして表示する
+        _CHECK_KERNEL_PERFORMが定義されていないときは何もしない
+        他のスレッドが計測している最中に呼んではならない
+        \param counternames イベントの種類ごとの名称（添字がイベントの番号）
+        \param stagenames 段階ごとの名称（添字が段階の番号）
+    */
+    void print_kernel_probe(std::vector<char const *> const & counternames, std::vector<char const *> const & stagenames);
+
+    //! A function.
+    /*!
+        呼び出したスレッドの、カーネルの中の計測結果を返す
+        \return 呼び出したスレッドの計測結果
+    */
+    KernelProbeValues & this_thread_probe_values();
+
+    // #endregion 非メンバ関数
+
+    //! A class template.
+    /*!
+        一回の試行の間、カーネルの中のイベントの回数と段階ごとの時間を計測するクラス
+        カーネルの先頭で生成し、イベントごとにcount、段階の終わりごとにstageを呼ぶ
+        Enabledがfalseのときは全てのメンバ関数が空になり、最適化で消える
+        \tparam Enabled 計測するかどうか
+    */
+    template <bool Enabled = KERNELPROBEENABLED>
+    class KernelProbe;
+
+    //! A class (template specialization).
+    /*!
+        計測するときのKernelProbe
+    */
+    template <>
+    class KernelProbe<true> final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            呼び出したスレッドの計測結果を取り出し、試行回数を数え、段階の計測を始める
+        */
+        KernelProbe()
+            : values_(this_thread_probe_values()), last_(TscClock::ticks())
+        {
+            values_.trials++;
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~KernelProbe() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            イベントを数える
+            \param id イベントの番号
+            \param n 回数
+        */
+        void count(std::size_t id, std::uint64_t n = 1)
+        {
+            values_.counts[id] += n;
+        }
+
+        //! A public member function.
+        /*!
+            直前のstage（またはコンストラクタ）からの時間を、その段階の時間として加える
+            \param id 段階の番号
+        */
+        void stage(std::size_t id)
+        {
+            auto const now = TscClock::ticks();
+            values_.ticks[id] += now - last_;
+            last_ = now;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            呼び出したスレッドの計測結果
+        */
+        KernelProbeValues & values_;
+
+        //! A private member variable.
+        /*!
+            直前の段階が終わった時刻（TscClock::ticksの単位）
+        */
+        std::uint64_t last_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        KernelProbe(KernelProbe const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        KernelProbe & operator=(KernelProbe const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class (template specialization).
+    /*!
+        計測しないときのKernelProbe（何もしない）
+    */
+    template <>
+    class KernelProbe<false> final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+        */
+        KernelProbe() = default;
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~KernelProbe() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            何もしない
+        */
+        void count(std::size_t, std::uint64_t = 1)
+        {
+        }
+
+        //! A public member function.
+        /*!
+            何もしない
+        */
+        void stage(std::size_t)
+        {
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        KernelProbe(KernelProbe const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        KernelProbe & operator=(KernelProbe const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _KERNELPROBE_H_
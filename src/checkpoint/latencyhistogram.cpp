@@ -0,0 +1,142 @@
+﻿/*! \file latencyhistogram.cpp
+    \brief 試行ごとの所要時間を、抽選回数ごとに集計するクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "latencyhistogram.h"
+#include <cmath>                // for std::frexp, std::ldexp
+#include <fstream>              // for std::ofstream
+#include <iostream>             // for std::cout
+#include <limits>               // for std::numeric_limits
+#include <boost/format.hpp>     // for boost::format
+
+namespace checkpoint {
+    // #region コンストラクタ・デストラクタ
+
+    LatencyHistogram::LatencyHistogram(std::int32_t maxdraws)
+        :   bins_(maxdraws + 1, Bin{ 0, 0, std::numeric_limits<std::int64_t>::max(), 0 }),
+            log2bins_(),
+            maxdraws_(maxdraws)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void LatencyHistogram::merge(LatencyHistogram const & rhs)
+    {
+        if (rhs.bins_.size() > bins_.size()) {
+            bins_.resize(rhs.bins_.size(), Bin{ 0, 0, std::numeric_limits<std::int64_t>::max(), 0 });
+            maxdraws_ = rhs.maxdraws_;
+        }
+
+        for (auto i = 0U; i < rhs.bins_.size(); i++) {
+            auto & b = bins_[i];
+            auto const & r = rhs.bins_[i];
+
+            b.count += r.count;
+            b.total += r.total;
+            b.min = r.min < b.min ? r.min : b.min;
+            b.max = r.max > b.max ? r.max : b.max;
+        }
+
+        for (auto i = 0U; i < log2bins_.size(); i++) {
+            log2bins_[i] += rhs.log2bins_[i];
+        }
+    }
+
+    void LatencyHistogram::outputcsv(std::string const & filename) const
+    {
+        std::ofstream ofs(filename);
+
+        ofs << "draws,count,mean_ns,min_ns,max_ns,ns_per_draw\n";
+
+        for (auto i = 0U; i < bins_.size(); i++) {
+            auto const & b = bins_[i];
+            if (!b.count) {
+                continue;
+            }
+
+            auto const mean = static_cast<double>(b.total) / static_cast<double>(b.count);
+
+            // 最後の要素は上限以上の抽選回数をまとめたもの
+            ofs << boost::format("%s%d,%d,%.1f,%d,%d,%.3f\n")
+                   % (i == bins_.size() - 1 ? ">=" : "")
+                   % i
+                   % b.count
+                   % mean
+                   % b.min
+                   % b.max
+                   % (i ? mean / static_cast<double>(i) : 0.0);
+        }
+    }
+
+    void LatencyHistogram::print() const
+    {
+        auto count = 0ULL;
+        auto total = 0LL;
+        auto draws = 0.0;
+        for (auto i = 0U; i < bins_.size(); i++) {
+            count += bins_[i].count;
+            total += bins_[i].total;
+            draws += static_cast<double>(i) * static_cast<double>(bins_[i].count);
+        }
+
+        if (!count) {
+            return;
+        }
+
+        // 桁ごとのヒストグラムから、パーセンタイルを求めるラムダ式
+        auto const percentile = [this, count](double p) {
+            auto const target = p * static_cast<double>(count);
+            auto cumulative = 0ULL;
+            for (auto i = 0U; i < log2bins_.size(); i++) {
+                cumulative += log2bins_[i];
+                if (static_cast<double>(cumulative) >= target) {
+                    return log2bin_upper(i);
+                }
+            }
+
+            return log2bin_upper(log2bins_.size() - 1);
+        };
+
+        std::cout << boost::format("試行ごとの所要時間 (%s)\n") % (TscClock::usetsc() ? (boost::format("TSC, %.3f GHz") % TscClock::frequency()).str() : "steady_clock")
+                  << boost::format("  試行 = %d回, 平均 = %.1f (nsec), 50%% = %.0f, 90%% = %.0f, 99%% = %.0f, 99.9%% = %.0f\n")
+                     % count
+                     % (static_cast<double>(total) / static_cast<double>(count))
+                     % percentile(0.5)
+                     % percentile(0.9)
+                     % percentile(0.99)
+                     % percentile(0.999)
+                  << boost::format("  抽選回数の平均 = %.1f回, 抽選一回あたり = %.2f (nsec)\n")
+                     % (draws / static_cast<double>(count))
+                     % (static_cast<double>(total) / draws);
+    }
+
+    std::size_t LatencyHistogram::log2bin(std::int64_t nsec)
+    {
+        if (nsec <= 0) {
+            return 0;
+        }
+
+        // nsec = m * 2^e (0.5 <= m < 1)と分解し、mを8つの区間に分ける
+        auto e = 0;
+        auto const m = std::frexp(static_cast<double>(nsec), &e);
+        auto const index = static_cast<std::size_t>(e) * 8 + static_cast<std::size_t>((m * 2.0 - 1.0) * 8.0);
+
+        return index < LOG2BINNUM ? index : LOG2BINNUM - 1;
+    }
+
+    double LatencyHistogram::log2bin_upper(std::size_t index)
+    {
+        auto const e = static_cast<std::int32_t>(index / 8);
+        auto const sub = static_cast<double>(index % 8);
+
+        return std::ldexp(1.0 + (sub + 1.0) / 8.0, e - 1);
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,189 @@
+﻿/*! \file latencyhistogram.h
+    \brief 試行ごとの所要時間を、抽選回数ごとに集計するクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _LATENCYHISTOGRAM_H_
+#define _LATENCYHISTOGRAM_H_
+
+#pragma once
+
+#include "profiler.h"
+#include <array>                // for std::array
+#include <chrono>               // for std::chrono::duration_cast
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int32_t, std::int64_t, std::uint64_t
+#include <string>               // for std::string
+#include <vector>               // for std::vector
+
+namespace checkpoint {
+    //! A class.
+    /*!
+        試行ごとの所要時間を、その試行の抽選回数ごとに集計するクラス
+        スレッドごとに一つずつ持ち、最後にmergeでまとめる
+    */
+    class LatencyHistogram final {
+        // #region クラス内クラスの宣言
+
+        //! A structure.
+        /*!
+            一つの抽選回数の集計結果を格納する構造体
+        */
+        struct Bin {
+            //! A public member variable.
+            /*!
+                試行回数
+            */
+            std::uint64_t count;
+
+            //! A public member variable.
+            /*!
+                所要時間の合計(nsec)
+            */
+            std::int64_t total;
+
+            //! A public member variable.
+            /*!
+                所要時間の最小値(nsec)
+            */
+            std::int64_t min;
+
+            //! A public member variable.
+            /*!
+                所要時間の最大値(nsec)
+            */
+            std::int64_t max;
+        };
+
+        // #endregion クラス内クラスの宣言
+
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param maxdraws 個別に集計する抽選回数の上限（これ以上はまとめて集計する）
+        */
+        explicit LatencyHistogram(std::int32_t maxdraws = 1024);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~LatencyHistogram() = default;
+
+        //! A copy constructor.
+        /*!
+            デフォルトコピーコンストラクタ
+        */
+        LatencyHistogram(LatencyHistogram const &) = default;
+
+        //! operator=().
+        /*!
+            デフォルトのoperator=()
+            \return コピー先のオブジェクト
+        */
+        LatencyHistogram & operator=(LatencyHistogram const &) = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            一つの試行の所要時間を加える
+            \param draws その試行の抽選回数
+            \param elapsed その試行の所要時間
+        */
+        void add(std::int32_t draws, Clock::duration elapsed)
+        {
+            auto const nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+            auto & b = bins_[draws < maxdraws_ ? draws : maxdraws_];
+            b.count++;
+            b.total += nsec;
+            b.min = nsec < b.min ? nsec : b.min;
+            b.max = nsec > b.max ? nsec : b.max;
+
+            // 所要時間の桁ごとのヒストグラム（パーセンタイルを求めるために使う）
+            log2bins_[log2bin(nsec)]++;
+        }
+
+        //! A public member function.
+        /*!
+            他のスレッドの集計結果をまとめる
+            \param rhs まとめる集計結果
+        */
+        void merge(LatencyHistogram const & rhs);
+
+        //! A public member function.
+        /*!
+            抽選回数ごとの集計結果をcsvファイルに出力する
+            \param filename ファイル名
+        */
+        void outputcsv(std::string const & filename) const;
+
+        //! A public member function.
+        /*!
+            所要時間のパーセンタイルと、抽選一回あたりの所要時間を表示する
+        */
+        void print() const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private static member function.
+        /*!
+            所要時間から、桁ごとのヒストグラムの番号を求める
+            2のべき乗ごとに8つに分ける
+            \param nsec 所要時間(nsec)
+            \return 桁ごとのヒストグラムの番号
+        */
+        static std::size_t log2bin(std::int64_t nsec);
+
+        //! A private static member function.
+        /*!
+            桁ごとのヒストグラムの番号から、その区間の上端の所要時間を求める
+            \param index 桁ごとのヒストグラムの番号
+            \return その区間の上端の所要時間(nsec)
+        */
+        static double log2bin_upper(std::size_t index);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant expression).
+        /*!
+            桁ごとのヒストグラムの区間の数
+        */
+        static auto constexpr LOG2BINNUM = 64 * 8;
+
+        //! A private member variable.
+        /*!
+            抽選回数ごとの集計結果
+        */
+        std::vector<Bin> bins_;
+
+        //! A private member variable.
+        /*!
+            所要時間の桁ごとのヒストグラム
+        */
+        std::array<std::uint64_t, LOG2BINNUM> log2bins_;
+
+        //! A private member variable.
+        /*!
+            個別に集計する抽選回数の上限
+        */
+        std::int32_t maxdraws_;
+
+        // #endregion メンバ変数
+    };
+}
+
+#endif  // _LATENCYHISTOGRAM_H_
@@ -0,0 +1,126 @@
+﻿/*! \file perfcounter.cpp
+    \brief ハードウェアパフォーマンスカウンタを読むクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "perfcounter.h"
+
+#ifdef __linux__
+    #include <cstring>              // for std::memset
+    #include <linux/perf_event.h>   // for perf_event_attr
+    #include <sys/syscall.h>        // for __NR_perf_event_open
+    #include <unistd.h>             // for close, read, syscall
+#endif
+
+namespace checkpoint {
+#ifdef __linux__
+    namespace {
+        //! A function.
+        /*!
+            呼び出したスレッドのカウンタを一つ開く
+            \param type カウンタの種類
+            \param config カウンタの設定
+            \return カウンタのファイルディスクリプタ（開けなかった場合は-1）
+        */
+        std::int32_t open_event(std::uint32_t type, std::uint64_t config);
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    PerfCounter::PerfCounter()
+    {
+        // グループにせず一つずつ開き、一部のカウンタしか使えない環境でも残りは使えるようにする
+        fds_[0] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds_[1] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[2] = open_event(
+            PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fds_[3] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds_[4] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    }
+
+    PerfCounter::~PerfCounter()
+    {
+        for (auto fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    PerfValues PerfCounter::read() const
+    {
+        PerfValues pv = {};
+
+        for (auto i = 0U; i < PERFEVENTNUM; i++) {
+            if (fds_[i] < 0) {
+                continue;
+            }
+
+            // 値、有効だった時間、実際に数えていた時間
+            std::uint64_t buf[3];
+            if (::read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) {
+                continue;
+            }
+
+            // 多重化されていた場合は、数えていなかった時間の分を補正する
+            pv.value[i] = buf[2] > 0 && buf[2] < buf[1] ?
+                static_cast<std::uint64_t>(static_cast<double>(buf[0]) * static_cast<double>(buf[1]) / static_cast<double>(buf[2])) :
+                buf[0];
+            pv.valid[i] = true;
+        }
+
+        return pv;
+    }
+
+    // #endregion メンバ関数
+
+    namespace {
+        std::int32_t open_event(std::uint32_t type, std::uint64_t config)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // pid = 0, cpu = -1で、呼び出したスレッドをどのCPUにいても数える
+            return static_cast<std::int32_t>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+#else
+    // #region コンストラクタ・デストラクタ
+
+    PerfCounter::PerfCounter()
+    {
+        fds_.fill(-1);
+    }
+
+    PerfCounter::~PerfCounter()
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    PerfValues PerfCounter::read() const
+    {
+        return PerfValues{};
+    }
+
+    // #endregion メンバ関数
+#endif
+}
@@ -0,0 +1,151 @@
+﻿/*! \file perfcounter.h
+    \brief ハードウェアパフォーマンスカウンタを読むクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _PERFCOUNTER_H_
+#define _PERFCOUNTER_H_
+
+#pragma once
+
+#include <array>                // for std::array
+#include <cstdint>              // for std::int32_t, std::uint64_t
+
+namespace checkpoint {
+    //! A global variable (constant expression).
+    /*!
+        計測するハードウェアパフォーマンスカウンタの数
+        順に、サイクル数、命令数、L1データキャッシュミス、LLCミス、分岐予測ミス
+    */
+    static auto constexpr PERFEVENTNUM = 5U;
+
+    //! A global variable (constant expression).
+    /*!
+        ハードウェアパフォーマンスカウンタの名称
+    */
+    static constexpr std::array<char const *, PERFEVENTNUM> PERFEVENTNAME = {
+        "サイクル数", "命令数", "L1Dミス", "LLCミス", "分岐予測ミス"
+    };
+
+    //! A structure.
+    /*!
+        ハードウェアパフォーマンスカウンタの値を格納する構造体
+    */
+    struct PerfValues {
+        //! A public member variable.
+        /*!
+            カウンタの値
+        */
+        std::array<std::uint64_t, PERFEVENTNUM> value;
+
+        //! A public member variable.
+        /*!
+            カウンタが使えるかどうか
+        */
+        std::array<bool, PERFEVENTNUM> valid;
+
+        //! A public member function.
+        /*!
+            一つでも使えるカウンタがあるかどうかを返す
+            \return 一つでも使えるカウンタがあるかどうか
+        */
+        bool any() const
+        {
+            for (auto v : valid) {
+                if (v) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        //! A public member function.
+        /*!
+            他のカウンタの値を加える
+            \param rhs 加えるカウンタの値
+            \return 自分自身
+        */
+        PerfValues & operator+=(PerfValues const & rhs)
+        {
+            for (auto i = 0U; i < PERFEVENTNUM; i++) {
+                value[i] += rhs.value[i];
+                valid[i] = valid[i] || rhs.valid[i];
+            }
+
+            return *this;
+        }
+    };
+
+    //! A class.
+    /*!
+        生成したスレッドのハードウェアパフォーマンスカウンタを読むクラス
+        Linuxのperf_event_openを使う
+        使えない環境や権限がない場合は何も数えず、全てのカウンタが無効になる
+    */
+    class PerfCounter final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            呼び出したスレッドのカウンタを開いて、数え始める
+        */
+        PerfCounter();
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            開いたカウンタを閉じる
+        */
+        ~PerfCounter();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            数え始めてからのカウンタの値を読む
+            他のスレッドから呼んでもよい
+            \return カウンタの値
+        */
+        PerfValues read() const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            カウンタのファイルディスクリプタ（使えない場合は-1）
+        */
+        std::array<std::int32_t, PERFEVENTNUM> fds_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        PerfCounter(PerfCounter const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        PerfCounter & operator=(PerfCounter const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _PERFCOUNTER_H_
@@ -0,0 +1,302 @@
+﻿/*! \file profiler.cpp
+    \brief スレッドごとに区間の計測結果を記録するクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "profiler.h"
+#include <algorithm>            // for std::sort
+#include <atomic>               // for std::atomic
+#include <cstring>              // for std::strcmp
+#include <iostream>             // for std::cout
+#include <memory>               // for std::unique_ptr
+#include <mutex>                // for std::lock_guard, std::mutex
+#include <string>               // for std::string
+#include <boost/format.hpp>     // for boost::format
+
+namespace checkpoint {
+    namespace {
+        //! A structure.
+        /*!
+            全てのスレッドの記録を、区間の名称ごとにまとめた結果を格納する構造体
+        */
+        struct PhaseSummary {
+            //! A public member variable.
+            /*!
+                区間の名称
+            */
+            std::string name;
+
+            //! A public member variable.
+            /*!
+                区間の入れ子の深さ
+            */
+            std::int32_t depth;
+
+            //! A public member variable.
+            /*!
+                最初に計測した区間の開始時刻
+            */
+            Clock::time_point first;
+
+            //! A public member variable.
+            /*!
+                計測回数
+            */
+            std::uint64_t count;
+
+            //! A public member variable.
+            /*!
+                経過時間の合計
+            */
+            Clock::duration total;
+
+            //! A public member variable.
+            /*!
+                経過時間の最小値
+            */
+            Clock::duration min;
+
+            //! A public member variable.
+            /*!
+                経過時間の最大値
+            */
+            Clock::duration max;
+
+            //! A public member variable.
+            /*!
+                リングバッファに残っている経過時間（パーセンタイルを求めるために使う）
+            */
+            std::vector<Clock::duration> samples;
+        };
+
+        //! A function.
+        /*!
+            経過時間をマイクロ秒に変換する
+            \param d 経過時間
+            \return マイクロ秒で表した経過時間
+        */
+        double to_usec(Clock::duration d);
+
+        //! A function.
+        /*!
+            ソート済みの経過時間の配列から、パーセンタイルを求める
+            \param sorted ソート済みの経過時間の配列
+            \param p パーセント
+            \return パーセンタイル
+        */
+        Clock::duration percentile(std::vector<Clock::duration> const & sorted, double p);
+
+        //! A function.
+        /*!
+            登録された全てのスレッドの記録クラスのオブジェクトを返す
+            \return 登録された全てのスレッドの記録クラスのオブジェクトの可変長配列
+        */
+        std::vector< std::unique_ptr<ThreadRecorder> > & recorders();
+
+        //! A function.
+        /*!
+            recordersを保護するミューテックスを返す
+            \return recordersを保護するミューテックス
+        */
+        std::mutex & recorders_mutex();
+
+        //! A global variable.
+        /*!
+            これから生成されるスレッドのリングバッファの容量
+        */
+        std::atomic<std::size_t> ring_capacity(1 << 16);
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドの記録クラスのオブジェクトへのポインタ
+        */
+        thread_local ThreadRecorder * current_recorder = nullptr;
+    }
+
+    // #region コンストラクタ
+
+    ThreadRecorder::ThreadRecorder(std::int32_t index, std::size_t capacity)
+        : cpuclock_(),
+          depth_(0),
+          index_(index),
+          counters_(capacity),
+          events_(capacity)
+    {
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void ThreadRecorder::leave(Event const & event)
+    {
+        depth_--;
+
+        events_.push(event);
+
+        auto const elapsed = event.end - event.start;
+
+        // 同じ名称の集計結果を探す（名称はほとんどの場合同じ文字列リテラルを指している）
+        for (auto & s : statistics_) {
+            if (s.name == event.name || !std::strcmp(s.name, event.name)) {
+                s.count++;
+                s.total += elapsed;
+                s.min = std::min(s.min, elapsed);
+                s.max = std::max(s.max, elapsed);
+
+                return;
+            }
+        }
+
+        statistics_.push_back(PhaseStatistics{ event.name, event.depth, event.start, 1, elapsed, elapsed, elapsed });
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    PerfValues perf_counters_sum()
+    {
+        std::lock_guard<std::mutex> lock(recorders_mutex());
+
+        PerfValues sum = {};
+        for (auto const & r : recorders()) {
+            sum += r->perfcounter().read();
+        }
+
+        return sum;
+    }
+
+    void print_phase_statistics()
+    {
+        std::lock_guard<std::mutex> lock(recorders_mutex());
+
+        // 区間の名称ごとにまとめた結果
+        std::vector<PhaseSummary> summaries;
+
+        auto const find = [&summaries](char const * name) {
+            return std::find_if(
+                summaries.begin(),
+                summaries.end(),
+                [name](auto const & s) { return s.name == name; });
+        };
+
+        for (auto const & r : recorders()) {
+            for (auto const & s : r->statistics()) {
+                auto itr = find(s.name);
+                if (itr == summaries.end()) {
+                    summaries.push_back(PhaseSummary{ s.name, s.depth, s.first, s.count, s.total, s.min, s.max, {} });
+                }
+                else {
+                    itr->depth = std::min(itr->depth, s.depth);
+                    itr->first = std::min(itr->first, s.first);
+                    itr->count += s.count;
+                    itr->total += s.total;
+                    itr->min = std::min(itr->min, s.min);
+                    itr->max = std::max(itr->max, s.max);
+                }
+            }
+
+            r->events().for_each([&find](auto const & e) {
+                find(e.name)->samples.push_back(e.end - e.start);
+            });
+        }
+
+        if (summaries.empty()) {
+            return;
+        }
+
+        // 外側の区間が内側の区間より先に表示されるように、開始時刻の順に並べる
+        std::stable_sort(
+            summaries.begin(),
+            summaries.end(),
+            [](auto const & lhs, auto const & rhs) { return lhs.first < rhs.first; });
+
+        std::cout << "区間の名称ごとの集計結果 (usec)\n";
+
+        for (auto & s : summaries) {
+            std::sort(s.samples.begin(), s.samples.end());
+
+            std::cout << std::string(2 * s.depth, ' ') << s.name
+                      << boost::format(" 回数 = %d, 合計 = %.4f (msec), 最小 = %.3f, 最大 = %.3f, ")
+                         % s.count
+                         % (to_usec(s.total) / 1000.0)
+                         % to_usec(s.min)
+                         % to_usec(s.max)
+                      << boost::format("50%% = %.3f, 90%% = %.3f, 99%% = %.3f\n")
+                         % to_usec(percentile(s.samples, 50.0))
+                         % to_usec(percentile(s.samples, 90.0))
+                         % to_usec(percentile(s.samples, 99.0));
+        }
+    }
+
+    void record_counter(char const * name, double value)
+    {
+        this_thread_recorder().counter(name, value);
+    }
+
+    void set_ring_capacity(std::size_t capacity)
+    {
+        ring_capacity = capacity;
+    }
+
+    ThreadRecorder & this_thread_recorder()
+    {
+        if (!current_recorder) {
+            std::lock_guard<std::mutex> lock(recorders_mutex());
+
+            auto & r = recorders();
+            r.push_back(std::make_unique<ThreadRecorder>(static_cast<std::int32_t>(r.size()), ring_capacity.load()));
+            current_recorder = r.back().get();
+        }
+
+        return *current_recorder;
+    }
+
+    std::vector<ThreadRecorder const *> thread_recorders()
+    {
+        std::lock_guard<std::mutex> lock(recorders_mutex());
+
+        std::vector<ThreadRecorder const *> v;
+        for (auto const & r : recorders()) {
+            v.push_back(r.get());
+        }
+
+        return v;
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        double to_usec(Clock::duration d)
+        {
+            return std::chrono::duration<double, std::micro>(d).count();
+        }
+
+        Clock::duration percentile(std::vector<Clock::duration> const & sorted, double p)
+        {
+            if (sorted.empty()) {
+                return Clock::duration::zero();
+            }
+
+            // 最近傍順位法
+            auto const rank = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.5);
+            return sorted[rank > 0 ? std::min(rank, sorted.size()) - 1 : 0];
+        }
+
+        std::vector< std::unique_ptr<ThreadRecorder> > & recorders()
+        {
+            // スレッドの終了後も記録を読めるように、プログラムの終了まで破棄しない
+            static std::vector< std::unique_ptr<ThreadRecorder> > r;
+            return r;
+        }
+
+        std::mutex & recorders_mutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+    }
+}
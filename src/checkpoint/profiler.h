@@ -0,0 +1,370 @@
+﻿/*! \file profiler.h
+    \brief スレッドごとに区間の計測結果を記録するクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#pragma once
+
+#include "cputime.h"
+#include "perfcounter.h"
+#include "ringbuffer.h"
+#include "tscclock.h"
+#include <cstdint>              // for std::int32_t, std::uint64_t
+#include <vector>               // for std::vector
+
+namespace checkpoint {
+    //! A typedef.
+    /*!
+        区間の計測に使う時計（不変TSCが使えればTSC、使えなければsteady_clock）
+    */
+    using Clock = TscClock;
+
+    //! A structure.
+    /*!
+        一つの区間の計測結果を格納する構造体
+    */
+    struct Event {
+        //! A public member variable.
+        /*!
+            区間の名称
+        */
+        char const * name;
+
+        //! A public member variable.
+        /*!
+            区間の開始時刻
+        */
+        Clock::time_point start;
+
+        //! A public member variable.
+        /*!
+            区間の終了時刻
+        */
+        Clock::time_point end;
+
+        //! A public member variable.
+        /*!
+            区間の入れ子の深さ
+        */
+        std::int32_t depth;
+    };
+
+    //! A structure.
+    /*!
+        カウンタの一つの値を格納する構造体
+    */
+    struct CounterSample {
+        //! A public member variable.
+        /*!
+            カウンタの名称
+        */
+        char const * name;
+
+        //! A public member variable.
+        /*!
+            値を記録した時刻
+        */
+        Clock::time_point time;
+
+        //! A public member variable.
+        /*!
+            カウンタの値
+        */
+        double value;
+    };
+
+    //! A structure.
+    /*!
+        一つのスレッドにおける、区間の名称ごとの集計結果を格納する構造体
+    */
+    struct PhaseStatistics {
+        //! A public member variable.
+        /*!
+            区間の名称
+        */
+        char const * name;
+
+        //! A public member variable.
+        /*!
+            区間の入れ子の深さ
+        */
+        std::int32_t depth;
+
+        //! A public member variable.
+        /*!
+            最初に計測した区間の開始時刻
+        */
+        Clock::time_point first;
+
+        //! A public member variable.
+        /*!
+            計測回数
+        */
+        std::uint64_t count;
+
+        //! A public member variable.
+        /*!
+            経過時間の合計
+        */
+        Clock::duration total;
+
+        //! A public member variable.
+        /*!
+            経過時間の最小値
+        */
+        Clock::duration min;
+
+        //! A public member variable.
+        /*!
+            経過時間の最大値
+        */
+        Clock::duration max;
+    };
+
+    //! A class.
+    /*!
+        一つのスレッドの区間の計測結果を記録するクラス
+        記録するのはそのスレッド自身だけなので、ロックは必要ない
+    */
+    class ThreadRecorder final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param index スレッドの通し番号
+            \param capacity リングバッファの容量
+        */
+        ThreadRecorder(std::int32_t index, std::size_t capacity);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ThreadRecorder() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            区間に入る
+            \return 入った区間の入れ子の深さ
+        */
+        std::int32_t enter()
+        {
+            return depth_++;
+        }
+
+        //! A public member function.
+        /*!
+            区間から出て、その区間の計測結果を記録する
+            \param event 区間の計測結果
+        */
+        void leave(Event const & event);
+
+        //! A public member function.
+        /*!
+            カウンタの値を記録する
+            \param name カウンタの名称（文字列リテラルなど、プログラムの終了まで有効な文字列）
+            \param value カウンタの値
+        */
+        void counter(char const * name, double value)
+        {
+            counters_.push(CounterSample{ name, Clock::now(), value });
+        }
+
+        //! A public member function.
+        /*!
+            スレッドのCPU時間を読む時計を返す
+            \return スレッドのCPU時間を読む時計
+        */
+        ThreadCpuClock const & cpuclock() const
+        {
+            return cpuclock_;
+        }
+
+        //! A public member function.
+        /*!
+            記録されたカウンタの値を返す
+            \return 記録されたカウンタの値のリングバッファ
+        */
+        RingBuffer<CounterSample> const & counters() const
+        {
+            return counters_;
+        }
+
+        //! A public member function.
+        /*!
+            記録された区間の計測結果を返す
+            \return 記録された区間の計測結果のリングバッファ
+        */
+        RingBuffer<Event> const & events() const
+        {
+            return events_;
+        }
+
+        //! A public member function.
+        /*!
+            スレッドのハードウェアパフォーマンスカウンタを返す
+            \return スレッドのハードウェアパフォーマンスカウンタ
+        */
+        PerfCounter const & perfcounter() const
+        {
+            return perfcounter_;
+        }
+
+        //! A public member function.
+        /*!
+            スレッドの通し番号を返す
+            \return スレッドの通し番号
+        */
+        std::int32_t index() const
+        {
+            return index_;
+        }
+
+        //! A public member function.
+        /*!
+            区間の名称ごとの集計結果を返す
+            \return 区間の名称ごとの集計結果
+        */
+        std::vector<PhaseStatistics> const & statistics() const
+        {
+            return statistics_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            スレッドのCPU時間を読む時計
+        */
+        ThreadCpuClock cpuclock_;
+
+        //! A private member variable.
+        /*!
+            現在の入れ子の深さ
+        */
+        std::int32_t depth_;
+
+        //! A private member variable (constant).
+        /*!
+            スレッドの通し番号
+        */
+        std::int32_t const index_;
+
+        //! A private member variable.
+        /*!
+            カウンタの値のリングバッファ
+        */
+        RingBuffer<CounterSample> counters_;
+
+        //! A private member variable.
+        /*!
+            スレッドのハードウェアパフォーマンスカウンタ
+        */
+        PerfCounter perfcounter_;
+
+        //! A private member variable.
+        /*!
+            区間の計測結果のリングバッファ（容量を超えると古い順に上書きし、上書きした数はdropped()で分かる）
+        */
+        RingBuffer<Event> events_;
+
+        //! A private member variable.
+        /*!
+            区間の名称ごとの集計結果
+            リングバッファが上書きされても回数と合計は失われない
+        */
+        std::vector<PhaseStatistics> statistics_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ThreadRecorder() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ThreadRecorder(ThreadRecorder const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ThreadRecorder & operator=(ThreadRecorder const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        登録された全てのスレッドのハードウェアパフォーマンスカウンタの値の合計を求める
+        \return 全てのスレッドのカウンタの値の合計
+    */
+    PerfValues perf_counters_sum();
+
+    //! A function.
+    /*!
+        区間の名称ごとの集計結果を表示する
+        全てのスレッドの記録を名称ごとにまとめて、回数、合計、最小、最大、パーセンタイルを表示する
+        パーセンタイルはリングバッファに残っている記録から求める
+        他のスレッドが記録している最中に呼んではならない
+    */
+    void print_phase_statistics();
+
+    //! A function.
+    /*!
+        呼び出したスレッドの記録クラスのオブジェクトに、カウンタの値を記録する
+        \param name カウンタの名称（文字列リテラルなど、プログラムの終了まで有効な文字列）
+        \param value カウンタの値
+    */
+    void record_counter(char const * name, double value);
+
+    //! A function.
+    /*!
+        これから生成されるスレッドのリングバッファの容量を設定する
+        \param capacity リングバッファの容量
+    */
+    void set_ring_capacity(std::size_t capacity);
+
+    //! A function.
+    /*!
+        呼び出したスレッドの記録クラスのオブジェクトを返す
+        初めて呼ばれたときに生成して登録する
+        \return 呼び出したスレッドの記録クラスのオブジェクト
+    */
+    ThreadRecorder & this_thread_recorder();
+
+    //! A function.
+    /*!
+        登録された全てのスレッドの記録クラスのオブジェクトを、登録された順に返す
+        \return 登録された全てのスレッドの記録クラスのオブジェクトへのポインタの可変長配列
+    */
+    std::vector<ThreadRecorder const *> thread_recorders();
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _PROFILER_H_
@@ -0,0 +1,223 @@
+﻿/*! \file resourcesampler.cpp
+    \brief メモリ使用量とCPU時間を一定間隔で記録するクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "resourcesampler.h"
+#include "checkpoint.h"
+#include "cputime.h"
+#include <fstream>              // for std::ifstream, std::ofstream
+#include <iostream>             // for std::cout
+#include <boost/format.hpp>     // for boost::format
+
+#ifdef __linux__
+    #include <sstream>          // for std::istringstream
+    #include <unistd.h>         // for sysconf
+#endif
+
+namespace checkpoint {
+    namespace {
+        //! A function.
+        /*!
+            その時刻を含む区間の名称（その時刻より後の、最初のチェックポイントの名称）を求める
+            \param marks チェックポイントの情報の可変長配列
+            \param time 時刻
+            \return 区間の名称
+        */
+        char const * phase_name(std::vector<TraceMark> const & marks, Clock::time_point time);
+
+        //! A function.
+        /*!
+            時刻を、最初のチェックポイントからの経過時間(msec)に変換する
+            \param marks チェックポイントの情報の可変長配列
+            \param time 時刻
+            \return 最初のチェックポイントからの経過時間(msec)
+        */
+        double to_msec(std::vector<TraceMark> const & marks, Clock::time_point time);
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    ResourceSampler::ResourceSampler(std::chrono::milliseconds interval)
+        : interval_(interval), stopped_(false)
+    {
+        if (interval_.count() > 0) {
+            samples_.push_back(sample_resources());
+            sampler_ = std::thread([this] { run(); });
+        }
+    }
+
+    ResourceSampler::~ResourceSampler()
+    {
+        stop();
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void ResourceSampler::outputcsv(std::vector<TraceMark> const & marks, std::string const & filename) const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (samples_.empty()) {
+            return;
+        }
+
+        std::ofstream ofs(filename);
+
+        ofs << "time_ms,phase,rss_kB,minflt,majflt,cpu_ms\n";
+
+        for (auto const & s : samples_) {
+            ofs << boost::format("%.3f,%s,%d,%d,%d,%.3f\n")
+                   % to_msec(marks, s.time)
+                   % phase_name(marks, s.time)
+                   % s.rss
+                   % s.minflt
+                   % s.majflt
+                   % (s.cpu >= 0 ? static_cast<double>(s.cpu) * 1.0E-6 : -1.0);
+        }
+    }
+
+    void ResourceSampler::print(std::vector<TraceMark> const & marks) const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (samples_.empty()) {
+            return;
+        }
+
+        // メモリ使用量が最大になった記録
+        auto const * peak = &samples_.front();
+        for (auto const & s : samples_) {
+            if (s.rss > peak->rss) {
+                peak = &s;
+            }
+        }
+
+        auto const & first = samples_.front();
+        auto const & last = samples_.back();
+
+        std::cout << boost::format("メモリ使用量の時系列: 記録 = %d回, 最大 = %d (kB) (%.1f msec, %s), ページフォールト = %d回 (メジャー %d回)\n")
+                     % samples_.size()
+                     % peak->rss
+                     % to_msec(marks, peak->time)
+                     % phase_name(marks, peak->time)
+                     % (last.minflt - first.minflt)
+                     % (last.majflt - first.majflt);
+    }
+
+    void ResourceSampler::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (stopped_) {
+                return;
+            }
+
+            stopped_ = true;
+        }
+
+        stopcv_.notify_all();
+        if (sampler_.joinable()) {
+            sampler_.join();
+
+            // 止めた時点の値も記録しておく
+            std::lock_guard<std::mutex> lock(mtx_);
+            samples_.push_back(sample_resources());
+        }
+    }
+
+    void ResourceSampler::run()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!stopcv_.wait_for(lock, interval_, [this] { return stopped_; })) {
+            samples_.push_back(sample_resources());
+        }
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    ResourceSample sample_resources()
+    {
+        ResourceSample s = { Clock::now(), -1, -1, -1, -1 };
+
+#ifdef __linux__
+        // /proc/self/statの2番目の値（コマンド名）は空白を含み得るので、最後の')'より後ろを読む
+        std::ifstream ifs("/proc/self/stat");
+        std::string line;
+        if (std::getline(ifs, line)) {
+            if (auto const pos = line.rfind(')'); pos != std::string::npos) {
+                std::istringstream iss(line.substr(pos + 2));
+
+                // 3番目の値（状態）から読み、10番目がminflt、12番目がmajflt、14番目がutime、15番目がstime
+                std::string field;
+                std::int64_t minflt = 0, majflt = 0, utime = 0, stime = 0;
+                for (auto i = 3; i <= 15 && (iss >> field); i++) {
+                    switch (i) {
+                    case 10:
+                        minflt = std::stoll(field);
+                        break;
+
+                    case 12:
+                        majflt = std::stoll(field);
+                        break;
+
+                    case 14:
+                        utime = std::stoll(field);
+                        break;
+
+                    case 15:
+                        stime = std::stoll(field);
+                        s.minflt = minflt;
+                        s.majflt = majflt;
+                        s.cpu = (utime + stime) * (1000000000LL / static_cast<std::int64_t>(::sysconf(_SC_CLK_TCK)));
+                        break;
+
+                    default:
+                        break;
+                    }
+                }
+            }
+        }
+
+        // clock_gettimeの方が細かいので、使えればそちらを使う
+        if (auto const cpu = process_cputime(); cpu >= 0) {
+            s.cpu = cpu;
+        }
+#else
+        s.cpu = process_cputime();
+#endif
+        s.rss = currentmem();
+
+        return s;
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        char const * phase_name(std::vector<TraceMark> const & marks, Clock::time_point time)
+        {
+            for (auto const & m : marks) {
+                if (time <= m.time) {
+                    return m.action;
+                }
+            }
+
+            return "最後のチェックポイント以降";
+        }
+
+        double to_msec(std::vector<TraceMark> const & marks, Clock::time_point time)
+        {
+            if (marks.empty()) {
+                return 0.0;
+            }
+
+            return std::chrono::duration<double, std::milli>(time - marks.front().time).count();
+        }
+    }
+}
@@ -0,0 +1,198 @@
+﻿/*! \file resourcesampler.h
+    \brief メモリ使用量とCPU時間を一定間隔で記録するクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RESOURCESAMPLER_H_
+#define _RESOURCESAMPLER_H_
+
+#pragma once
+
+#include "chrometrace.h"
+#include <chrono>               // for std::chrono::milliseconds
+#include <condition_variable>   // for std::condition_variable
+#include <cstdint>              // for std::int64_t
+#include <mutex>                // for std::mutex
+#include <string>               // for std::string
+#include <thread>               // for std::thread
+#include <vector>               // for std::vector
+
+namespace checkpoint {
+    //! A structure.
+    /*!
+        ある時刻のメモリ使用量とCPU時間を格納する構造体
+    */
+    struct ResourceSample {
+        //! A public member variable.
+        /*!
+            記録した時刻
+        */
+        Clock::time_point time;
+
+        //! A public member variable.
+        /*!
+            常駐セットサイズ(kB)
+        */
+        std::int64_t rss;
+
+        //! A public member variable.
+        /*!
+            マイナーページフォールトの回数（計測できなければ-1）
+        */
+        std::int64_t minflt;
+
+        //! A public member variable.
+        /*!
+            メジャーページフォールトの回数（計測できなければ-1）
+        */
+        std::int64_t majflt;
+
+        //! A public member variable.
+        /*!
+            プロセスのCPU時間(nsec)（計測できなければ-1）
+        */
+        std::int64_t cpu;
+    };
+
+    //! A class.
+    /*!
+        別のスレッドで、メモリ使用量とCPU時間を一定間隔で記録するクラス
+        Linuxでは/proc/self/statmと/proc/self/statを読む
+    */
+    class ResourceSampler final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param interval 記録する間隔（0なら記録しない）
+        */
+        explicit ResourceSampler(std::chrono::milliseconds interval);
+
+        //! A destructor.
+        /*!
+            デストラクタ
+        */
+        ~ResourceSampler();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            記録した結果を、チェックポイントの区間の名称を付けてcsvファイルに出力する
+            stopを呼んだ後に呼ぶこと
+            \param marks チェックポイントの情報の可変長配列
+            \param filename ファイル名
+        */
+        void outputcsv(std::vector<TraceMark> const & marks, std::string const & filename) const;
+
+        //! A public member function.
+        /*!
+            メモリ使用量が最大になった時刻と、そのときの区間の名称を表示する
+            stopを呼んだ後に呼ぶこと
+            \param marks チェックポイントの情報の可変長配列
+        */
+        void print(std::vector<TraceMark> const & marks) const;
+
+        //! A public member function.
+        /*!
+            記録を止める
+        */
+        void stop();
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            一定間隔でメモリ使用量とCPU時間を記録する
+        */
+        void run();
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            記録する間隔
+        */
+        std::chrono::milliseconds const interval_;
+
+        //! A private member variable.
+        /*!
+            samples_とstopped_を保護するミューテックス
+        */
+        mutable std::mutex mtx_;
+
+        //! A private member variable.
+        /*!
+            記録した結果の可変長配列
+        */
+        std::vector<ResourceSample> samples_;
+
+        //! A private member variable.
+        /*!
+            記録するスレッド
+        */
+        std::thread sampler_;
+
+        //! A private member variable.
+        /*!
+            記録を止めたかどうか
+        */
+        bool stopped_;
+
+        //! A private member variable.
+        /*!
+            sampler_を止めるための条件変数
+        */
+        std::condition_variable stopcv_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ResourceSampler() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ResourceSampler(ResourceSampler const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ResourceSampler & operator=(ResourceSampler const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        現在のメモリ使用量とCPU時間を読む
+        \return 現在のメモリ使用量とCPU時間
+    */
+    ResourceSample sample_resources();
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _RESOURCESAMPLER_H_
@@ -0,0 +1,160 @@
+﻿/*! \file ringbuffer.h
+    \brief 固定容量のリングバッファクラスの宣言と実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RINGBUFFER_H_
+#define _RINGBUFFER_H_
+
+#pragma once
+
+#include <algorithm>    // for std::min
+#include <cstdint>      // for std::uint64_t
+#include <vector>       // for std::vector
+
+namespace checkpoint {
+    //! A template class.
+    /*!
+        固定容量のリングバッファクラス
+        容量を超えて書き込むと、最も古い要素から上書きする
+        書き込むスレッドは一つだけでなければならない
+        \param T 収納する型
+    */
+    template <typename T>
+    class RingBuffer final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param capacity リングバッファの容量
+        */
+        explicit RingBuffer(std::size_t capacity)
+            : buffer_(capacity > 0 ? capacity : 1), head_(0)
+        {
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~RingBuffer() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            要素を一つ書き込む
+            \param value 書き込む要素
+        */
+        void push(T const & value)
+        {
+            buffer_[head_ % buffer_.size()] = value;
+            head_++;
+        }
+
+        //! A public member function.
+        /*!
+            リングバッファの容量を返す
+            \return リングバッファの容量
+        */
+        std::size_t capacity() const
+        {
+            return buffer_.size();
+        }
+
+        //! A public member function.
+        /*!
+            容量を超えて上書きされ、失われた要素の数を返す
+            \return 上書きされた要素の数
+        */
+        std::uint64_t dropped() const
+        {
+            return head_ - size();
+        }
+
+        //! A public member function.
+        /*!
+            現在保持している要素の数を返す
+            \return 現在保持している要素の数
+        */
+        std::size_t size() const
+        {
+            return static_cast<std::size_t>(std::min<std::uint64_t>(head_, buffer_.size()));
+        }
+
+        //! A public member function.
+        /*!
+            これまでに書き込まれた要素の総数を返す（上書きされた要素も含む）
+            \return これまでに書き込まれた要素の総数
+        */
+        std::uint64_t total() const
+        {
+            return head_;
+        }
+
+        //! A public member function.
+        /*!
+            保持している要素を古い順に走査する
+            \param func 各要素に対して呼ばれる関数オブジェクト
+        */
+        template <typename Function>
+        void for_each(Function func) const
+        {
+            auto const first = head_ - size();
+            for (auto i = first; i < head_; i++) {
+                func(buffer_[i % buffer_.size()]);
+            }
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            要素の配列
+        */
+        std::vector<T> buffer_;
+
+        //! A private member variable.
+        /*!
+            次に書き込む位置（これまでに書き込まれた要素の総数）
+        */
+        std::uint64_t head_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        RingBuffer() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        RingBuffer(RingBuffer const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        RingBuffer & operator=(RingBuffer const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _RINGBUFFER_H_
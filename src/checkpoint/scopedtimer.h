@@ -0,0 +1,228 @@
+﻿/*! \file scopedtimer.h
+    \brief スコープの経過時間を計測するクラスの宣言と実装
+    試行ごとの区間を計測するTrialTimerは、_CHECK_TRIAL_TIMERが定義されていないときは何もしないクラスになる
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _SCOPEDTIMER_H_
+#define _SCOPEDTIMER_H_
+
+#pragma once
+
+#include "profiler.h"
+#include <cstdint>              // for std::int32_t
+
+namespace checkpoint {
+    //! A global variable (constant expression).
+    /*!
+        試行ごとの区間を計測するかどうか（_CHECK_TRIAL_TIMERを定義してビルドしたかどうか）
+    */
+#ifdef _CHECK_TRIAL_TIMER
+    static auto constexpr TRIALTIMERENABLED = true;
+#else
+    static auto constexpr TRIALTIMERENABLED = false;
+#endif
+
+    //! A class.
+    /*!
+        生成されてから破棄されるまでの経過時間を計測するクラス
+        入れ子にでき、TBBのワーカースレッドの中でも使える
+    */
+    class ScopedTimer final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param name 区間の名称（文字列リテラルなど、プログラムの終了まで有効な文字列）
+        */
+        explicit ScopedTimer(char const * name)
+            : name_(name),
+              recorder_(this_thread_recorder()),
+              depth_(recorder_.enter()),
+              start_(Clock::now())
+        {
+        }
+
+        //! A destructor.
+        /*!
+            経過時間をスレッドの記録クラスのオブジェクトに記録する
+        */
+        ~ScopedTimer()
+        {
+            recorder_.leave(Event{ name_, start_, Clock::now(), depth_ });
+        }
+
+        // #endregion コンストラクタ・デストラクタ
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            区間の名称
+        */
+        char const * const name_;
+
+        //! A private member variable.
+        /*!
+            スレッドの記録クラスのオブジェクト
+        */
+        ThreadRecorder & recorder_;
+
+        //! A private member variable (constant).
+        /*!
+            区間の入れ子の深さ
+        */
+        std::int32_t const depth_;
+
+        //! A private member variable (constant).
+        /*!
+            区間の開始時刻
+        */
+        Clock::time_point const start_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ScopedTimer() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ScopedTimer(ScopedTimer const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ScopedTimer & operator=(ScopedTimer const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class template.
+    /*!
+        一回の試行の中の区間の経過時間を計測するクラス
+        一回の試行は数マイクロ秒なので、区間ごとの時刻の読み取りと記録が無視できない
+        試行全体の所要時間はLatencyHistogramで集計しているので、既定では計測しない
+        \tparam Enabled 計測するかどうか
+    */
+    template <bool Enabled = TRIALTIMERENABLED>
+    class TrialTimer;
+
+    //! A class (template specialization).
+    /*!
+        計測するときのTrialTimer（ScopedTimerで計測する）
+    */
+    template <>
+    class TrialTimer<true> final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param name 区間の名称（文字列リテラルなど、プログラムの終了まで有効な文字列）
+        */
+        explicit TrialTimer(char const * name)
+            : timer_(name)
+        {
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~TrialTimer() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable (constant).
+        /*!
+            区間の経過時間を計測するオブジェクト
+        */
+        ScopedTimer const timer_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TrialTimer(TrialTimer const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        TrialTimer & operator=(TrialTimer const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class (template specialization).
+    /*!
+        計測しないときのTrialTimer（何もしない）
+    */
+    template <>
+    class TrialTimer<false> final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ（何もしない）
+        */
+        explicit TrialTimer(char const *)
+        {
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~TrialTimer() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+    private:
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TrialTimer(TrialTimer const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        TrialTimer & operator=(TrialTimer const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SCOPEDTIMER_H_
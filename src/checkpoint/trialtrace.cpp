@@ -0,0 +1,125 @@
+﻿/*! \file trialtrace.cpp
+    \brief 一部の試行の中身を全て記録するためのクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "trialtrace.h"
+#include <fstream>              // for std::ofstream
+#include <iostream>             // for std::cout
+#include <boost/format.hpp>     // for boost::format
+
+namespace checkpoint {
+    namespace {
+        //! A function.
+        /*!
+            64ビットの整数を攪拌したハッシュ値を求める（SplitMix64の最後の段）
+            \param x 整数
+            \return ハッシュ値
+        */
+        std::uint64_t mix64(std::uint64_t x);
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドのリングバッファを持っている記録クラスのオブジェクト
+        */
+        thread_local TrialTracer const * bufferowner = nullptr;
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドのリングバッファ
+        */
+        thread_local RingBuffer<TrialEvent> * currentbuffer = nullptr;
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    TrialTracer::TrialTracer(std::uint64_t every, std::size_t capacity)
+        : capacity_(capacity), every_(every)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void TrialTracer::print() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (!every_) {
+            return;
+        }
+
+        std::uint64_t trials = 0, events = 0, lost = 0;
+        for (auto const & b : buffers_) {
+            b->for_each([&trials](auto const & e) {
+                if (e.kind == TrialEventKind::BEGIN) {
+                    trials++;
+                }
+            });
+
+            events += b->size();
+            lost += b->total() - b->size();
+        }
+
+        std::cout << boost::format("試行のトレース: %d回に1回, 記録した試行 = %d回, イベント = %d個, 上書きで失われたイベント = %d個\n")
+                     % every_
+                     % trials
+                     % events
+                     % lost;
+    }
+
+    bool TrialTracer::selected(std::uint64_t trial) const
+    {
+        return every_ && !(mix64(trial) % every_);
+    }
+
+    RingBuffer<TrialEvent> & TrialTracer::this_thread_buffer()
+    {
+        if (bufferowner != this) {
+            std::lock_guard<std::mutex> lock(mtx_);
+
+            buffers_.push_back(std::make_unique<RingBuffer<TrialEvent>>(capacity_));
+            bufferowner = this;
+            currentbuffer = buffers_.back().get();
+        }
+
+        return *currentbuffer;
+    }
+
+    void TrialTracer::write(std::string const & filename) const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (!every_) {
+            return;
+        }
+
+        std::ofstream ofs(filename, std::ios::binary);
+
+        TrialTraceHeader const header = { { 'M', 'B', 'R', 'T', 'R', 'A', 'C', 'E' }, 1U, sizeof(TrialEvent), every_, buffers_.size() };
+        ofs.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+        for (auto const & b : buffers_) {
+            std::uint64_t const count = b->size();
+            std::uint64_t const lost = b->total() - count;
+            ofs.write(reinterpret_cast<char const *>(&count), sizeof(count));
+            ofs.write(reinterpret_cast<char const *>(&lost), sizeof(lost));
+
+            b->for_each([&ofs](auto const & e) { ofs.write(reinterpret_cast<char const *>(&e), sizeof(e)); });
+        }
+    }
+
+    // #endregion メンバ関数
+
+    namespace {
+        std::uint64_t mix64(std::uint64_t x)
+        {
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+    }
+}
@@ -0,0 +1,423 @@
+﻿/*! \file trialtrace.h
+    \brief 一部の試行の中身を全て記録するためのクラスの宣言
+    記録したイベントは、最後にバイナリファイルに書き出す
+
+    バイナリファイルの形式（エンディアンは実行した環境のもの）
+    ヘッダ: TrialTraceHeader
+    続いてスレッドごとに: 記録したイベントの数(std::uint64_t)、上書きで失われたイベントの数(std::uint64_t)、
+    記録したイベント(TrialEvent)を古い順に並べたもの
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TRIALTRACE_H_
+#define _TRIALTRACE_H_
+
+#pragma once
+
+#include "ringbuffer.h"
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int8_t, std::int16_t, std::int32_t, std::uint64_t
+#include <memory>               // for std::unique_ptr
+#include <mutex>                // for std::mutex
+#include <string>               // for std::string
+#include <vector>               // for std::vector
+
+namespace checkpoint {
+    //! An enumeration.
+    /*!
+        試行の中で記録するイベントの種類
+    */
+    enum class TrialEventKind : std::uint8_t {
+        BEGIN,      //!< 試行の開始
+        DRAW,       //!< 抽選（valueは引いた数字、auxは当たったマスの番号、外れなら-1）
+        LINE,       //!< 行・列の完成（valueは行・列の番号、auxはその時点で埋まっている行・列の数）
+        END         //!< 試行の終了（drawは抽選回数の合計）
+    };
+
+    //! A structure.
+    /*!
+        試行の中で起きたイベントを格納する構造体（16バイト）
+    */
+    struct TrialEvent {
+        //! A public member variable.
+        /*!
+            試行の番号
+        */
+        std::uint64_t trial;
+
+        //! A public member variable.
+        /*!
+            そのイベントが起きた抽選の回数目
+        */
+        std::int32_t draw;
+
+        //! A public member variable.
+        /*!
+            イベントの値（意味はイベントの種類による）
+        */
+        std::int16_t value;
+
+        //! A public member variable.
+        /*!
+            イベントの補助的な値（意味はイベントの種類による）
+        */
+        std::int8_t aux;
+
+        //! A public member variable.
+        /*!
+            イベントの種類
+        */
+        TrialEventKind kind;
+    };
+
+    static_assert(sizeof(TrialEvent) == 16, "TrialEvent must be 16 bytes");
+
+    //! A structure.
+    /*!
+        バイナリファイルの先頭に書き出すヘッダ
+    */
+    struct TrialTraceHeader {
+        //! A public member variable.
+        /*!
+            ファイルの識別子（"MBRTRACE"）
+        */
+        char magic[8];
+
+        //! A public member variable.
+        /*!
+            ファイルの形式の版
+        */
+        std::uint32_t version;
+
+        //! A public member variable.
+        /*!
+            TrialEventの大きさ(バイト)
+        */
+        std::uint32_t eventsize;
+
+        //! A public member variable.
+        /*!
+            何回の試行に1回記録したか
+        */
+        std::uint64_t every;
+
+        //! A public member variable.
+        /*!
+            続くスレッドごとの記録の数
+        */
+        std::uint64_t threads;
+    };
+
+    //! A class.
+    /*!
+        試行の番号から決まる、N回に1回の試行の中身を記録するクラス
+        記録はスレッドごとのリングバッファに書き込むので、書き込むときにロックは取らない
+    */
+    class TrialTracer final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param every 何回の試行に1回記録するか（0なら記録しない）
+            \param capacity スレッドごとのリングバッファの容量（イベントの数）
+        */
+        explicit TrialTracer(std::uint64_t every, std::size_t capacity = 1U << 20);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~TrialTracer() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            記録したイベントの数を表示する
+            他のスレッドが記録している最中に呼んではならない
+        */
+        void print() const;
+
+        //! A public member function.
+        /*!
+            その試行を記録するかどうかを返す
+            試行の番号のハッシュ値で決めるので、同じ番号なら実行するたびに同じ結果になる
+            \param trial 試行の番号
+            \return 記録するならtrue
+        */
+        bool selected(std::uint64_t trial) const;
+
+        //! A public member function.
+        /*!
+            呼び出したスレッドのリングバッファを返す
+            \return 呼び出したスレッドのリングバッファ
+        */
+        RingBuffer<TrialEvent> & this_thread_buffer();
+
+        //! A public member function.
+        /*!
+            記録したイベントをバイナリファイルに書き出す
+            他のスレッドが記録している最中に呼んではならない
+            \param filename ファイル名
+        */
+        void write(std::string const & filename) const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            スレッドごとのリングバッファの可変長配列
+        */
+        std::vector<std::unique_ptr<RingBuffer<TrialEvent>>> buffers_;
+
+        //! A private member variable (constant).
+        /*!
+            スレッドごとのリングバッファの容量
+        */
+        std::size_t const capacity_;
+
+        //! A private member variable (constant).
+        /*!
+            何回の試行に1回記録するか
+        */
+        std::uint64_t const every_;
+
+        //! A private member variable.
+        /*!
+            buffers_を保護するミューテックス
+        */
+        mutable std::mutex mtx_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        TrialTracer() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TrialTracer(TrialTracer const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        TrialTracer & operator=(TrialTracer const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class template.
+    /*!
+        一回の試行の中のイベントを記録するクラス
+        カーネルの先頭で生成し、抽選ごとにdraw、行・列が埋まるごとにlineを呼ぶ
+        Enabledがfalseのときは全てのメンバ関数が空になり、最適化で消える
+        \tparam Enabled 記録するかどうか
+    */
+    template <bool Enabled>
+    class TrialTrace;
+
+    //! A class (template specialization).
+    /*!
+        記録するときのTrialTrace
+    */
+    template <>
+    class TrialTrace<true> final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            試行の開始を記録する
+            \param buffer 記録するスレッドのリングバッファ（TrialTracer::this_thread_bufferで得る）
+            \param trial 試行の番号
+        */
+        TrialTrace(RingBuffer<TrialEvent> & buffer, std::uint64_t trial)
+            : buffer_(buffer), draws_(0), trial_(trial)
+        {
+            push(TrialEventKind::BEGIN, 0, 0, 0);
+        }
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            試行の終了を記録する
+        */
+        ~TrialTrace()
+        {
+            push(TrialEventKind::END, draws_, 0, 0);
+        }
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            抽選を記録する
+            \param n 何回目の抽選か
+            \param num 引いた数字
+            \param cell 当たったマスの番号（外れなら-1）
+        */
+        void draw(std::int32_t n, std::int32_t num, std::int32_t cell)
+        {
+            draws_ = n;
+            push(TrialEventKind::DRAW, n, num, cell);
+        }
+
+        //! A public member function.
+        /*!
+            行・列が埋まったことを記録する
+            \param n 何回目の抽選で埋まったか
+            \param index 行・列の番号
+            \param filled その時点で埋まっている行・列の数
+        */
+        void line(std::int32_t n, std::int32_t index, std::int32_t filled)
+        {
+            push(TrialEventKind::LINE, n, index, filled);
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            イベントを一つリングバッファに書き込む
+            \param kind イベントの種類
+            \param n 何回目の抽選か
+            \param value イベントの値
+            \param aux イベントの補助的な値
+        */
+        void push(TrialEventKind kind, std::int32_t n, std::int32_t value, std::int32_t aux)
+        {
+            buffer_.push({ trial_, n, static_cast<std::int16_t>(value), static_cast<std::int8_t>(aux), kind });
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            記録するスレッドのリングバッファ
+        */
+        RingBuffer<TrialEvent> & buffer_;
+
+        //! A private member variable.
+        /*!
+            これまでの抽選回数
+        */
+        std::int32_t draws_;
+
+        //! A private member variable (constant).
+        /*!
+            試行の番号
+        */
+        std::uint64_t const trial_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TrialTrace(TrialTrace const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        TrialTrace & operator=(TrialTrace const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class (template specialization).
+    /*!
+        記録しないときのTrialTrace（何もしない）
+    */
+    template <>
+    class TrialTrace<false> final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+        */
+        TrialTrace() = default;
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~TrialTrace() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            何もしない
+        */
+        void draw(std::int32_t, std::int32_t, std::int32_t)
+        {
+        }
+
+        //! A public member function.
+        /*!
+            何もしない
+        */
+        void line(std::int32_t, std::int32_t, std::int32_t)
+        {
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TrialTrace(TrialTrace const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        TrialTrace & operator=(TrialTrace const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _TRIALTRACE_H_
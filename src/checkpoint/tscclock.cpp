@@ -0,0 +1,140 @@
+﻿/*! \file tscclock.cpp
+    \brief タイムスタンプカウンタを使った時計クラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tscclock.h"
+
+#ifdef CHECKPOINT_HAVE_TSC
+    #ifndef _MSC_VER
+        #include <cpuid.h>          // for __get_cpuid, __get_cpuid_max
+    #endif
+#endif
+
+namespace checkpoint {
+    namespace {
+        //! A structure.
+        /*!
+            TSCの較正結果を格納する構造体
+        */
+        struct Calibration {
+            //! A public member variable.
+            /*!
+                TSCの周波数(GHz)
+            */
+            double frequency;
+
+            //! A public member variable.
+            /*!
+                TSCのカウントをナノ秒に変換する係数（2^32倍した固定小数点数）
+            */
+            std::uint64_t mult;
+
+            //! A public member variable.
+            /*!
+                TSCを使うかどうか
+            */
+            bool usetsc;
+        };
+
+        //! A global variable (constant expression).
+        /*!
+            較正にかける時間(msec)
+        */
+        static auto constexpr CALIBRATIONTIME = 5;
+
+        //! A function.
+        /*!
+            TSCを較正する（一度だけ行う）
+            \return TSCの較正結果
+        */
+        Calibration const & calibration();
+
+        //! A function.
+        /*!
+            CPUが不変TSCを持っているかどうかを調べる
+            \return CPUが不変TSCを持っているかどうか
+        */
+        bool invariant_tsc();
+    }
+
+    // #region メンバ変数
+
+    double const TscClock::frequency_ = calibration().frequency;
+
+    std::uint64_t const TscClock::mult_ = calibration().mult;
+
+    bool const TscClock::usetsc_ = calibration().usetsc;
+
+    // #endregion メンバ変数
+
+    namespace {
+        Calibration const & calibration()
+        {
+            static Calibration const c = [] {
+                Calibration cal = { 0.0, 0, false };
+
+#ifdef CHECKPOINT_HAVE_TSC
+                if (!invariant_tsc()) {
+                    return cal;
+                }
+
+                // steady_clockで一定時間待つ間にTSCがいくつ進むかを数える
+                auto const t0 = std::chrono::steady_clock::now();
+                auto const c0 = __rdtsc();
+
+                auto t1 = t0;
+                do {
+                    t1 = std::chrono::steady_clock::now();
+                } while (t1 - t0 < std::chrono::milliseconds(CALIBRATIONTIME));
+
+                auto const c1 = __rdtsc();
+
+                auto const nsec = std::chrono::duration<double, std::nano>(t1 - t0).count();
+                cal.frequency = static_cast<double>(c1 - c0) / nsec;
+
+                // 周波数が1GHzより低いと係数が32bitに収まらないので、TSCは使わない
+                if (cal.frequency > 1.0) {
+                    cal.mult = static_cast<std::uint64_t>(4294967296.0 / cal.frequency);
+                    cal.usetsc = true;
+                }
+#endif
+                return cal;
+            }();
+
+            return c;
+        }
+
+        bool invariant_tsc()
+        {
+#ifdef CHECKPOINT_HAVE_TSC
+    #ifdef _MSC_VER
+            int reg[4];
+            ::__cpuid(reg, 0x80000000);
+            if (static_cast<unsigned int>(reg[0]) < 0x80000007U) {
+                return false;
+            }
+
+            ::__cpuid(reg, 0x80000007);
+
+            // EDXのbit8が不変TSC
+            return (reg[3] & (1 << 8)) != 0;
+    #else
+            if (::__get_cpuid_max(0x80000000U, nullptr) < 0x80000007U) {
+                return false;
+            }
+
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            ::__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx);
+
+            // EDXのbit8が不変TSC
+            return (edx & (1U << 8)) != 0;
+    #endif
+#else
+            return false;
+#endif
+        }
+    }
+}
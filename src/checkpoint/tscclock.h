@@ -0,0 +1,203 @@
+﻿/*! \file tscclock.h
+    \brief タイムスタンプカウンタを使った時計クラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TSCCLOCK_H_
+#define _TSCCLOCK_H_
+
+#pragma once
+
+#include <chrono>                   // for std::chrono
+#include <cstdint>                  // for std::int64_t, std::uint64_t
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define CHECKPOINT_HAVE_TSC
+    #ifdef _MSC_VER
+        #include <intrin.h>         // for __rdtsc, __rdtscp
+    #else
+        #include <x86intrin.h>      // for __rdtsc, __rdtscp
+    #endif
+#endif
+
+namespace checkpoint {
+    //! A class.
+    /*!
+        タイムスタンプカウンタ(TSC)を使った時計クラス
+        std::chrono::steady_clockと同じように使え、時刻はナノ秒で表す
+        起動時にsteady_clockに対してTSCの周波数を較正する
+        不変TSC(invariant TSC)が使えないCPUでは、steady_clockをそのまま使う
+    */
+    class TscClock final {
+    public:
+        // #region 型エイリアス
+
+        //! A typedef.
+        /*!
+            時間の表現型
+        */
+        using rep = std::int64_t;
+
+        //! A typedef.
+        /*!
+            時間の単位
+        */
+        using period = std::nano;
+
+        //! A typedef.
+        /*!
+            時間間隔の型
+        */
+        using duration = std::chrono::duration<rep, period>;
+
+        //! A typedef.
+        /*!
+            時刻の型
+        */
+        using time_point = std::chrono::time_point<TscClock>;
+
+        //! A public static member variable (constant expression).
+        /*!
+            時刻が戻らないかどうか
+        */
+        static constexpr bool is_steady = true;
+
+        // #endregion 型エイリアス
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            現在の時刻を返す
+            \return 現在の時刻
+        */
+        static time_point now() noexcept
+        {
+#ifdef CHECKPOINT_HAVE_TSC
+            if (usetsc_) {
+                return time_point(duration(static_cast<rep>(to_nsec(__rdtsc()))));
+            }
+#endif
+            return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+        }
+
+        //! A public static member function.
+        /*!
+            それより前の命令が全て終わってから、現在の時刻を返す（rdtscpを使う）
+            計測する区間の終わりに使う
+            \return 現在の時刻
+        */
+        static time_point now_serialized() noexcept
+        {
+#ifdef CHECKPOINT_HAVE_TSC
+            if (usetsc_) {
+                unsigned int aux;
+                return time_point(duration(static_cast<rep>(to_nsec(__rdtscp(&aux)))));
+            }
+#endif
+            return now();
+        }
+
+        //! A public static member function.
+        /*!
+            ナノ秒に変換していない、生のカウントを返す
+            TSCを使っていればTSCのカウント、使っていなければsteady_clockのナノ秒
+            変換の手間を省きたい、カーネルの中の細かい計測に使う
+            \return 生のカウント
+        */
+        static std::uint64_t ticks() noexcept
+        {
+#ifdef CHECKPOINT_HAVE_TSC
+            if (usetsc_) {
+                return __rdtsc();
+            }
+#endif
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        //! A public static member function.
+        /*!
+            ticksの1ナノ秒あたりのカウントを返す
+            \return 1ナノ秒あたりのカウント
+        */
+        static double ticks_per_nsec()
+        {
+            return usetsc_ ? frequency_ : 1.0;
+        }
+
+        //! A public static member function.
+        /*!
+            較正したTSCの周波数を返す
+            \return TSCの周波数(GHz)（TSCを使っていなければ0）
+        */
+        static double frequency()
+        {
+            return frequency_;
+        }
+
+        //! A public static member function.
+        /*!
+            TSCを使っているかどうかを返す
+            \return TSCを使っているかどうか
+        */
+        static bool usetsc()
+        {
+            return usetsc_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private static member function.
+        /*!
+            TSCのカウントをナノ秒に変換する
+            \param ticks TSCのカウント
+            \return ナノ秒
+        */
+        static std::uint64_t to_nsec(std::uint64_t ticks) noexcept
+        {
+            // 64bit×32bitの固定小数点の掛け算を、オーバーフローしないように上下32bitに分けて行う
+            return (ticks >> 32) * mult_ + (((ticks & 0xFFFFFFFFULL) * mult_) >> 32);
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable.
+        /*!
+            TSCの周波数(GHz)
+        */
+        static double const frequency_;
+
+        //! A private static member variable.
+        /*!
+            TSCのカウントをナノ秒に変換する係数（2^32倍した固定小数点数）
+        */
+        static std::uint64_t const mult_;
+
+        //! A private static member variable.
+        /*!
+            TSCを使うかどうか
+        */
+        static bool const usetsc_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        TscClock() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _TSCCLOCK_H_
@@ -5,556 +5,1185 @@
     This software is released under the BSD 2-Clause License.
 */
 
+#include "../checkpoint/alloctracker.h"
 #include "../checkpoint/checkpoint.h"
+#include "../checkpoint/kernelprobe.h"
+#include "../checkpoint/latencyhistogram.h"
+#include "../checkpoint/resourcesampler.h"
+#include "../checkpoint/scopedtimer.h"
+#include "../checkpoint/trialtrace.h"
 #include "goexit/goexit.h"
-#ifdef HAVE_SSE2
-	#include "myrandom/myrandsfmt.h"
-#else
-	#include "myrandom/myrand.h"
-#endif
-#include <algorithm>                            // for std::shuffle
-#include <cstdint>                              // for std::int32_t
-#include <cmath>                                // for std::sqrt
+#include "montecarlo/geometric.h"
+#include "montecarlo/montecarlo.h"
+#include "montecarlo/tilting.h"
+#include "montecarlo/trialblock.h"
+#include "myrandom/myrandsobol.h"
+#include "progress/progressmonitor.h"
+#include "statistics/batchmeans.h"
+#include "statistics/jointhistogram.h"
+#include "statistics/levelaccumulator.h"
+#include "statistics/weightedhistogram.h"
+#include <algorithm>                            // for std::max, std::min
+#include <array>                                // for std::array
+#include <atomic>                               // for std::atomic
+#include <chrono>                               // for std::chrono::duration
+#include <cmath>                                // for std::isfinite, std::isinf, std::sqrt
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::int32_t, std::int64_t, std::uint64_t
+#include <cstdlib>                              // for EXIT_FAILURE
 #ifdef _MSC_VER
 	#include <format>                           // for std::format
 #endif
 #include <fstream>                              // for std::ofstream
+#include <iomanip>                              // for std::setprecision
 #include <iostream>                             // for std::cout
-#include <iterator>                             // for std::begin, std::ostream_iterator
-#include <map>                                  // for std::map
-#include <random>                               // for std::mt19937
-#include <unordered_map>                        // for std::unordered_map
-#include <utility>                              // for std::make_pair, std::move
+#include <limits>                               // for std::numeric_limits
+#include <optional>                             // for std::make_optional, std::nullopt, std::optional
+#include <sstream>                              // for std::ostringstream
+#include <stdexcept>                            // for std::invalid_argument
+#include <string>                               // for std::string
+#include <utility>                              // for std::pair
 #include <vector>                               // for std::vector
-#include <valarray>                             // for std::valarray
-#include <boost/algorithm/cxx11/iota.hpp>       // for boost::algorithm::iota
 #ifndef _MSC_VER
 	#include <boost/format.hpp>                 // for boost::format
 #endif
-#include <boost/range/algorithm.hpp>            // for boost::find, boost::max_element, boost::transform
-#include <tbb/concurrent_vector.h>              // for tbb::concurrent_vector
+#include <boost/program_options.hpp>           // for boost::program_options
+#include <tbb/blocked_range.h>                  // for tbb::blocked_range
+#include <tbb/enumerable_thread_specific.h>     // for tbb::enumerable_thread_specific
+#include <tbb/global_control.h>                 // for tbb::global_control
 #include <tbb/parallel_for.h>                   // for tbb::parallel_for
+#include <tbb/parallel_invoke.h>                // for tbb::parallel_invoke
+#include <tbb/parallel_reduce.h>                // for tbb::parallel_deterministic_reduce
 
 namespace {
     //! A global variable (constant expression).
     /*!
-        列のサイズ
+        終わった試行回数とメモリ使用量をカウンタとして記録する間隔
     */
-    static auto constexpr COLUMN = 5ULL;
+    static auto constexpr COUNTERINTERVAL = 1024U;
 
     //! A global variable (constant expression).
     /*!
-        行のサイズ
+        (n + 1)個目ごとに求める分位点の割合
     */
-    static auto constexpr ROW = 5ULL;
+    static std::array<double, 5> constexpr QUANTILES = { 0.05, 0.25, 0.75, 0.95, 0.99 };
 
     //! A global variable (constant expression).
     /*!
-        ビンゴボードのマス数
+        目標の精度に達したかどうかを判定する前に、最低限実行するバッチの数
     */
-    static auto constexpr BOARDSIZE = ROW * COLUMN;
+    static auto constexpr BATCHMIN = 10U;
 
     //! A global variable (constant expression).
     /*!
-        モンテカルロシミュレーションの試行回数
+        重点サンプリングで、一つのタスクにまとめる試行の数（SEEDBLOCKの倍数。重みを足し合わせる順番を決めるので、変えると結果が変わる）
     */
-    static auto constexpr MCMAX = 1000000U;
+    static auto constexpr RAREGRAINSIZE = static_cast<std::uint64_t>(1024);
+
+    // カーネルと集計関数は、ベンチマークと共有するために別のヘッダに分けてある
+    using montecarlo::BOARDSIZE;
+    using montecarlo::ROWCOLUMN;
+    using montecarlo::SEEDBLOCK;
+    using montecarlo::montecarloGeometric;
+    using montecarlo::montecarloImpl;
+    using statistics::BatchMeans;
+    using statistics::Histogram;
+    using statistics::JointHistogram;
+    using statistics::LevelAccumulator;
+    using statistics::SummarySe;
+    using statistics::WeightedHistogram;
 
-    //! A global variable (constant expression).
+    //! A typedef.
     /*!
-        行・列の総数
+        行・列とマスの、(n + 1)個目ごとの重みつきヒストグラムのstd::pair
     */
-    static auto constexpr ROWCOLUMN = ROW + COLUMN;
+    using WeightedLevels = std::pair<std::vector<WeightedHistogram>, std::vector<WeightedHistogram> >;
 
     //! A typedef.
     /*!
-        そのマスに書かれてある番号と、そのマスが当たったかどうかを示すフラグのstd::pair
+        幾何分布のカーネルの一様乱数の組を生成する、スクランブルしたSobol列の型
     */
-    using mypair = std::pair<std::int32_t, bool>;
+    using SobolPoints = myrandom::MyRandSobol<montecarlo::GEOMETRICDIM>;
 
-    //! A typedef.
+    //! An enumeration.
     /*!
-        数字と数字のstd::pair
+        一回の試行の実装の種類
     */
-    using mypair2 = std::pair<std::int32_t, std::int32_t>;
+    enum class KernelKind {
+        DRAW,           //!< 抽選を一回ずつ行う（montecarloImpl）
+        GEOMETRIC,      //!< マスが埋まる順番と幾何分布の待ち時間から作る（montecarloGeometric）
+        ANTITHETIC,     //!< GEOMETRICの試行を、対称変量と組にして二回ずつ行う
+        RQMC            //!< GEOMETRICの一様乱数の組を、バッチごとにスクランブルしたSobol列の点にする（乱択準モンテカルロ法）
+    };
+
+    //! A structure.
+    /*!
+        バッチ平均法で求めた、現在の精度を格納する構造体
+    */
+    struct Precision {
+        //! A public member variable.
+        /*!
+            全ての行・列とマスのうちで最大の、平均の標準誤差（回）
+        */
+        double se;
+
+        //! A public member variable.
+        /*!
+            全ての行・列とマスのうちで最大の、分位点の信頼区間の半値幅の、分位点に対する比
+        */
+        double rel;
+    };
 
-    //! A typedef.
+    //! A function.
     /*!
-        (n + 1)個目の行・列が埋まったときの分布を格納するためのmapの型
+        バッチごとの結果から、全ての行・列とマスのうちで最も悪い精度を求める
+        \param batches 行・列とマスの、バッチごとの結果
+        \param mcresult 行・列とマスの、全てのバッチの集計結果
+        \param p 精度を求める分位点の割合
+        \param confidence 分位点の信頼区間の信頼係数
+        \return 現在の精度
     */
-    using mymap = std::map<std::int32_t, std::int32_t>;
-    
-	//! A function.
-	/*!
-		(n + 1)個目の行・列またはマスが埋まったときの平均試行回数、埋まっているマスまたは行・列の平均個数を求める
-		\param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
-		\param size 行・列またはマスの総数
-		\return (n + 1)個目の行・列が埋まったときの平均試行回数、埋まっているマスの平均個数が格納された可変長配列のstd::pair
-	*/
-	std::pair< std::valarray<double>, std::valarray<double> > eval_average(tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::size_t size);
-
-	//! A function.
-	/*!
-		(n + 1)個目の行・列が埋まったときの中央値を求める
-		\param (n + 1)個目の数値n
-		\param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
-		\return (n + 1)個目の行・列が埋まったときの中央値
-	*/
-	std::int32_t eval_median(tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::int32_t n);
-
-	//! A function.
-	/*!
-		(n + 1)個目の行・列が埋まったときの最頻値と分布を求める
-		\param (n + 1)個目の数値n
-		\param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
-		\return (n + 1)個目の行・列が埋まったときの最頻値と分布のstd::pair
-	*/
-	std::pair<std::int32_t, std::map<std::int32_t, std::int32_t> > eval_mode(tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::int32_t n);
-
-	//! A function.
-	/*!
-		(n + 1)個目の行・列が埋まったときの標準偏差を求める
-		\param avgten (n + 1)個目の行・列が埋まったときの平均試行回数
-		\param (n + 1)個目の数値n
-		\param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
-		\return (n + 1)個目の行・列が埋まったときの標準偏差
-	*/
-	double eval_std_deviation(double avg, tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::int32_t n);
+    Precision eval_precision(std::pair<BatchMeans, BatchMeans> const & batches, std::pair<LevelAccumulator, LevelAccumulator> const & mcresult, double p, double confidence);
 
     //! A function.
     /*!
-        ビンゴボードを生成する
-        \return ビンゴボードが格納された可変長配列
+        [begin, end)の番号の試行のモンテカルロ・シミュレーションをTBBで並列化して行う
+        試行の結果は保持せず、スレッドごとのヒストグラムに逐次加えるので、試行回数によらずメモリ使用量は一定になる
+        \param begin 最初の試行の番号（KernelKind::RQMC以外ならSEEDBLOCKの倍数）
+        \param end 最後の試行の次の番号（KernelKind::ANTITHETICなら偶数）
+        \param kernel 一回の試行の実装の種類（KernelKind::DRAWのときだけ、一回の試行の中身を記録できる）
+        \param latency 試行ごとの所要時間を集計した結果を格納する変数
+        \param monitor 進捗と稼働状況を集計するオブジェクト
+        \param tracer 一部の試行の中身を記録するオブジェクト
+        \param seed 乱数のシード（指定されていれば、SEEDBLOCK個の試行のブロックごとに(seed, ブロックの番号)で乱数を初期化する）
+        \param sobol KernelKind::RQMCのとき、このバッチのSobol列（(試行の番号 - begin)番目の点を使う）
+        \return 行・列とマスの、(n + 1)個目ごとの集計結果のstd::pair
     */
-    auto makeboard();
+    std::pair<LevelAccumulator, LevelAccumulator> montecarloTBB(std::uint64_t begin, std::uint64_t end, KernelKind kernel, checkpoint::LatencyHistogram & latency, progress::ProgressMonitor & monitor, checkpoint::TrialTracer & tracer, std::optional<std::uint64_t> seed, SobolPoints const * sobol);
 
-#ifdef _CHECK_PARALELL_PERFORM
     //! A function.
     /*!
-        モンテカルロ・シミュレーションを行う
-        \return モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        [begin, end)の番号の試行を、待ち時間の分布を傾けた重点サンプリングで行い、重みつきヒストグラムに加える
+        重みを足し合わせる順番がスレッド数によらず同じになるように、tbb::parallel_deterministic_reduceで並列化する
+        \param begin 最初の試行の番号（SEEDBLOCKの倍数）
+        \param end 最後の試行の次の番号
+        \param tilting 待ち時間の分布を傾けた試行を生成するオブジェクト
+        \param seed 乱数のシード（指定されていれば、SEEDBLOCK個の試行のブロックごとに(seed, ブロックの番号)で乱数を初期化する）
+        \return 行・列とマスの、(n + 1)個目ごとの重みつきヒストグラムのstd::pair
     */
-	std::pair<std::vector< std::vector<mypair2> >, std::vector< std::vector<mypair2> > > montecarlo();
-#endif
+    WeightedLevels montecarloRare(std::uint64_t begin, std::uint64_t end, montecarlo::ExponentialTilting const & tilting, std::optional<std::uint64_t> seed);
 
     //! A function.
     /*!
-        モンテカルロ・シミュレーションの実装
-        \param mr 自作乱数クラスのオブジェクト
-        \return モンテカルロ法の結果が格納された可変長配列
+        重点サンプリングで推定した、抽選回数が指定された回数以下（θ > 0なら以上）になる確率を表示する文字列を作る
+        (n + 1)個目ごとの重みつきの分布は、csvファイルに出力する
+        \param result 行・列とマスの重みつきヒストグラム
+        \param tilting 待ち時間の分布を傾けた試行を生成するオブジェクト
+        \param draws 抽選回数
+        \param confidence 信頼区間の信頼係数
+        \return 表示する文字列
     */
-	template <typename MyRandom>
-	std::pair<std::vector<mypair2>, std::vector<mypair2> > montecarloImpl(MyRandom & mr);
+    std::string rare_event_report(WeightedLevels const & result, montecarlo::ExponentialTilting const & tilting, std::int32_t draws, double confidence);
 
     //! A function.
     /*!
-        モンテカルロ・シミュレーションをTBBで並列化して行う
-        \return モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        乱択準モンテカルロ法の平均試行回数と、独立な複製の間のばらつきから求めた標準誤差を表示する文字列を作る
+        同じ試行回数の単純なモンテカルロ法の標準誤差（標本標準偏差 / √試行回数）と比べた分散減少率も表示する
+        \param batches 行・列とマスの、複製ごとの結果
+        \param mcresult 行・列とマスの、全ての複製の集計結果
+        \param points 一つの複製の点の数
+        \return 表示する文字列
     */
-	std::pair<tbb::concurrent_vector< std::vector<mypair2> >, tbb::concurrent_vector< std::vector<mypair2> > > montecarloTBB();
+    std::string rqmc_report(std::pair<BatchMeans, BatchMeans> const & batches, std::pair<LevelAccumulator, LevelAccumulator> const & mcresult, std::uint64_t points);
+
+    //! A function.
+    /*!
+        平均試行回数の、制御変量法と対称変量法による推定値と分散減少率を表示する文字列を作る
+        行・列では、(n + 1)個目の行・列が埋まったときのマスの数mについて、試行回数 - E[T_m]を制御変量にする
+        （T_mはm個のマスが埋まるまでの抽選回数で、その期待値はクーポンコレクター問題の値）
+        マスでは、(n + 1)個目のマスが埋まるまでの抽選回数そのものがT_(n + 1)なので、平均は厳密に求まる
+        \param mcresult 行・列とマスの集計結果
+        \param controlvariates 制御変量法の推定値を表示するかどうか
+        \return 表示する文字列
+    */
+    std::string variance_reduction_report(std::pair<LevelAccumulator, LevelAccumulator> const & mcresult, bool controlvariates);
 
     //! A function.
     /*!
         (n + 1)個目の行・列が埋まったときの分布をcsvファイルに出力する
-		\param distmap (n + 1)個目の行・列が埋まったときの分布
+		\param hist (n + 1)個目の行・列が埋まったときの試行回数のヒストグラム
 		\param filename ファイル名
     */
-    void outputcsv(mymap const & distmap, std::string const & filename);
+    void outputcsv(Histogram const & hist, std::string const & filename);
+
+    //! A function.
+    /*!
+        (n + 1)個目ごとの平均、中央値、最頻値、標準偏差、分位点と、平均と分位点の信頼区間と、平均、中央値、最頻値、標準偏差の標準誤差をcsvファイルに出力する
+        \param hists (n + 1)個目ごとの試行回数のヒストグラム
+        \param se (n + 1)個目ごとの統計量の標準誤差
+        \param confidence 信頼係数
+        \param filename ファイル名
+    */
+    void outputsummarycsv(std::vector<Histogram> const & hists, SummarySe const & se, double confidence, std::string const & filename);
+
+    //! A function.
+    /*!
+        (n + 1)個目ごとの、試行回数と埋まっている数の同時分布を、度数が0でない組だけcsvファイルに出力する
+        \param joints (n + 1)個目ごとの同時分布
+        \param column 埋まっている数の列の名称
+        \param filename ファイル名
+        \return 出力した組の数
+    */
+    std::size_t outputjointcsv(std::vector<JointHistogram> const & joints, char const * column, std::string const & filename);
+
+    //! A function.
+    /*!
+        標準誤差を表示する文字列を作る
+        \param se 標準誤差（有限でなければ、求めていないものとしてn/aにする）
+        \param precision 小数点以下の桁数
+        \return 表示する文字列
+    */
+    std::string se_string(double se, std::int32_t precision);
+
+    //! A function.
+    /*!
+        標準誤差を求めていないことを表す（全ての値がNaNの）構造体を作る
+        \param size 行・列またはマスの総数
+        \return 全ての値がNaNの構造体
+    */
+    SummarySe unavailable_se(std::size_t size);
+
+    //! A function.
+    /*!
+        平均と分位点を、信頼区間とともに表示する文字列を作る
+        \param hist 試行回数のヒストグラム
+        \param confidence 信頼係数
+        \return 表示する文字列
+    */
+    std::string quantile_report(Histogram const & hist, double confidence);
+
+    //! A function template.
+    /*!
+        (n + 1)個目ごとに、分布をcsvファイルに出力し、表示する文字列を作る処理を並列に行う
+        \param hists (n + 1)個目ごとの試行回数のヒストグラム
+        \param se (n + 1)個目ごとの統計量の標準誤差
+        \param csvname csvファイル名の接頭辞
+        \param confidence 平均と分位点の信頼区間の信頼係数
+        \param format (n, ヒストグラム)から表示する文字列を作る関数オブジェクト
+        \return (n + 1)の順に並べた表示する文字列の可変長配列
+    */
+    template <typename Format>
+    std::vector<std::string> summarize(std::vector<Histogram> const & hists, SummarySe const & se, char const * csvname, double confidence, Format format);
 }
 
-int main()
+int main(int argc, char * argv[])
 {
+    namespace po = boost::program_options;
+
+    // コマンドラインオプションの定義
+    po::options_description desc("オプション");
+    desc.add_options()
+        ("help,h", "ヘルプを表示する")
+        ("no-alloc-assert", "drawのカーネルの抽選のループでメモリを確保したら異常終了する（ボードと結果の可変長配列の確保と、結果の集約は対象外。_CHECK_ALLOCATIONを定義してビルドしたときのみ有効）")
+        ("progress-interval", po::value<double>()->default_value(1.0), "並列化したシミュレーションの進捗を標準エラー出力に表示する間隔(秒)（0なら表示しない）")
+        ("trials", po::value<std::uint64_t>()->default_value(1000000), "モンテカルロ・シミュレーションの試行回数（目標の精度を指定したときは最大の試行回数）")
+        ("batch-trials", po::value<std::uint64_t>()->default_value(10000), "一つのバッチの試行回数（バッチごとに精度を求め、目標に達したら止める。乱数列のブロックの大きさ（256回）の倍数に切り上げる）")
+        ("target-se", po::value<double>()->default_value(0.0), "全ての行・列とマスの平均の標準誤差の目標(回)（0なら指定しない）")
+        ("target-quantile-rel", po::value<double>()->default_value(0.0), "全ての行・列とマスの分位点の信頼区間の半値幅の、分位点に対する比の目標（0.001なら0.1%、0なら指定しない）")
+        ("target-quantile", po::value<double>()->default_value(0.95), "target-quantile-relで精度を求める分位点の割合（0より大きく1より小さい）")
+        ("kernel", po::value<std::string>()->default_value("draw"), "一回の試行の実装（draw: 抽選を一回ずつ行う、geometric: マスが埋まる順番と幾何分布の待ち時間から作る、rqmc: geometricの一様乱数をスクランブルしたSobol列にする）")
+        ("rqmc-points", po::value<std::uint64_t>()->default_value(16384), "rqmcで、独立にスクランブルした一つの複製の点の数（バッチの試行回数になる。2のべき乗が望ましい）")
+        ("antithetic", "geometricの試行を、全ての一様乱数uを1 - uにした対称変量と組にして行い、分散減少率を表示する")
+        ("control-variates", "平均試行回数の、制御変量法による推定値と分散減少率を表示する")
+        ("rare-draws", po::value<std::int32_t>(), "抽選回数がこの回数以下（全てのマスが埋まる平均試行回数より大きければ以上）になる確率を、重点サンプリングで推定する。全てのマスが埋まる平均試行回数がこの回数になるように傾けるので、マスの数より大きくする。それより前の行・列やマスの確率も同じ傾きで推定するので、有効試行回数が少なくなることがある")
+        ("rare-trials", po::value<std::uint64_t>()->default_value(1000000), "重点サンプリングの試行回数")
+        ("confidence", po::value<double>()->default_value(0.95), "平均と分位点の信頼区間の信頼係数")
+        ("bootstrap", po::value<std::uint64_t>()->default_value(200), "中央値と最頻値の標準誤差を求める、バッチのブートストラップ法の復元抽出の回数（2未満なら求めず、n/aと表示する）")
+        ("seed", po::value<std::uint64_t>(), "乱数のシード（指定すると、スレッド数によらず同じ集計結果になる。指定しなければランダムデバイスから得る）")
+        ("threads", po::value<std::int32_t>()->default_value(0), "シミュレーションと集計に使うスレッド数の上限（0ならTBBの既定値）")
+        ("sample-interval", po::value<std::int32_t>()->default_value(0), "メモリ使用量とCPU時間を記録する間隔(ミリ秒)（0なら記録しない）")
+        ("trace", po::value<std::string>(), "計測結果をトレースイベント形式のJSONで出力するファイル名")
+        ("trace-trials", po::value<std::uint64_t>()->default_value(0), "N回に1回の試行の中身（抽選の列、マスと行・列が埋まった回数）を全て記録し、result/trial_trace.binに出力する（0なら記録しない）");
+
+    // コマンドラインオプションを解析
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (po::error const & e) {
+        std::cerr << e.what() << '\n' << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc;
+
+        return 0;
+    }
+
+    // 一回の試行の実装
+    auto const kernelname = vm["kernel"].as<std::string>();
+    if (kernelname != "draw" && kernelname != "geometric" && kernelname != "rqmc") {
+        std::cerr << "不明な試行の実装です: " << kernelname << '\n' << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    auto const antithetic = vm.count("antithetic") > 0;
+    if (antithetic && kernelname != "geometric") {
+        std::cerr << "antitheticはkernelがgeometricのときだけ指定できます\n" << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    auto const kernel = antithetic ? KernelKind::ANTITHETIC
+                      : kernelname == "geometric" ? KernelKind::GEOMETRIC
+                      : kernelname == "rqmc" ? KernelKind::RQMC
+                      : KernelKind::DRAW;
+
+    // 重点サンプリングで裾の確率を推定するなら、全てのマスが埋まる平均試行回数がその抽選回数になるように、待ち時間の分布を傾ける
+    std::optional<montecarlo::ExponentialTilting> tilting;
+    if (vm.count("rare-draws")) {
+        try {
+            tilting.emplace(montecarlo::ExponentialTilting::solve(static_cast<double>(vm["rare-draws"].as<std::int32_t>())));
+        }
+        catch (std::invalid_argument const & e) {
+            std::cerr << e.what() << '\n' << desc;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    // 試行回数（目標の精度を指定したときは最大の試行回数）と、一つのバッチの試行回数
+    // 対称変量法では二回ずつ試行するので、どちらも偶数に切り上げる
+    auto trials = vm["trials"].as<std::uint64_t>();
+    auto batchtrials = vm["batch-trials"].as<std::uint64_t>();
+    if (!trials || !batchtrials) {
+        std::cerr << "試行回数は1以上にしてください\n" << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    // 信頼係数は、正規分布の臨界値が求まる範囲でなければならない
+    if (auto const confidence = vm["confidence"].as<double>(); !(confidence > 0.0 && confidence < 1.0)) {
+        std::cerr << "confidenceは0より大きく1より小さくしてください\n" << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    if (antithetic) {
+        trials += trials % 2;
+        batchtrials += batchtrials % 2;
+    }
+
+    // 乱数は試行の番号のブロックごとに初期化するので、バッチの境界がブロックの境界になるように、SEEDBLOCKの倍数に切り上げる
+    // （ブロックの途中でバッチを分けると、次のバッチでそのブロックの乱数列を最初から使い直してしまう）
+    batchtrials = (batchtrials + SEEDBLOCK - 1) / SEEDBLOCK * SEEDBLOCK;
+
+    // 乱択準モンテカルロ法では、一つのバッチを一つの複製にするので、試行回数を複製の点の数の倍数に切り上げる
+    // バッチ平均法の標準誤差が、そのまま独立な複製の間のばらつきから求めた標準誤差になる
+    if (kernel == KernelKind::RQMC) {
+        batchtrials = vm["rqmc-points"].as<std::uint64_t>();
+        if (!batchtrials || batchtrials > (static_cast<std::uint64_t>(1) << myrandom::SOBOLBITS)) {
+            std::cerr << "rqmc-pointsは1以上2^32以下にしてください\n" << desc;
+
+            return EXIT_FAILURE;
+        }
+
+        trials = (trials + batchtrials - 1) / batchtrials * batchtrials;
+    }
+
+    // 目標の精度
+    auto const targetse = vm["target-se"].as<double>();
+    auto const targetrel = vm["target-quantile-rel"].as<double>();
+    auto const targetp = vm["target-quantile"].as<double>();
+    auto const adaptive = targetse > 0.0 || targetrel > 0.0;
+    if (!(targetp > 0.0 && targetp < 1.0)) {
+        std::cerr << "target-quantileは0より大きく1より小さくしてください\n" << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    checkpoint::set_strict_no_allocation(vm.count("no-alloc-assert") > 0);
+
+    // スレッド数の上限を設定する
+    std::optional<tbb::global_control> threadlimit;
+    if (auto const threads = vm["threads"].as<std::int32_t>(); threads > 0) {
+        threadlimit.emplace(tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(threads));
+    }
+
+    // シードが指定されていれば、試行の番号から乱数列を決める
+    auto const seed = vm.count("seed") ? std::make_optional(vm["seed"].as<std::uint64_t>()) : std::nullopt;
+
     checkpoint::CheckPoint cp;
 
     cp.checkpoint("処理開始", __LINE__);
 
-#ifdef _CHECK_PARALELL_PERFORM
-    // モンテカルロ・シミュレーションの結果を代入
-    auto const mcresult(montecarlo());
+    // メモリ使用量とCPU時間を、一定間隔で別のスレッドで記録する
+    checkpoint::ResourceSampler sampler(std::chrono::milliseconds(vm["sample-interval"].as<std::int32_t>()));
+
+    // 試行ごとの所要時間の集計結果
+    checkpoint::LatencyHistogram latency;
+
+    // 並列化したシミュレーションの進捗と稼働状況を集計する
+    progress::ProgressMonitor monitor(
+        trials,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>(vm["progress-interval"].as<double>())));
+    cp.add_report([&monitor] { monitor.print(); });
+
+    // カーネルの中の計測結果（_CHECK_KERNEL_PERFORMを定義してビルドしたときのみ）
+    cp.add_report([] {
+        checkpoint::print_kernel_probe(
+            { "乱数の生成", "無駄な抽選", "ビンゴボードの探索", "行・列の判定", "行・列の完成" },
+            { "ビンゴボードの生成", "乱数の生成", "ビンゴボードの探索", "行・列の判定", "結果の記録" });
+    });
+
+    // 試行の番号で選んだ一部の試行の中身を記録する
+    checkpoint::TrialTracer tracer(vm["trace-trials"].as<std::uint64_t>());
+    cp.add_report([&tracer] { tracer.print(); });
+
+    auto const confidence = vm["confidence"].as<double>();
+
+    // TBBで並列化したモンテカルロ・シミュレーションを、バッチごとに実行して結果を足し合わせる
+    // 試行の番号はバッチをまたいで通し番号にするので、シードが指定されていれば、バッチの分け方によらず同じ結果になる
+    auto mcresult2 = std::make_pair(LevelAccumulator(ROWCOLUMN), LevelAccumulator(BOARDSIZE));
+    std::pair<BatchMeans, BatchMeans> batches(ROWCOLUMN, BOARDSIZE);
+    std::uint64_t done = 0;
+    auto converged = false;
+    Precision precision = {};
+    while (done < trials && !converged) {
+        auto const end = std::min(trials, done + batchtrials);
+
+        // 乱択準モンテカルロ法では、バッチの番号でSobol列をスクランブルする
+        std::optional<SobolPoints> sobol;
+        if (kernel == KernelKind::RQMC) {
+            if (seed) {
+                sobol.emplace(*seed, done / batchtrials);
+            }
+            else {
+                sobol.emplace();
+            }
+        }
 
-    cp.checkpoint("並列化無効", __LINE__);
-#endif      
-	
-    // TBBで並列化したモンテカルロ・シミュレーションの結果を代入
-    auto const mcresult2(montecarloTBB());
+        auto const batch = montecarloTBB(done, end, kernel, latency, monitor, tracer, seed, sobol ? &*sobol : nullptr);
 
-    cp.checkpoint("並列化有効", __LINE__);
+        mcresult2.first.merge(batch.first);
+        mcresult2.second.merge(batch.second);
+        batches.first.add(batch.first);
+        batches.second.add(batch.second);
+        done = end;
 
-    auto const [trialavg, fillavg] = eval_average(mcresult2.first, ROWCOLUMN);
+        // 目標の精度が指定されていれば、バッチ平均法で求めた精度が目標に達したところで止める
+        if (adaptive && batches.first.batches() >= BATCHMIN) {
+            precision = eval_precision(batches, mcresult2, targetp, confidence);
+            converged = (targetse <= 0.0 || precision.se < targetse) && (targetrel <= 0.0 || precision.rel < targetrel);
+        }
+    }
 
-    for (auto n = 0U; n < ROWCOLUMN; n++) {
-		auto const [mode, distmap] = eval_mode(mcresult2.first, n);
-#ifdef _MSC_VER
-		outputcsv(distmap, std::format("result/distribution_{:d}個目.csv", n + 1));
+    monitor.stop();
 
-        std::cout 
-			<< std::format("ビンゴ{:d}個目に必要な平均試行回数：{:.1f}回, 効率：{:.1f}(回/個), ", n + 1, trialavg[n], trialavg[n] / static_cast<double>(n + 1))
-			<< std::format("中央値：{:d}回, 最頻値：{:d}回, 標準偏差：{:.1f}, ", eval_median(mcresult2.first, n), mode, eval_std_deviation(trialavg[n], mcresult2.first, n))
-			<< std::format("埋まっているマスの平均個数：{:.1f}個\n", fillavg[n]);
+    cp.checkpoint("並列化有効", __LINE__, static_cast<std::int64_t>(done));
+
+    if (adaptive) {
+        if (batches.first.batches() < BATCHMIN) {
+            precision = eval_precision(batches, mcresult2, targetp, confidence);
+        }
+
+#ifdef _MSC_VER
+        std::cout << std::format("試行回数：{:d}回（{:d}バッチ）, 平均の標準誤差の最大：{:.4f}回, P{:g}の相対半値幅の最大：{:.4f}%, {:s}\n",
+                                 done, batches.first.batches(), precision.se, targetp * 100.0, precision.rel * 100.0, converged ? "目標の精度に達しました" : "目標の精度に達する前に最大の試行回数に達しました");
 #else
-        outputcsv(distmap, (boost::format("result/distribution_%d個目.csv") % (n + 1)).str());
-
-        std::cout
-            << boost::format("ビンゴ%d個目に必要な平均試行回数：%.1f回, 効率：%.1f(回/個), ")
-            % (n + 1)
-            % trialavg[n]
-            % (trialavg[n] / static_cast<double>(n + 1))
-            << boost::format("中央値：%d回, 最頻値：%d回, 標準偏差：%.1f, ")
-            % eval_median(mcresult2.first, n)
-            % mode
-            % eval_std_deviation(trialavg[n], mcresult2.first, n)
-            << boost::format("埋まっているマスの平均個数：%.1f個\n")
-            % fillavg[n];
+        std::cout << boost::format("試行回数：%d回（%dバッチ）, 平均の標準誤差の最大：%.4f回, P%gの相対半値幅の最大：%.4f%%, %s\n")
+                     % done
+                     % batches.first.batches()
+                     % precision.se
+                     % (targetp * 100.0)
+                     % (precision.rel * 100.0)
+                     % (converged ? "目標の精度に達しました" : "目標の精度に達する前に最大の試行回数に達しました");
 #endif
     }
 
-	auto const [trialavg2, fillavg2] = eval_average(mcresult2.second, BOARDSIZE);
+    // 行・列の集計とマスの集計を並列に行う
+    // それぞれの中でも、(n + 1)個目ごとの集計とcsvファイルへの出力を並列に行い、
+    // 表示する文字列は(n + 1)の順に並べておく
+    // 表示する統計量の標準誤差は、バッチごとのヒストグラムから、バッチ平均法とブートストラップ法で求める
+    // （効率の標準誤差は、平均の標準誤差を(n + 1)で割ったものになる）
+    // バッチがBATCHMIN個未満では、標準誤差の推定値そのもののばらつきが大きすぎるので、求めずにn/aとする
+    auto const bootstrap = static_cast<std::size_t>(vm["bootstrap"].as<std::uint64_t>());
+    auto const bootstrapseed = seed.value_or(0);
+
+    // 試行回数と埋まっている数の同時分布は、度数が0でない組だけを出力する
+    std::vector<std::string> linereport, cellreport;
+    std::size_t linejoints = 0, celljoints = 0;
+    tbb::parallel_invoke(
+        [&means = batches.first, bootstrap, bootstrapseed, confidence, &linejoints, &linereport, &acc = mcresult2.first] {
+        linejoints = outputjointcsv(acc.joint(), "filled_cells", "result/joint_distribution.csv");
+
+        auto const fillavg = acc.fillavg();
+        auto const se = means.batches() >= BATCHMIN ? means.summary_se(bootstrap, bootstrapseed) : unavailable_se(acc.joint().size());
+
+        linereport = summarize(acc.histograms(), se, "distribution", confidence, [&fillavg, &se](auto n, auto const & hist) {
+            auto const trialavg = hist.mean();
+            auto const level = static_cast<double>(n + 1);
+#ifdef _MSC_VER
+            return std::format("ビンゴ{:d}個目に必要な平均試行回数：{:.1f} ± {:s}回, 効率：{:.1f} ± {:s}(回/個), ", n + 1, trialavg, se_string(se.mean[n], 3), trialavg / level, se_string(se.mean[n] / level, 3))
+                 + std::format("中央値：{:d} ± {:s}回, 最頻値：{:d} ± {:s}回, 標準偏差：{:.1f} ± {:s}, ", hist.median(), se_string(se.median[n], 1), hist.mode(), se_string(se.mode[n], 1), hist.std_deviation(), se_string(se.std_deviation[n], 3))
+                 + std::format("埋まっているマスの平均個数：{:.1f} ± {:s}個\n", fillavg[n], se_string(se.fillavg[n], 3));
+#else
+            return (boost::format("ビンゴ%d個目に必要な平均試行回数：%.1f ± %s回, 効率：%.1f ± %s(回/個), ")
+                    % (n + 1)
+                    % trialavg
+                    % se_string(se.mean[n], 3)
+                    % (trialavg / level)
+                    % se_string(se.mean[n] / level, 3)).str()
+                 + (boost::format("中央値：%d ± %s回, 最頻値：%d ± %s回, 標準偏差：%.1f ± %s, ")
+                    % hist.median()
+                    % se_string(se.median[n], 1)
+                    % hist.mode()
+                    % se_string(se.mode[n], 1)
+                    % hist.std_deviation()
+                    % se_string(se.std_deviation[n], 3)).str()
+                 + (boost::format("埋まっているマスの平均個数：%.1f ± %s個\n")
+                    % fillavg[n]
+                    % se_string(se.fillavg[n], 3)).str();
+#endif
+        });
+    },
+        [&means = batches.second, bootstrap, bootstrapseed, confidence, &celljoints, &cellreport, &acc = mcresult2.second] {
+        celljoints = outputjointcsv(acc.joint(), "filled_lines", "result/joint_distribution2.csv");
+
+        auto const fillavg = acc.fillavg();
+        auto const se = means.batches() >= BATCHMIN ? means.summary_se(bootstrap, bootstrapseed) : unavailable_se(acc.joint().size());
 
-	for (auto n = 0U; n < BOARDSIZE; n++) {
-		auto const [mode, distmap] = eval_mode(mcresult2.second, n);
+        cellreport = summarize(acc.histograms(), se, "distribution2", confidence, [&fillavg, &se](auto n, auto const & hist) {
+            auto const trialavg = hist.mean();
+            auto const level = static_cast<double>(n + 1);
 #ifdef _MSC_VER
-        outputcsv(distmap, std::format("result/distribution2_{:d}個目.csv", n + 1));
+            return std::format("{:d}個目のマスに必要な平均試行回数：{:.1f} ± {:s}回, 効率：{:.1f} ± {:s}(回/個), ", n + 1, trialavg, se_string(se.mean[n], 3), trialavg / level, se_string(se.mean[n] / level, 3))
+                 + std::format("中央値：{:d} ± {:s}回, 最頻値：{:d} ± {:s}回, 標準偏差：{:.1f} ± {:s}, ", hist.median(), se_string(se.median[n], 1), hist.mode(), se_string(se.mode[n], 1), hist.std_deviation(), se_string(se.std_deviation[n], 3))
+                 + std::format("埋まっている行・列の平均個数：{:.1f} ± {:s}個\n", fillavg[n], se_string(se.fillavg[n], 3));
+#else
+            return (boost::format("%d個目のマスに必要な平均試行回数：%.1f ± %s回, 効率：%.1f ± %s(回/個), ")
+                    % (n + 1)
+                    % trialavg
+                    % se_string(se.mean[n], 3)
+                    % (trialavg / level)
+                    % se_string(se.mean[n] / level, 3)).str()
+                 + (boost::format("中央値：%d ± %s回, 最頻値：%d ± %s回, 標準偏差：%.1f ± %s, ")
+                    % hist.median()
+                    % se_string(se.median[n], 1)
+                    % hist.mode()
+                    % se_string(se.mode[n], 1)
+                    % hist.std_deviation()
+                    % se_string(se.std_deviation[n], 3)).str()
+                 + (boost::format("埋まっている行・列の平均個数：%.1f ± %s個\n")
+                    % fillavg[n]
+                    % se_string(se.fillavg[n], 3)).str();
+#endif
+        });
+    });
+
+    cp.checkpoint("行・列とマスの集計", __LINE__);
+
+    if (batches.first.batches() < BATCHMIN) {
+#ifdef _MSC_VER
+        std::cout << std::format("バッチが{:d}個（{:d}個未満）なので、標準誤差は求めません（n/a）。batch-trialsを小さくしてください\n", batches.first.batches(), BATCHMIN);
+#else
+        std::cout << boost::format("バッチが%d個（%d個未満）なので、標準誤差は求めません（n/a）。batch-trialsを小さくしてください\n") % batches.first.batches() % BATCHMIN;
+#endif
+    }
 
-        std::cout
-            << std::format("{:d}個目のマスに必要な平均試行回数：{:.1f}回, 効率：{:.1f}(回/個), ", n + 1, trialavg2[n], trialavg2[n] / static_cast<double>(n + 1))
-            << std::format("中央値：{:d}回, 最頻値：{:d}回, 標準偏差：{:.1f}, ", eval_median(mcresult2.second, n), mode, eval_std_deviation(trialavg2[n], mcresult2.second, n))
-            << std::format("埋まっている行・列の平均個数：{:.1f}個\n", fillavg2[n]);
+    for (auto const & line : linereport) {
+        std::cout << line;
+    }
+
+    for (auto const & line : cellreport) {
+        std::cout << line;
+    }
+
+#ifdef _MSC_VER
+    std::cout << std::format("試行回数と埋まっている数の同時分布：行・列 {:d}組, マス {:d}組（度数が0でない組）\n", linejoints, celljoints);
 #else
-		outputcsv(distmap, (boost::format("result/distribution2_%d個目.csv") % (n + 1)).str());
-
-		std::cout
-			<< boost::format("%d個目のマスに必要な平均試行回数：%.1f回, 効率：%.1f(回/個), ")
-			% (n + 1)
-			% trialavg2[n]
-			% (trialavg2[n] / static_cast<double>(n + 1))
-			<< boost::format("中央値：%d回, 最頻値：%d回, 標準偏差：%.1f, ")
-			% eval_median(mcresult2.second, n)
-			% mode
-			% eval_std_deviation(trialavg2[n], mcresult2.second, n)
-			<< boost::format("埋まっている行・列の平均個数：%.1f個\n")
-			% fillavg2[n];
+    std::cout << boost::format("試行回数と埋まっている数の同時分布：行・列 %d組, マス %d組（度数が0でない組）\n") % linejoints % celljoints;
 #endif
-	}
 
-    cp.checkpoint("それ以外の処理", __LINE__);
+    if (antithetic || vm.count("control-variates")) {
+        std::cout << variance_reduction_report(mcresult2, vm.count("control-variates") > 0);
+    }
+
+    if (kernel == KernelKind::RQMC) {
+        std::cout << rqmc_report(batches, mcresult2, batchtrials);
+    }
+
+    cp.checkpoint("集計結果の表示", __LINE__);
+
+    if (tilting) {
+        // 試行の番号は、通常のシミュレーションの試行の続きの、次のブロックの先頭からにする
+        auto const rarebegin = (done + SEEDBLOCK - 1) / SEEDBLOCK * SEEDBLOCK;
+        auto const rareresult = montecarloRare(rarebegin, rarebegin + vm["rare-trials"].as<std::uint64_t>(), *tilting, seed);
+
+        cp.checkpoint("重点サンプリング", __LINE__, static_cast<std::int64_t>(vm["rare-trials"].as<std::uint64_t>()));
+
+        std::cout << rare_event_report(rareresult, *tilting, vm["rare-draws"].as<std::int32_t>(), confidence);
+    }
+
+    sampler.stop();
+    cp.add_report([&cp, &sampler] { sampler.print(cp.marks()); });
 
     cp.checkpoint_print();
 
+    latency.print();
+    latency.outputcsv("result/trial_latency.csv");
+    sampler.outputcsv(cp.marks(), "result/resource_samples.csv");
+    tracer.write("result/trial_trace.bin");
+
+    checkpoint::usedmem();
+
+    if (vm.count("trace")) {
+        cp.output_chrome_trace(vm["trace"].as<std::string>());
+    }
+
 	goexit::goexit();
 
     return 0;
 }
 
 namespace {
-    std::pair< std::valarray<double>, std::valarray<double> > eval_average(tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::size_t size)
+    Precision eval_precision(std::pair<BatchMeans, BatchMeans> const & batches, std::pair<LevelAccumulator, LevelAccumulator> const & mcresult, double p, double confidence)
     {
-        // モンテカルロ・シミュレーションの平均試行回数の結果を格納した可変長配列
-        std::valarray<double> trialavg(size);
-
-        // モンテカルロ・シミュレーションのn回目の試行で、埋まっているマスの数を格納した可変長配列
-        std::valarray<double> fillavg(size);
-
-        // 行・列の総数分繰り返す
-        for (auto n = 0U; n < size; n++) {
-            // 総和を0で初期化
-            auto trialsum = 0;
-            auto fillsum = 0;
-
-            // 試行回数分繰り返す
-            for (auto j = 0U; j < MCMAX; j++) {
-                // j回目の結果を加える
-                trialsum += mcresult[j][n].first;
-                fillsum += mcresult[j][n].second;
+        Precision precision = { 0.0, 0.0 };
+        auto const z = statistics::normal_critical_value(confidence);
+
+        auto const update = [&precision, p, z](BatchMeans const & b, LevelAccumulator const & acc) {
+            for (auto const se : b.mean_se()) {
+                precision.se = std::max(precision.se, se);
             }
 
-            // 平均を算出してn行・列目のtrialavg、fillavgに代入
-            trialavg[n] = static_cast<double>(trialsum) / static_cast<double>(MCMAX);
-            fillavg[n] = static_cast<double>(fillsum) / static_cast<double>(MCMAX);
-        }
+            auto const qse = b.quantile_se(p);
+            auto const hists = acc.histograms();
+            for (auto n = 0U; n < qse.size(); n++) {
+                precision.rel = std::max(precision.rel, z * qse[n] / static_cast<double>(std::max(hists[n].quantile(p), 1)));
+            }
+        };
 
-        return std::make_pair(std::move(trialavg), std::move(fillavg));
-    }
-
-	std::int32_t eval_median(tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::int32_t n)
-	{
-		// 中央値を求めるために必要な可変長配列
-		std::vector<std::int32_t> medtmp(MCMAX);
-
-		// 中央値を求めるために必要な可変長配列を、モンテカルロ法の結果から生成
-		boost::transform(
-			mcresult,
-			medtmp.begin(),
-			[n](auto const & res) { return res[n].first; });
-
-		// 中央値を求めるためにソートする
-		boost::sort(medtmp);
-
-		// 中央値を求める
-		if constexpr (MCMAX % 2) {
-			// 要素が奇数個なら中央の要素を返す
-			return medtmp[(MCMAX - 1) / 2];
-		}
-		else {
-			// 要素が偶数個なら中央二つの平均を返す
-			return (medtmp[(MCMAX / 2) - 1] + medtmp[MCMAX / 2]) / 2;
-		}
-	}
-
-	std::pair<std::int32_t, mymap> eval_mode(tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::int32_t n)
-	{
-		// (n + 1)個目の行・列が埋まったときの分布
-		std::unordered_map<std::int32_t, std::int32_t> distmap;
-
-		// distmapを埋める
-		for (auto const & res : mcresult) {
-			// (n + 1)個目の行・列が埋まったときの回数をkeyとする
-			auto const key = res[n].first;
-
-			// keyが存在するかどうか
-			auto itr = distmap.find(key);
-			if (itr == distmap.end()) {
-				// keyが存在しなかったので、そのキーでハッシュを拡張（値1）
-				distmap.emplace(key, 1);
-			}
-			else {
-				// keyが指す値を更新
-				itr->second++;
-			}
-		}
-
-		// 最頻値を探索
-		auto const mode = boost::max_element(
-			distmap,
-			[](auto const & p1, auto const & p2) { return p1.second < p2.second; })->first;
-
-		// 最頻値と(n + 1)個目の行・列が埋まったときの分布をpairにして返す
-		return std::make_pair(mode, mymap(distmap.begin(), distmap.end()));
-	}
-
-	double eval_std_deviation(double avg, tbb::concurrent_vector< std::vector<mypair2> > const & mcresult, std::int32_t n)
-	{
-		// 標準偏差を求めるために必要な可変長配列
-		std::valarray<double> devtmp(MCMAX);
-
-		// 標準偏差の計算
-		boost::transform(
-			mcresult,
-			std::begin(devtmp),
-			[avg, n](auto const & res) {
-			auto const val = static_cast<double>(res[n].first);
-			return (val - avg) * (val - avg);
-		});
-
-		// 標準偏差を求める
-		return std::sqrt(devtmp.sum() / static_cast<double>(MCMAX));
-	}
-
-    auto makeboard()
+        update(batches.first, mcresult.first);
+        update(batches.second, mcresult.second);
+
+        return precision;
+    }
+
+    std::pair<LevelAccumulator, LevelAccumulator> montecarloTBB(std::uint64_t begin, std::uint64_t end, KernelKind kernel, checkpoint::LatencyHistogram & latency, progress::ProgressMonitor & monitor, checkpoint::TrialTracer & tracer, std::optional<std::uint64_t> seed, SobolPoints const * sobol)
     {
-        // 仮のビンゴボードを生成
-        std::vector<std::int32_t> boardtmp(BOARDSIZE);
+        // スレッドごとの、行・列とマスの(n + 1)個目ごとの集計結果
+        // 試行回数が2^32を超えても数えられるように、度数と総和は全てstd::uint64_tで持つ
+        tbb::enumerable_thread_specific< std::pair<LevelAccumulator, LevelAccumulator> > accumulators(
+            std::make_pair(LevelAccumulator(ROWCOLUMN), LevelAccumulator(BOARDSIZE)));
 
-        // 仮のビンゴボードに1～25の数字を代入
-        boost::algorithm::iota(boardtmp, 1);
+        // 終わった試行回数（前のバッチまでの分を含む）
+        std::atomic<std::uint64_t> completed(begin);
 
-        // 仮のビンゴボードの数字をシャッフル
-        std::shuffle(boardtmp.begin(), boardtmp.end(), std::mt19937());
+        // スレッドごとの、試行ごとの所要時間の集計結果
+        tbb::enumerable_thread_specific<checkpoint::LatencyHistogram> latencies;
 
-        // ビンゴボードを生成
-        std::vector<mypair> board(BOARDSIZE);
+        // 対称変量法では、(2u)番目と(2u + 1)番目の試行を組にして行う
+        auto const pertask = static_cast<std::uint64_t>(kernel == KernelKind::ANTITHETIC ? 2 : 1);
 
-        // 仮のビンゴボードからビンゴボードを生成する
-        boost::transform(
-            boardtmp,
-            board.begin(),
-            [](auto n) { return std::make_pair(n, false); });
+        // 終わった試行回数を数え、一定の試行回数ごとに、終わった試行回数とメモリ使用量をカウンタとして記録
+        auto const count_completed = [&completed](std::uint64_t count) {
+            if (auto const n = completed += count; n % COUNTERINTERVAL < count) {
+                checkpoint::record_counter("完了した試行", static_cast<double>(n));
+                checkpoint::record_counter("RSS (kB)", static_cast<double>(checkpoint::currentmem()));
+            }
+        };
 
-        // ビンゴボードを返す
-        return board;
-    }
+        // 試行の番号で決まるブロックの単位で並列化し、ブロックの中の試行は、一つの乱数列で番号の順に行う（試行の番号はstd::uint64_tにする）
+        // 乱択準モンテカルロ法ではSobol列を使うので、乱数は初期化しない
+        montecarlo::for_each_trial(
+            begin,
+            end,
+            pertask,
+            seed,
+            !sobol,
+            [&accumulators, begin, &count_completed, kernel, &latencies, &monitor, pertask, sobol, &tracer](std::uint64_t trial, montecarlo::blockrand_t * mr) {
+            // 1回の試行全体と、試行の中の区間の経過時間を計測（_CHECK_TRIAL_TIMERを定義してビルドしたときのみ）
+            checkpoint::TrialTimer<> const sttrial("試行");
+            auto const trialstart = checkpoint::TscClock::now();
+
+            // 幾何分布のカーネルでは、一様乱数の組から結果を求める（一回の試行の中身は記録しない）
+            if (kernel != KernelKind::DRAW) {
+                montecarlo::uniforms_t u;
+                if (sobol) {
+                    checkpoint::TrialTimer<> const st("乱数の生成");
+                    sobol->point(static_cast<std::uint32_t>(trial - begin), u);
+                }
+                else {
+                    checkpoint::TrialTimer<> const st("乱数の生成");
+                    montecarlo::fill_uniforms(*mr, u);
+                }
 
-#ifdef _CHECK_PARALELL_PERFORM
-	std::pair<std::vector< std::vector<mypair2> >, std::vector< std::vector<mypair2> > > montecarlo()
-    {
-        // モンテカルロ・シミュレーションの結果を格納するための二次元可変長配列
-		std::pair<std::vector< std::vector<mypair2> >, std::vector< std::vector<mypair2> > > mcresult;
+                checkpoint::TrialTimer<> const st("カーネル");
+                auto & acc = accumulators.local();
+                auto const start = checkpoint::TscClock::now();
+                auto const res = montecarloGeometric(u);
+                if (kernel == KernelKind::ANTITHETIC) {
+                    auto const res2 = montecarloGeometric(montecarlo::antithetic(u));
+                    auto const elapsed = (checkpoint::TscClock::now_serialized() - start) / 2;
+
+                    latencies.local().add(res.second.back().first, elapsed);
+                    latencies.local().add(res2.second.back().first, elapsed);
+                    acc.first.add_pair(res.first, res2.first);
+                    acc.second.add_pair(res.second, res2.second);
+                    monitor.trial_done(res.second.back().first, (checkpoint::TscClock::now() - trialstart) / 2);
+                    monitor.trial_done(res2.second.back().first, (checkpoint::TscClock::now() - trialstart) / 2);
+                }
+                else {
+                    latencies.local().add(res.second.back().first, checkpoint::TscClock::now_serialized() - start);
+                    acc.first.add(res.first);
+                    acc.second.add(res.second);
+                    monitor.trial_done(res.second.back().first, checkpoint::TscClock::now() - trialstart);
+                }
 
-		// MCMAX個の容量を確保
-		mcresult.first.reserve(MCMAX);
-		mcresult.second.reserve(MCMAX);
+                count_completed(pertask);
 
-#ifdef HAVE_SSE2
-		// 自作乱数クラスを初期化
-		myrandom::MyRandSfmt mr(1, BOARDSIZE);
-#else
-		// 自作乱数クラスを初期化
-		myrandom::MyRand mr(1, BOARDSIZE);
-#endif
-        // 試行回数分繰り返す
-        for (auto n = 0U; n < MCMAX; n++) {
-			// モンテカルロ・シミュレーションの結果を代入
-			auto const [resf, ress] = montecarloImpl(mr);
-			mcresult.first.emplace_back(resf);
-			mcresult.second.emplace_back(ress);
+                return;
+            }
+
+            // 記録する試行なら、このスレッドのリングバッファをカーネルの外で用意しておく
+            auto * const tracebuffer = tracer.selected(trial) ? &tracer.this_thread_buffer() : nullptr;
+
+            // モンテカルロ・シミュレーションの結果を代入
+            auto const [resf, ress] = [&latencies, &mr = *mr, tracebuffer, trial] {
+                checkpoint::TrialTimer<> const st("カーネル");
+
+                auto const start = checkpoint::TscClock::now();
+                auto res = [&mr, tracebuffer, trial] {
+                    if (tracebuffer) {
+                        checkpoint::TrialTrace<true> trace(*tracebuffer, trial);
+                        return montecarloImpl(mr, trace);
+                    }
+
+                    checkpoint::TrialTrace<false> trace;
+                    return montecarloImpl(mr, trace);
+                }();
+                auto const end = checkpoint::TscClock::now_serialized();
+
+                // 試行の所要時間を、その試行の抽選回数ごとに集計する
+                latencies.local().add(res.second.back().first, end - start);
+
+                return res;
+            }();
+
+            {
+                checkpoint::TrialTimer<> const st("結果の集約");
+                auto & acc = accumulators.local();
+                acc.first.add(resf);
+                acc.second.add(ress);
+            }
+
+            monitor.trial_done(ress.back().first, checkpoint::TscClock::now() - trialstart);
+
+            count_completed(1);
+        });
+
+        // スレッドごとの集計結果をまとめる
+        for (auto const & l : latencies) {
+            latency.merge(l);
+        }
+
+        // 度数と総和は整数なので、まとめる順番によらず結果は同じになる
+        auto mcresult = std::make_pair(LevelAccumulator(ROWCOLUMN), LevelAccumulator(BOARDSIZE));
+        for (auto const & acc : accumulators) {
+            mcresult.first.merge(acc.first);
+            mcresult.second.merge(acc.second);
         }
 
         // モンテカルロ・シミュレーションの結果を返す
         return mcresult;
     }
-#endif
 
-	template <typename MyRandom>
-	std::pair<std::vector<mypair2>, std::vector<mypair2> > montecarloImpl(MyRandom & mr)
+    WeightedLevels montecarloRare(std::uint64_t begin, std::uint64_t end, montecarlo::ExponentialTilting const & tilting, std::optional<std::uint64_t> seed)
     {
-        // ビンゴボードを生成
-        auto board(makeboard());
-
-        // その行・列が既に埋まっているかどうかを格納する可変長配列
-        // ROWCOLUMN個の要素をfalseで初期化
-        std::vector<bool> rcfill(ROWCOLUMN, false);
-
-        // 行・列が埋まるまでに要した回数と、その時点で埋まったマスを格納した
-        // 可変長配列
-        std::vector<mypair2> fillnum;
-
-		// (n + 1)個目のマスが埋まったときの回数と、その時点で埋まった行・列を格納した
-        // 可変長配列
-		std::vector<mypair2> fillnum2;
-
-        // ROWCOLUMN個の容量を確保
-        fillnum.reserve(ROWCOLUMN);
-
-        // その時点で埋まっているマスを計算するためのラムダ式
-        auto const sum = [](auto const & vec) {
-            auto cnt = 0;
-            for (auto & e : vec) {
-                if (e.second) {
-                    cnt++;
+        // 重みは浮動小数点数なので、スレッドごとに足し合わせると結果がスレッドの数と実行の順番で変わる
+        // 乱数列のブロックの範囲を決まった大きさまで二分し、決まった順番で足し合わせるtbb::parallel_deterministic_reduceを使う
+        return tbb::parallel_deterministic_reduce(
+            tbb::blocked_range<std::uint64_t>(begin / SEEDBLOCK, (end + SEEDBLOCK - 1) / SEEDBLOCK, RAREGRAINSIZE / SEEDBLOCK),
+            WeightedLevels(std::vector<WeightedHistogram>(ROWCOLUMN), std::vector<WeightedHistogram>(BOARDSIZE)),
+            [begin, end, &tilting, seed](tbb::blocked_range<std::uint64_t> const & range, WeightedLevels acc) {
+            for (auto block = range.begin(); block != range.end(); ++block) {
+                auto mr = montecarlo::make_block_rand(seed, block);
+                auto const first = std::max(begin, block * SEEDBLOCK);
+                auto const last = std::min(end, (block + 1) * SEEDBLOCK);
+                for (auto trial = first; trial < last; ++trial) {
+                    montecarlo::uniforms_t u;
+                    montecarlo::fill_uniforms(mr, u);
+
+                    // (n + 1)個目の行・列には、それが埋まったときのマスの数mまでの尤度比をつける
+                    montecarlo::weights_t weights;
+                    auto const res = tilting.sample(u, weights);
+                    for (auto n = 0U; n < ROWCOLUMN; n++) {
+                        acc.first[n].add(res.first[n].first, weights[res.first[n].second - 1]);
+                    }
+
+                    for (auto n = 0U; n < BOARDSIZE; n++) {
+                        acc.second[n].add(res.second[n].first, weights[n]);
+                    }
                 }
             }
 
-            return cnt;
-        };
-
-        // 無限ループ
-        for (auto n = 1; ; n++) {
-            // 乱数で得た数字で、かつまだ当たってないマスを検索
-            auto itr = boost::find(board, std::make_pair(mr.myrand(), false));
+            return acc;
+        },
+            [](WeightedLevels lhs, WeightedLevels const & rhs) {
+            for (auto n = 0U; n < ROWCOLUMN; n++) {
+                lhs.first[n].merge(rhs.first[n]);
+            }
 
-            // そのようなマスがあった
-            if (itr != board.end()) {
-                // そのマスは当たったとし、フラグをtrueにする
-                itr->second = true;
+            for (auto n = 0U; n < BOARDSIZE; n++) {
+                lhs.second[n].merge(rhs.second[n]);
             }
-            // そのようなマスがなかった
-            else {
-                //ループ続行
-                continue;
+
+            return lhs;
+        });
+    }
+
+    void outputcsv(Histogram const & hist, std::string const & filename)
+    {
+        std::ofstream ofs(filename);
+
+        hist.outputcsv(ofs);
+    }
+
+    void outputsummarycsv(std::vector<Histogram> const & hists, SummarySe const & se, double confidence, std::string const & filename)
+    {
+        std::ofstream ofs(filename);
+
+        ofs << "n,trials,mean,mean_lower,mean_upper,median,mode,std_deviation";
+        for (auto const p : QUANTILES) {
+            auto const percent = static_cast<std::int32_t>(p * 100.0 + 0.5);
+#ifdef _MSC_VER
+            ofs << std::format(",p{0:d},p{0:d}_lower,p{0:d}_upper", percent);
+#else
+            ofs << boost::format(",p%1%,p%1%_lower,p%1%_upper") % percent;
+#endif
+        }
+        ofs << ",mean_se,median_se,mode_se,std_deviation_se\n";
+
+        for (auto n = 0U; n < hists.size(); n++) {
+            auto const & hist = hists[n];
+            auto const [meanlower, meanupper] = hist.mean_ci(confidence);
+#ifdef _MSC_VER
+            ofs << std::format("{:d},{:d},{:.6f},{:.6f},{:.6f},{:d},{:d},{:.6f}", n + 1, hist.total(), hist.mean(), meanlower, meanupper, hist.median(), hist.mode(), hist.std_deviation());
+#else
+            ofs << boost::format("%d,%d,%.6f,%.6f,%.6f,%d,%d,%.6f") % (n + 1) % hist.total() % hist.mean() % meanlower % meanupper % hist.median() % hist.mode() % hist.std_deviation();
+#endif
+            for (auto const p : QUANTILES) {
+                auto const [lower, upper] = hist.quantile_ci(p, confidence);
+#ifdef _MSC_VER
+                ofs << std::format(",{:d},{:d},{:d}", hist.quantile(p), lower, upper);
+#else
+                ofs << boost::format(",%d,%d,%d") % hist.quantile(p) % lower % upper;
+#endif
             }
+#ifdef _MSC_VER
+            ofs << std::format(",{:s},{:s},{:s},{:s}\n", se_string(se.mean[n], 6), se_string(se.median[n], 6), se_string(se.mode[n], 6), se_string(se.std_deviation[n], 6));
+#else
+            ofs << boost::format(",%s,%s,%s,%s\n") % se_string(se.mean[n], 6) % se_string(se.median[n], 6) % se_string(se.mode[n], 6) % se_string(se.std_deviation[n], 6);
+#endif
+        }
+    }
 
-            // 各行・列が埋まったかどうかをチェック
-            for (auto j = 0U; j < ROW; j++) {
-                // 各行が埋まったかどうかのフラグ
-                auto rowflag = true;
+    std::size_t outputjointcsv(std::vector<JointHistogram> const & joints, char const * column, std::string const & filename)
+    {
+        std::ofstream ofs(filename);
 
-                // 各行が埋まったかどうかをチェック
-                for (auto k = 0U; k < COLUMN; k++) {
-                    rowflag &= board[COLUMN * j + k].second;
-                }
+        ofs << "n,draws," << column << ",count\n";
+
+        std::size_t nonzeros = 0;
+        for (auto n = 0U; n < joints.size(); n++) {
+            joints[n].outputcsv(ofs, n + 1);
+            nonzeros += joints[n].nonzeros();
+        }
 
-                // 行の処理
-                if (rowflag &&
-                    // その行は既に埋まっているかどうか
-                    !rcfill[j]) {
-                    // その行は埋まったとして、フラグをtrueにする
-                    rcfill[j] = true;
+        return nonzeros;
+    }
 
-                    // 要した試行回数と、その時点で埋まったマスの数を格納
-                    fillnum.emplace_back(n, sum(board));
-                }
+    std::string se_string(double se, std::int32_t precision)
+    {
+        if (!std::isfinite(se)) {
+            return "n/a";
+        }
 
-                // 各列が埋まったかどうかのフラグ
-                auto columnflag = true;
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(precision) << se;
 
-                // 各列が埋まったかどうかをチェック    
-                for (auto k = 0U; k < ROW; k++) {
-                    columnflag &= board[j + COLUMN * k].second;
-                }
+        return oss.str();
+    }
 
-                // 列の処理
-                if (columnflag &&
-                    // その列は既に埋まっているかどうか
-                    !rcfill[j + ROW]) {
+    SummarySe unavailable_se(std::size_t size)
+    {
+        std::vector<double> const nan(size, std::numeric_limits<double>::quiet_NaN());
 
-                    // その列は埋まったとして、フラグをtrueにする
-                    rcfill[j + ROW] = true;
+        return { nan, nan, nan, nan, nan };
+    }
 
-                    // 要した試行回数と、その時点で埋まったマスの数を格納
-                    fillnum.emplace_back(n, sum(board));
-                }
+    std::string quantile_report(Histogram const & hist, double confidence)
+    {
+        auto const [meanlower, meanupper] = hist.mean_ci(confidence);
+
+#ifdef _MSC_VER
+        auto report = std::format("    平均の{:g}%信頼区間：[{:.2f}, {:.2f}]回, 分位点（{:g}%信頼区間）：", confidence * 100.0, meanlower, meanupper, confidence * 100.0);
+#else
+        auto report = (boost::format("    平均の%g%%信頼区間：[%.2f, %.2f]回, 分位点（%g%%信頼区間）：") % (confidence * 100.0) % meanlower % meanupper % (confidence * 100.0)).str();
+#endif
+        for (auto i = 0U; i < QUANTILES.size(); i++) {
+            auto const p = QUANTILES[i];
+            auto const [lower, upper] = hist.quantile_ci(p, confidence);
+#ifdef _MSC_VER
+            report += std::format("{:s}P{:d} = {:d}回 [{:d}, {:d}]", i ? ", " : "", static_cast<std::int32_t>(p * 100.0 + 0.5), hist.quantile(p), lower, upper);
+#else
+            report += (boost::format("%sP%d = %d回 [%d, %d]") % (i ? ", " : "") % static_cast<std::int32_t>(p * 100.0 + 0.5) % hist.quantile(p) % lower % upper).str();
+#endif
+        }
+
+        return report + '\n';
+    }
+
+    template <typename Format>
+    std::vector<std::string> summarize(std::vector<Histogram> const & hists, SummarySe const & se, char const * csvname, double confidence, Format format)
+    {
+        std::vector<std::string> report(hists.size());
+
+        tbb::parallel_for(
+            static_cast<std::size_t>(0),
+            hists.size(),
+            [confidence, csvname, &format, &hists, &report](auto n) {
+#ifdef _MSC_VER
+            outputcsv(hists[n], std::format("result/{:s}_{:d}個目.csv", csvname, n + 1));
+#else
+            outputcsv(hists[n], (boost::format("result/%s_%d個目.csv") % csvname % (n + 1)).str());
+#endif
+            report[n] = format(n, hists[n]) + quantile_report(hists[n], confidence);
+        });
+
+#ifdef _MSC_VER
+        outputsummarycsv(hists, se, confidence, std::format("result/{:s}_summary.csv", csvname));
+#else
+        outputsummarycsv(hists, se, confidence, (boost::format("result/%s_summary.csv") % csvname).str());
+#endif
+
+        return report;
+    }
+
+    std::string variance_reduction_report(std::pair<LevelAccumulator, LevelAccumulator> const & mcresult, bool controlvariates)
+    {
+        // m個のマスが埋まるまでの抽選回数の期待値
+        auto const mu = statistics::coupon_collector_means(BOARDSIZE);
+
+        // 分散減少率を表示する文字列を作る（分散が0になったときは∞にする）
+        auto const ratio = [](double vrf) {
+            if (std::isinf(vrf)) {
+                return std::string("∞");
             }
 
-			// 要した試行回数と、その時点で埋まっている行・列の数を格納
-			fillnum2.emplace_back(n, static_cast<std::int32_t>(fillnum.size()));
+#ifdef _MSC_VER
+            return std::format("{:.2f}", vrf);
+#else
+            return (boost::format("%.2f") % vrf).str();
+#endif
+        };
+
+        // 試行回数のヒストグラムと、制御変量法に使う集計結果は、同時分布から一度だけ求める
+        auto const linehists = mcresult.first.histograms();
+        auto const cellhists = mcresult.second.histograms();
+        auto const lineconditional = controlvariates ? mcresult.first.conditional() : std::vector<statistics::ConditionalMoments>();
+
+        // 単純な平均とその標準誤差、対称変量法の推定値を表示する文字列を作る
+        auto const plain = [&ratio](LevelAccumulator const & acc, std::vector<Histogram> const & hists, std::size_t n) {
+            auto const & hist = hists[n];
+            auto const total = static_cast<double>(hist.total());
+            auto const sd = hist.std_deviation() * std::sqrt(total / std::max(total - 1.0, 1.0));
+            auto const & pairs = acc.antithetic()[n];
 
-            // 全ての行・列が埋まったかどうか
-            if (fillnum.size() == ROWCOLUMN) {
-                // 埋まったのでループ脱出
-                break;
+#ifdef _MSC_VER
+            auto report = std::format("単純 {:.4f} ± {:.4f}回", hist.mean(), sd / std::sqrt(total));
+            if (pairs.pairs()) {
+                auto const r = pairs.estimate(sd * sd);
+                report += std::format(", 対称変量 {:.4f} ± {:.4f}回（分散減少率 {:s}倍）", r.mean, r.se, ratio(r.vrf));
+            }
+#else
+            auto report = (boost::format("単純 %.4f ± %.4f回") % hist.mean() % (sd / std::sqrt(total))).str();
+            if (pairs.pairs()) {
+                auto const r = pairs.estimate(sd * sd);
+                report += (boost::format(", 対称変量 %.4f ± %.4f回（分散減少率 %s倍）") % r.mean % r.se % ratio(r.vrf)).str();
             }
+#endif
+            return report;
+        };
+
+        std::string report = "平均試行回数の分散減少（推定値 ± 標準誤差）\n";
+        for (auto n = 0U; n < ROWCOLUMN; n++) {
+#ifdef _MSC_VER
+            report += std::format("  ビンゴ{:d}個目：", n + 1) + plain(mcresult.first, linehists, n);
+            if (controlvariates) {
+                auto const r = lineconditional[n].control_variate(mu);
+                report += std::format(", 制御変量 {:.4f} ± {:.4f}回（分散減少率 {:s}倍）", r.mean, r.se, ratio(r.vrf));
+            }
+#else
+            report += (boost::format("  ビンゴ%d個目：") % (n + 1)).str() + plain(mcresult.first, linehists, n);
+            if (controlvariates) {
+                auto const r = lineconditional[n].control_variate(mu);
+                report += (boost::format(", 制御変量 %.4f ± %.4f回（分散減少率 %s倍）") % r.mean % r.se % ratio(r.vrf)).str();
+            }
+#endif
+            report += '\n';
         }
 
-        // 要した試行関数の可変長配列を返す
-        return std::make_pair(std::move(fillnum), std::move(fillnum2));
+        for (auto n = 0U; n < BOARDSIZE; n++) {
+#ifdef _MSC_VER
+            report += std::format("  {:d}個目のマス：", n + 1) + plain(mcresult.second, cellhists, n);
+            if (controlvariates) {
+                report += std::format(", 厳密値 {:.4f}回", mu[n + 1]);
+            }
+#else
+            report += (boost::format("  %d個目のマス：") % (n + 1)).str() + plain(mcresult.second, cellhists, n);
+            if (controlvariates) {
+                report += (boost::format(", 厳密値 %.4f回") % mu[n + 1]).str();
+            }
+#endif
+            report += '\n';
+        }
+
+        return report;
     }
 
-    std::pair<tbb::concurrent_vector< std::vector<mypair2> >, tbb::concurrent_vector< std::vector<mypair2> > > montecarloTBB()
+    std::string rare_event_report(WeightedLevels const & result, montecarlo::ExponentialTilting const & tilting, std::int32_t draws, double confidence)
     {
-        // モンテカルロ・シミュレーションの結果を格納するための二次元可変長配列
-        // 複数のスレッドが同時にアクセスする可能性があるためtbb::concurrent_vectorを使う
-        std::pair<tbb::concurrent_vector< std::vector<mypair2> >, tbb::concurrent_vector< std::vector<mypair2> > > mcresult;
+        auto const z = statistics::normal_critical_value(confidence);
+        auto const lower = tilting.theta() < 0.0;
+
+        // 一つの(n + 1)個目の裾の確率を表示する文字列を作り、重みつきの分布をcsvファイルに出力する
+        auto const level = [confidence, draws, lower, z](WeightedHistogram const & hist, std::string const & filename) {
+            {
+                std::ofstream ofs(filename);
+                hist.outputcsv(ofs);
+            }
 
-        // MCMAX個の容量を確保
-        mcresult.first.reserve(MCMAX);
-		mcresult.second.reserve(MCMAX);
+            auto const t = lower ? hist.lower_tail(draws) : hist.upper_tail(draws);
+            if (t.probability <= 0.0) {
+                return std::string("該当する試行なし");
+            }
 
-        // MCMAX回のループを並列化して実行
-        tbb::parallel_for(
-            0U,
-            MCMAX,
-            1U,
-            [&mcresult](auto) {
-
-#ifdef HAVE_SSE2
-			// 自作乱数クラスを初期化
-			myrandom::MyRandSfmt mr(1, BOARDSIZE);
+            // 同じ標準誤差を得るのに必要な、単純なモンテカルロ・シミュレーションの試行回数
+            auto const p = std::min(t.probability, 1.0);
+            auto const plain = t.se > 0.0 ? p * (1.0 - p) / (t.se * t.se) : 0.0;
+#ifdef _MSC_VER
+            return std::format("P = {:.4e} ± {:.2e}（相対誤差 {:.2f}%, {:g}%信頼区間 [{:.4e}, {:.4e}]）, 同じ精度に必要な単純な試行回数：{:.3g}回, 有効試行回数：{:.0f}回",
+                               t.probability, t.se, 100.0 * t.se / t.probability, confidence * 100.0, std::max(t.probability - z * t.se, 0.0), std::min(t.probability + z * t.se, 1.0), plain, hist.effective_samples());
 #else
-			// 自作乱数クラスを初期化
-			myrandom::MyRand mr(1, BOARDSIZE);
+            return (boost::format("P = %.4e ± %.2e（相対誤差 %.2f%%, %g%%信頼区間 [%.4e, %.4e]）, 同じ精度に必要な単純な試行回数：%.3g回, 有効試行回数：%.0f回")
+                    % t.probability
+                    % t.se
+                    % (100.0 * t.se / t.probability)
+                    % (confidence * 100.0)
+                    % std::max(t.probability - z * t.se, 0.0)
+                    % std::min(t.probability + z * t.se, 1.0)
+                    % plain
+                    % hist.effective_samples()).str();
 #endif
+        };
 
-            // モンテカルロ・シミュレーションの結果を代入
-			auto const [resf, ress] = montecarloImpl(mr);
-            mcresult.first.emplace_back(resf);
-			mcresult.second.emplace_back(ress);
-        });
+        auto const & last = result.second.back();
+#ifdef _MSC_VER
+        auto report = std::format("重点サンプリング（θ = {:.4f}, 全てのマスが埋まる平均試行回数：{:.1f}回, 試行回数：{:d}回, 全てのマスの有効試行回数：{:.0f}回）\n", tilting.theta(), tilting.mean(), last.samples(), last.effective_samples())
+                    + std::format("試行回数が{:d}回{:s}になる確率（全てのマスに合わせた傾きなので、それより前の行・列やマスは有効試行回数が少なくなることがある）\n", draws, lower ? "以下" : "以上");
+#else
+        auto report = (boost::format("重点サンプリング（θ = %.4f, 全てのマスが埋まる平均試行回数：%.1f回, 試行回数：%d回, 全てのマスの有効試行回数：%.0f回）\n")
+                       % tilting.theta()
+                       % tilting.mean()
+                       % last.samples()
+                       % last.effective_samples()).str()
+                    + (boost::format("試行回数が%d回%sになる確率（全てのマスに合わせた傾きなので、それより前の行・列やマスは有効試行回数が少なくなることがある）\n") % draws % (lower ? "以下" : "以上")).str();
+#endif
 
-        // モンテカルロ・シミュレーションの結果を返す
-        return mcresult;
+        for (auto n = 0U; n < ROWCOLUMN; n++) {
+#ifdef _MSC_VER
+            report += std::format("  ビンゴ{:d}個目：", n + 1) + level(result.first[n], std::format("result/rare_distribution_{:d}個目.csv", n + 1)) + '\n';
+#else
+            report += (boost::format("  ビンゴ%d個目：") % (n + 1)).str() + level(result.first[n], (boost::format("result/rare_distribution_%d個目.csv") % (n + 1)).str()) + '\n';
+#endif
+        }
+
+        for (auto n = 0U; n < BOARDSIZE; n++) {
+#ifdef _MSC_VER
+            report += std::format("  {:d}個目のマス：", n + 1) + level(result.second[n], std::format("result/rare_distribution2_{:d}個目.csv", n + 1)) + '\n';
+#else
+            report += (boost::format("  %d個目のマス：") % (n + 1)).str() + level(result.second[n], (boost::format("result/rare_distribution2_%d個目.csv") % (n + 1)).str()) + '\n';
+#endif
+        }
+
+        return report;
     }
 
-    void outputcsv(mymap const & distmap, std::string const & filename)
+    std::string rqmc_report(std::pair<BatchMeans, BatchMeans> const & batches, std::pair<LevelAccumulator, LevelAccumulator> const & mcresult, std::uint64_t points)
     {
-        std::ofstream ofs(filename);
+        // 一つの(n + 1)個目の、複製の間のばらつきから求めた標準誤差と、単純なモンテカルロ法の標準誤差を比べる
+        auto const level = [](Histogram const & hist, double se) {
+            // 複製が2個未満なら標準誤差は有限でないので、n/aと表示して分散減少率は求めない
+            auto const plain = hist.std_deviation() / std::sqrt(static_cast<double>(hist.total()));
+            if (plain <= 0.0 || !(se > 0.0) || !std::isfinite(se)) {
+#ifdef _MSC_VER
+                return std::format("{:.4f} ± {:s}回\n", hist.mean(), se_string(se, 4));
+#else
+                return (boost::format("%.4f ± %s回\n") % hist.mean() % se_string(se, 4)).str();
+#endif
+            }
 
-        boost::transform(
-            distmap,
-            std::ostream_iterator<std::string>(ofs, "\n"),
+            auto const vrf = plain * plain / (se * se);
 #ifdef _MSC_VER
-            [](auto const& p) { return std::format("{:d},{:d}", p.first, p.second); });
+            return std::format("{:.4f} ± {:.4f}回（単純なモンテカルロ法の標準誤差 {:.4f}回, 分散減少率 {:.2f}倍）\n", hist.mean(), se, plain, vrf);
 #else
-            [](auto const & p) { return (boost::format("%d,%d") % p.first % p.second).str(); });
+            return (boost::format("%.4f ± %.4f回（単純なモンテカルロ法の標準誤差 %.4f回, 分散減少率 %.2f倍）\n") % hist.mean() % se % plain % vrf).str();
 #endif
+        };
+
+        auto const replicates = mcresult.first.trials() / points;
+        auto const linese = batches.first.mean_se();
+        auto const cellse = batches.second.mean_se();
+        auto const linehists = mcresult.first.histograms();
+        auto const cellhists = mcresult.second.histograms();
+
+#ifdef _MSC_VER
+        auto report = std::format("乱択準モンテカルロ法の平均試行回数（独立にスクランブルした{:d}個の複製, 複製ごとに{:d}点, 標準誤差は複製の間のばらつきから求めた値）\n", replicates, points);
+#else
+        auto report = (boost::format("乱択準モンテカルロ法の平均試行回数（独立にスクランブルした%d個の複製, 複製ごとに%d点, 標準誤差は複製の間のばらつきから求めた値）\n") % replicates % points).str();
+#endif
+
+        if (batches.first.batches() < 2) {
+#ifdef _MSC_VER
+            report += std::format("  複製が{:d}個（2個未満）なので、標準誤差は求めません（n/a）。trialsをrqmc-pointsの2倍以上にしてください\n", batches.first.batches());
+#else
+            report += (boost::format("  複製が%d個（2個未満）なので、標準誤差は求めません（n/a）。trialsをrqmc-pointsの2倍以上にしてください\n") % batches.first.batches()).str();
+#endif
+        }
+
+        for (auto n = 0U; n < ROWCOLUMN; n++) {
+#ifdef _MSC_VER
+            report += std::format("  ビンゴ{:d}個目：", n + 1) + level(linehists[n], linese[n]);
+#else
+            report += (boost::format("  ビンゴ%d個目：") % (n + 1)).str() + level(linehists[n], linese[n]);
+#endif
+        }
+
+        for (auto n = 0U; n < BOARDSIZE; n++) {
+#ifdef _MSC_VER
+            report += std::format("  {:d}個目のマス：", n + 1) + level(cellhists[n], cellse[n]);
+#else
+            report += (boost::format("  %d個目のマス：") % (n + 1)).str() + level(cellhists[n], cellse[n]);
+#endif
+        }
+
+        return report;
     }
 }
 
@@ -0,0 +1,145 @@
+﻿/*! \file geometric.h
+    \brief マスが埋まる順番と、新しいマスが当たるまでの待ち時間で表した、ビンゴの一回の試行の実装
+    抽選を一回ずつ行う代わりに、(0, 1)の一様乱数の組から、マスが埋まる順番（一様な順列）と、
+    新しいマスが当たるまでの抽選回数（幾何分布）を作る。montecarloImplと同じ分布の結果を返す
+    一様乱数の組を決めれば結果が決まるので、対称変量法や準モンテカルロ法に使える
+    テンプレートとインライン関数だけなので、ヘッダだけで完結する
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _GEOMETRIC_H_
+#define _GEOMETRIC_H_
+
+#pragma once
+
+#include "montecarlo.h"
+#include <algorithm>                            // for std::min
+#include <array>                                // for std::array
+#include <cmath>                                // for std::ceil, std::log
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::int32_t
+#include <numeric>                              // for std::iota
+#include <utility>                              // for std::make_pair, std::move, std::pair, std::swap
+#include <vector>                               // for std::vector
+
+namespace montecarlo {
+    //! A global variable (constant expression).
+    /*!
+        一回の試行に使う一様乱数の個数
+        順列の生成に(BOARDSIZE - 1)個、二個目以降のマスが当たるまでの待ち時間に(BOARDSIZE - 1)個
+    */
+    static auto constexpr GEOMETRICDIM = 2 * (BOARDSIZE - 1);
+
+    //! A typedef.
+    /*!
+        一回の試行に使う、(0, 1)の一様乱数の組の型
+    */
+    using uniforms_t = std::array<double, GEOMETRICDIM>;
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        一様乱数の組から、対称変量（全ての成分を1 - uにしたもの）を作る
+        マスが埋まる順番は鏡映しになり、待ち時間は長短が入れ替わる
+        \param u 一様乱数の組
+        \return 対称変量
+    */
+    inline uniforms_t antithetic(uniforms_t const & u)
+    {
+        uniforms_t v;
+        for (auto i = 0U; i < GEOMETRICDIM; i++) {
+            v[i] = 1.0 - u[i];
+        }
+
+        return v;
+    }
+
+    //! A function template.
+    /*!
+        自作乱数クラスで、一回の試行に使う一様乱数の組を生成する
+        \param mr 自作乱数クラスのオブジェクト（myrand01で(0, 1)の一様乱数を生成できるもの）
+        \param u 一様乱数の組を格納する配列
+    */
+    template <typename MyRandom>
+    void fill_uniforms(MyRandom & mr, uniforms_t & u)
+    {
+        for (auto & x : u) {
+            x = mr.myrand01();
+        }
+    }
+
+    //! A function template.
+    /*!
+        一様乱数の組と、新しいマスが当たるまでの抽選回数を求める関数オブジェクトから、一回の試行の結果を求める
+        \param u (0, 1)の一様乱数の組
+        \param wait (i, u)から、i個のマスが埋まっているときに新しいマスが当たるまでの抽選回数を求める関数オブジェクト
+        \return montecarloImplと同じ形式の、行・列とマスの結果のstd::pair
+    */
+    template <typename Wait>
+    std::pair<std::vector<mypair2>, std::vector<mypair2> > montecarloGeometric(uniforms_t const & u, Wait wait)
+    {
+        // マスが埋まる順番をFisher-Yatesのシャッフルで作る（u[0]～u[BOARDSIZE - 2]を使う）
+        std::array<std::int32_t, BOARDSIZE> order;
+        std::iota(order.begin(), order.end(), 0);
+        for (auto i = 0U; i < BOARDSIZE - 1; i++) {
+            auto const j = i + std::min(static_cast<std::size_t>(u[i] * static_cast<double>(BOARDSIZE - i)), static_cast<std::size_t>(BOARDSIZE - 1 - i));
+            std::swap(order[i], order[j]);
+        }
+
+        // 行・列ごとの、埋まっているマスの数
+        std::array<std::size_t, ROW> rowcount = {};
+        std::array<std::size_t, COLUMN> columncount = {};
+
+        // 行・列が埋まるまでに要した回数と、その時点で埋まったマスを格納した可変長配列
+        std::vector<mypair2> fillnum;
+        fillnum.reserve(ROWCOLUMN);
+
+        // (n + 1)個目のマスが埋まったときの回数と、その時点で埋まった行・列を格納した可変長配列
+        std::vector<mypair2> fillnum2;
+        fillnum2.reserve(BOARDSIZE);
+
+        // 二個目以降のマスが当たるまでの抽選回数には、u[BOARDSIZE - 1]～u[2 * BOARDSIZE - 3]を使う
+        auto n = 0;
+        for (auto i = 0U; i < BOARDSIZE; i++) {
+            n += i ? wait(i, u[BOARDSIZE - 2 + i]) : 1;
+
+            auto const cell = static_cast<std::size_t>(order[i]);
+            auto const filled = static_cast<std::int32_t>(i + 1);
+
+            if (++rowcount[cell / COLUMN] == COLUMN) {
+                fillnum.emplace_back(n, filled);
+            }
+
+            if (++columncount[cell % COLUMN] == ROW) {
+                fillnum.emplace_back(n, filled);
+            }
+
+            fillnum2.emplace_back(n, static_cast<std::int32_t>(fillnum.size()));
+        }
+
+        return std::make_pair(std::move(fillnum), std::move(fillnum2));
+    }
+
+    //! A function.
+    /*!
+        一様乱数の組から、一回の試行の結果を求める
+        \param u (0, 1)の一様乱数の組
+        \return montecarloImplと同じ形式の、行・列とマスの結果のstd::pair
+    */
+    inline std::pair<std::vector<mypair2>, std::vector<mypair2> > montecarloGeometric(uniforms_t const & u)
+    {
+        // i個のマスが埋まっているとき、新しいマスが当たるまでの抽選回数は、成功確率(BOARDSIZE - i) / BOARDSIZEの幾何分布に従う
+        // 逆関数法で、P(G > g) = (i / BOARDSIZE)^gからGを求める
+        return montecarloGeometric(u, [](std::size_t i, double ui) {
+            auto const q = static_cast<double>(i) / static_cast<double>(BOARDSIZE);
+            return static_cast<std::int32_t>(std::ceil(std::log(ui) / std::log(q)));
+        });
+    }
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _GEOMETRIC_H_
@@ -0,0 +1,263 @@
+﻿/*! \file montecarlo.h
+    \brief ビンゴの一回の試行（モンテカルロ・シミュレーションのカーネル）の実装
+    テンプレートとインライン関数だけなので、ヘッダだけで完結する
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _MONTECARLO_H_
+#define _MONTECARLO_H_
+
+#pragma once
+
+#include "../../checkpoint/alloctracker.h"
+#include "../../checkpoint/kernelprobe.h"
+#include <algorithm>                            // for std::shuffle
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::int32_t
+#include <random>                               // for std::mt19937
+#include <utility>                              // for std::make_pair, std::move, std::pair
+#include <vector>                               // for std::vector
+#include <boost/algorithm/cxx11/iota.hpp>       // for boost::algorithm::iota
+#include <boost/range/algorithm.hpp>            // for boost::find, boost::transform
+
+namespace montecarlo {
+    //! A global variable (constant expression).
+    /*!
+        列のサイズ
+    */
+    static auto constexpr COLUMN = 5ULL;
+
+    //! A global variable (constant expression).
+    /*!
+        行のサイズ
+    */
+    static auto constexpr ROW = 5ULL;
+
+    //! A global variable (constant expression).
+    /*!
+        ビンゴボードのマス数
+    */
+    static auto constexpr BOARDSIZE = ROW * COLUMN;
+
+    //! A global variable (constant expression).
+    /*!
+        行・列の総数
+    */
+    static auto constexpr ROWCOLUMN = ROW + COLUMN;
+
+    //! A typedef.
+    /*!
+        そのマスに書かれてある番号と、そのマスが当たったかどうかを示すフラグのstd::pair
+    */
+    using mypair = std::pair<std::int32_t, bool>;
+
+    //! A typedef.
+    /*!
+        数字と数字のstd::pair
+    */
+    using mypair2 = std::pair<std::int32_t, std::int32_t>;
+
+    //! An enumeration.
+    /*!
+        カーネルの中で数えるイベントの番号
+    */
+    enum KernelCounter : std::size_t {
+        RNGCALL,            //!< 乱数の生成
+        WASTEDDRAW,         //!< 既に当たっている数字を引いた抽選
+        BOARDSEARCH,        //!< ビンゴボードの探索
+        LINECHECK,          //!< 行・列の判定
+        LINECOMPLETE        //!< 行・列が埋まった
+    };
+
+    //! An enumeration.
+    /*!
+        カーネルの中で時間を計測する段階の番号
+    */
+    enum KernelStage : std::size_t {
+        STAGEINIT,          //!< ビンゴボードの生成
+        STAGERNG,           //!< 乱数の生成
+        STAGESEARCH,        //!< ビンゴボードの探索
+        STAGELINECHECK,     //!< 行・列の判定
+        STAGERECORD         //!< 結果の記録
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        ビンゴボードを生成する
+        \return ビンゴボードが格納された可変長配列
+    */
+    inline std::vector<mypair> makeboard()
+    {
+        // 仮のビンゴボードを生成
+        std::vector<std::int32_t> boardtmp(BOARDSIZE);
+
+        // 仮のビンゴボードに1～25の数字を代入
+        boost::algorithm::iota(boardtmp, 1);
+
+        // 仮のビンゴボードの数字をシャッフル
+        std::shuffle(boardtmp.begin(), boardtmp.end(), std::mt19937());
+
+        // ビンゴボードを生成
+        std::vector<mypair> board(BOARDSIZE);
+
+        // 仮のビンゴボードからビンゴボードを生成する
+        boost::transform(
+            boardtmp,
+            board.begin(),
+            [](auto n) { return std::make_pair(n, false); });
+
+        // ビンゴボードを返す
+        return board;
+    }
+
+    //! A function.
+    /*!
+        モンテカルロ・シミュレーションの実装
+        \param mr 自作乱数クラスのオブジェクト
+        \param trace 試行の中身を記録するオブジェクト
+        \return モンテカルロ法の結果が格納された可変長配列
+    */
+    template <typename MyRandom, typename Trace>
+    std::pair<std::vector<mypair2>, std::vector<mypair2> > montecarloImpl(MyRandom & mr, Trace & trace)
+    {
+        // カーネルの中の計測（_CHECK_KERNEL_PERFORMを定義してビルドしなければ何もしない）
+        checkpoint::KernelProbe<> probe;
+
+        // ビンゴボードを生成
+        auto board(makeboard());
+
+        // その行・列が既に埋まっているかどうかを格納する可変長配列
+        // ROWCOLUMN個の要素をfalseで初期化
+        std::vector<bool> rcfill(ROWCOLUMN, false);
+
+        // 行・列が埋まるまでに要した回数と、その時点で埋まったマスを格納した
+        // 可変長配列
+        std::vector<mypair2> fillnum;
+
+        // (n + 1)個目のマスが埋まったときの回数と、その時点で埋まった行・列を格納した
+        // 可変長配列
+        std::vector<mypair2> fillnum2;
+
+        // ROWCOLUMN個とBOARDSIZE個の容量を確保（抽選のループの中では、メモリを確保しない）
+        fillnum.reserve(ROWCOLUMN);
+        fillnum2.reserve(BOARDSIZE);
+
+        // その時点で埋まっているマスを計算するためのラムダ式
+        auto const sum = [](auto const & vec) {
+            auto cnt = 0;
+            for (auto & e : vec) {
+                if (e.second) {
+                    cnt++;
+                }
+            }
+
+            return cnt;
+        };
+
+        probe.stage(STAGEINIT);
+
+        // ここから先でメモリを確保したら違反として数える（_CHECK_ALLOCATIONを定義してビルドしたときのみ）
+        checkpoint::NoAllocationScope const nas("抽選のループ");
+
+        // 無限ループ
+        for (auto n = 1; ; n++) {
+            // 乱数で数字を得る
+            auto const num = mr.myrand();
+            probe.count(RNGCALL);
+            probe.stage(STAGERNG);
+
+            // 乱数で得た数字で、かつまだ当たってないマスを検索
+            auto itr = boost::find(board, std::make_pair(num, false));
+            probe.count(BOARDSEARCH);
+            probe.stage(STAGESEARCH);
+
+            // そのようなマスがあった
+            if (itr != board.end()) {
+                // そのマスは当たったとし、フラグをtrueにする
+                itr->second = true;
+                trace.draw(n, num, static_cast<std::int32_t>(itr - board.begin()));
+            }
+            // そのようなマスがなかった
+            else {
+                probe.count(WASTEDDRAW);
+                trace.draw(n, num, -1);
+
+                //ループ続行
+                continue;
+            }
+
+            // 各行・列が埋まったかどうかをチェック
+            for (auto j = 0U; j < ROW; j++) {
+                // 各行が埋まったかどうかのフラグ
+                auto rowflag = true;
+
+                // 各行が埋まったかどうかをチェック
+                for (auto k = 0U; k < COLUMN; k++) {
+                    rowflag &= board[COLUMN * j + k].second;
+                }
+
+                probe.count(LINECHECK);
+
+                // 行の処理
+                if (rowflag &&
+                    // その行は既に埋まっているかどうか
+                    !rcfill[j]) {
+                    // その行は埋まったとして、フラグをtrueにする
+                    rcfill[j] = true;
+
+                    // 要した試行回数と、その時点で埋まったマスの数を格納
+                    fillnum.emplace_back(n, sum(board));
+                    probe.count(LINECOMPLETE);
+                    trace.line(n, static_cast<std::int32_t>(j), static_cast<std::int32_t>(fillnum.size()));
+                }
+
+                // 各列が埋まったかどうかのフラグ
+                auto columnflag = true;
+
+                // 各列が埋まったかどうかをチェック    
+                for (auto k = 0U; k < ROW; k++) {
+                    columnflag &= board[j + COLUMN * k].second;
+                }
+
+                probe.count(LINECHECK);
+
+                // 列の処理
+                if (columnflag &&
+                    // その列は既に埋まっているかどうか
+                    !rcfill[j + ROW]) {
+
+                    // その列は埋まったとして、フラグをtrueにする
+                    rcfill[j + ROW] = true;
+
+                    // 要した試行回数と、その時点で埋まったマスの数を格納
+                    fillnum.emplace_back(n, sum(board));
+                    probe.count(LINECOMPLETE);
+                    trace.line(n, static_cast<std::int32_t>(j + ROW), static_cast<std::int32_t>(fillnum.size()));
+                }
+            }
+
+            probe.stage(STAGELINECHECK);
+
+            // 要した試行回数と、その時点で埋まっている行・列の数を格納
+            fillnum2.emplace_back(n, static_cast<std::int32_t>(fillnum.size()));
+            probe.stage(STAGERECORD);
+
+            // 全ての行・列が埋まったかどうか
+            if (fillnum.size() == ROWCOLUMN) {
+                // 埋まったのでループ脱出
+                break;
+            }
+        }
+
+        // 要した試行関数の可変長配列を返す
+        return std::make_pair(std::move(fillnum), std::move(fillnum2));
+    }
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _MONTECARLO_H_
@@ -0,0 +1,224 @@
+﻿/*! \file tilting.h
+    \brief 重点サンプリングのために、新しいマスが当たるまでの待ち時間の分布を指数的に傾けた試行のクラスの宣言と実装
+    i個のマスが埋まっているときの待ち時間は、外れる確率q_i = i / BOARDSIZEの幾何分布に従う
+    外れる確率をq_i * exp(θ)にした分布から試行を生成し、マスの数ごとの尤度比（重み）をつけて返す
+    θ < 0なら抽選回数が少ない方の裾、θ > 0なら多い方の裾がよく出るようになる
+    テンプレートとインライン関数だけなので、ヘッダだけで完結する
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TILTING_H_
+#define _TILTING_H_
+
+#pragma once
+
+#include "geometric.h"
+#include <array>                                // for std::array
+#include <cmath>                                // for std::ceil, std::exp, std::log
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::int32_t
+#include <stdexcept>                            // for std::invalid_argument
+#include <string>                               // for std::to_string
+#include <utility>                              // for std::make_pair, std::pair
+#include <vector>                               // for std::vector
+
+namespace montecarlo {
+    //! A typedef.
+    /*!
+        m個目のマスが埋まった時点までの尤度比を、(m - 1)を添字として格納する配列の型
+    */
+    using weights_t = std::array<double, BOARDSIZE>;
+
+    //! A class.
+    /*!
+        新しいマスが当たるまでの待ち時間の分布を、パラメータθで指数的に傾けた試行を生成するクラス
+        待ち時間がwのときの尤度比は(1 - q_i) / (1 - q_i * exp(θ)) * exp(-θ(w - 1))で、
+        m個目のマスが埋まった時点までの尤度比は、それまでの待ち時間の尤度比の積になる
+        m個目のマスやn個目の行・列が埋まるまでの抽選回数には、その時点までの尤度比をつければよい
+        （その後の待ち時間の尤度比は期待値が1で、分散を増やすだけなので使わない）
+    */
+    class ExponentialTilting final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param theta 傾けるパラメータθ（q_(BOARDSIZE - 1) * exp(θ) < 1でなければならない）
+        */
+        explicit ExponentialTilting(double theta)
+            : theta_(theta)
+        {
+            if (!(theta < thetamax())) {
+                throw std::invalid_argument("θが大きすぎます");
+            }
+
+            for (auto i = 1U; i < BOARDSIZE; i++) {
+                auto const q = static_cast<double>(i) / static_cast<double>(BOARDSIZE);
+                auto const qt = q * std::exp(theta);
+
+                logq_[i] = std::log(qt);
+                logc_[i] = std::log((1.0 - q) / (1.0 - qt));
+            }
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ExponentialTilting() = default;
+
+        //! A copy constructor.
+        /*!
+            デフォルトコピーコンストラクタ
+        */
+        ExponentialTilting(ExponentialTilting const &) = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            傾けた分布での、全てのマスが埋まるまでの抽選回数の期待値を求める
+            \return 全てのマスが埋まるまでの抽選回数の期待値
+        */
+        double mean() const
+        {
+            return mean(theta_);
+        }
+
+        //! A public member function.
+        /*!
+            一様乱数の組から、傾けた分布の一回の試行の結果と、マスの数ごとの尤度比を求める
+            \param u (0, 1)の一様乱数の組
+            \param weights m個目のマスが埋まった時点までの尤度比を、(m - 1)を添字として格納する配列
+            \return montecarloImplと同じ形式の、行・列とマスの結果のstd::pair
+        */
+        std::pair<std::vector<mypair2>, std::vector<mypair2> > sample(uniforms_t const & u, weights_t & weights) const
+        {
+            auto logw = 0.0;
+            weights[0] = 1.0;
+
+            return montecarloGeometric(u, [this, &logw, &weights](std::size_t i, double ui) {
+                auto const w = static_cast<std::int32_t>(std::ceil(std::log(ui) / logq_[i]));
+
+                logw += logc_[i] - theta_ * static_cast<double>(w - 1);
+                weights[i] = std::exp(logw);
+
+                return w;
+            });
+        }
+
+        //! A public static member function.
+        /*!
+            全てのマスが埋まるまでの抽選回数の期待値が、指定された値になるようなθを二分法で求める
+            傾けるのは全てのマスが埋まるまでの分布だけなので、それより前の行・列やマスの裾には合わせていない
+            \param draws 全てのマスが埋まるまでの抽選回数の期待値（BOARDSIZEより大きい）
+            \return θ
+        */
+        static double solve(double draws)
+        {
+            if (!(draws > static_cast<double>(BOARDSIZE))) {
+                // 全てのマスが埋まるまでの抽選回数はBOARDSIZE以上なので、期待値をBOARDSIZE以下にするθはない
+                throw std::invalid_argument("rare-drawsは、全てのマスが埋まる平均試行回数を合わせる抽選回数なので、マスの数（" + std::to_string(BOARDSIZE) + "）より大きくしてください");
+            }
+
+            // 期待値はθについて単調に増加する
+            auto lo = -50.0, hi = thetamax();
+            for (auto i = 0; i < 200; i++) {
+                auto const mid = 0.5 * (lo + hi);
+                (mean(mid) < draws ? lo : hi) = mid;
+            }
+
+            return lo;
+        }
+
+        //! A public member function.
+        /*!
+            傾けるパラメータθを返す
+            \return θ
+        */
+        double theta() const
+        {
+            return theta_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private static member function.
+        /*!
+            傾けた分布での、全てのマスが埋まるまでの抽選回数の期待値を求める
+            \param theta θ
+            \return 全てのマスが埋まるまでの抽選回数の期待値
+        */
+        static double mean(double theta)
+        {
+            auto sum = 1.0;
+            for (auto i = 1U; i < BOARDSIZE; i++) {
+                sum += 1.0 / (1.0 - static_cast<double>(i) / static_cast<double>(BOARDSIZE) * std::exp(theta));
+            }
+
+            return sum;
+        }
+
+        //! A private static member function.
+        /*!
+            θの上限（最も大きいq_iをq_i * exp(θ) = 1にするθ）を求める
+            \return θの上限
+        */
+        static double thetamax()
+        {
+            return -std::log(static_cast<double>(BOARDSIZE - 1) / static_cast<double>(BOARDSIZE));
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            i個のマスが埋まっているときの、待ち時間の尤度比の対数の定数部分log((1 - q_i) / (1 - q_i * exp(θ)))
+        */
+        std::array<double, BOARDSIZE> logc_ = {};
+
+        //! A private member variable.
+        /*!
+            i個のマスが埋まっているときの、傾けた外れる確率の対数log(q_i * exp(θ))
+        */
+        std::array<double, BOARDSIZE> logq_ = {};
+
+        //! A private member variable.
+        /*!
+            傾けるパラメータθ
+        */
+        double theta_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ExponentialTilting() = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ExponentialTilting & operator=(ExponentialTilting const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _TILTING_H_
@@ -0,0 +1,98 @@
+﻿/*! \file trialblock.h
+    \brief 試行を、試行の番号で決まるブロックに分けて並列に行う関数の実装
+    乱数はブロックごとに一回だけ初期化し、ブロックの中の試行は、一つの乱数列で番号の順に行う
+    ブロックの境界は試行の番号だけで決まるので、シードを指定すれば、スレッド数とタスクの分け方によらず同じ結果になる
+    テンプレートとインライン関数だけなので、ヘッダだけで完結する
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TRIALBLOCK_H_
+#define _TRIALBLOCK_H_
+
+#pragma once
+
+#include "montecarlo.h"
+#ifdef HAVE_SSE2
+    #include "../myrandom/myrandsfmt.h"
+#else
+    #include "../myrandom/myrand.h"
+#endif
+#include <algorithm>                            // for std::max, std::min
+#include <cstdint>                              // for std::int32_t, std::uint64_t
+#include <optional>                             // for std::optional
+#include <tbb/parallel_for.h>                   // for tbb::parallel_for
+
+namespace montecarlo {
+    //! A global variable (constant expression).
+    /*!
+        一つの乱数列で続けて行う試行の数（試行の番号をこの数で割った商を、乱数列の番号にする。偶数でなければならない）
+        試行ごとに乱数を初期化するとSFMTの状態の初期化が試行より重いので、ブロックごとに一回だけ初期化する
+    */
+    static auto constexpr SEEDBLOCK = static_cast<std::uint64_t>(256);
+
+    //! A typedef.
+    /*!
+        一つのブロックの試行に使う自作乱数クラスの型
+    */
+#ifdef HAVE_SSE2
+    using blockrand_t = myrandom::MyRandSfmt;
+#else
+    using blockrand_t = myrandom::MyRand;
+#endif
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        ブロックの試行に使う自作乱数クラスのオブジェクトを作る
+        \param seed 乱数のシード（指定されていれば(seed, ブロックの番号)で初期化し、指定されていなければランダムデバイスから得る）
+        \param block ブロックの番号（試行の番号 / SEEDBLOCK）
+        \return 自作乱数クラスのオブジェクト
+    */
+    inline blockrand_t make_block_rand(std::optional<std::uint64_t> seed, std::uint64_t block)
+    {
+        return seed ? blockrand_t(1, static_cast<std::int32_t>(BOARDSIZE), *seed, block) : blockrand_t(1, static_cast<std::int32_t>(BOARDSIZE));
+    }
+
+    //! A function template.
+    /*!
+        [begin, end)の番号の試行を、SEEDBLOCK個ずつのブロックの単位で並列に行う
+        ブロックの中では、そのブロックのbegin以上end未満の試行を、stepずつ番号の順に行う
+        \param begin 最初の試行の番号（userandならSEEDBLOCKの倍数）
+        \param end 最後の試行の次の番号
+        \param step 一回に行う試行の数（対称変量法なら2。SEEDBLOCKの約数）
+        \param seed 乱数のシード
+        \param userand ブロックごとに乱数を初期化するかどうか（falseなら、bodyには乱数としてnullptrを渡す）
+        \param body (試行の番号, 自作乱数クラスのオブジェクトへのポインタ)を受け取る関数オブジェクト
+        \tparam MyRandom 自作乱数クラスの型（検証で乱数を取り替えるとき以外はblockrand_t）
+    */
+    template <typename MyRandom = blockrand_t, typename Body>
+    void for_each_trial(std::uint64_t begin, std::uint64_t end, std::uint64_t step, std::optional<std::uint64_t> seed, bool userand, Body const & body)
+    {
+        tbb::parallel_for(
+            begin / SEEDBLOCK,
+            (end + SEEDBLOCK - 1) / SEEDBLOCK,
+            static_cast<std::uint64_t>(1),
+            [begin, &body, end, seed, step, userand](auto block) {
+            std::optional<MyRandom> mr;
+            if (userand && seed) {
+                mr.emplace(1, static_cast<std::int32_t>(BOARDSIZE), *seed, block);
+            }
+            else if (userand) {
+                mr.emplace(1, static_cast<std::int32_t>(BOARDSIZE));
+            }
+
+            auto const first = std::max(begin, block * SEEDBLOCK);
+            auto const last = std::min(end, (block + 1) * SEEDBLOCK);
+            for (auto trial = first; trial < last; trial += step) {
+                body(trial, mr ? &*mr : nullptr);
+            }
+        });
+    }
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _TRIALBLOCK_H_
@@ -10,8 +10,8 @@
 
 #pragma once
 
-#include <cstdint>  // for std::int32_t
-#include <random>   // for std::mt19937, std::random_device
+#include <cstdint>  // for std::int32_t, std::uint32_t, std::uint64_t
+#include <random>   // for std::mt19937, std::random_device, std::seed_seq
 
 namespace myrandom {
     //! A class.
@@ -24,12 +24,24 @@ namespace myrandom {
     public:
         //! A constructor.
         /*!
-            唯一のコンストラクタ
+            コンストラクタ
+            シードはランダムデバイスから得る
             \param min 乱数分布の最小値
             \param max 乱数分布の最大値
         */
         MyRand(std::int32_t min, std::int32_t max);
 
+        //! A constructor.
+        /*!
+            シードを指定するコンストラクタ
+            (seed, stream)の組ごとに異なる乱数列になり、同じ組なら、どのスレッドで生成しても同じ乱数列になる
+            \param min 乱数分布の最小値
+            \param max 乱数分布の最大値
+            \param seed 乱数列全体のシード
+            \param stream 乱数列の番号（試行の番号など）
+        */
+        MyRand(std::int32_t min, std::int32_t max, std::uint64_t seed, std::uint64_t stream);
+
         //! A destructor.
         /*!
             デフォルトデストラクタ
@@ -49,6 +61,15 @@ namespace myrandom {
             return distribution_(randengine_);
         }
 
+        //!  A public member function.
+        /*!
+            (0, 1)の開区間で一様乱数を生成する（1 - uも(0, 1)に入る）
+        */
+        double myrand01()
+        {
+            return (static_cast<double>(randengine_()) + 0.5) * (1.0 / 4294967296.0);
+        }
+
         // #endregion メンバ関数
 
         // #region メンバ変数
@@ -101,6 +122,21 @@ namespace myrandom {
         // 乱数エンジン
         randengine_ = std::mt19937(rnd());
     }
+
+    inline MyRand::MyRand(std::int32_t min, std::int32_t max, std::uint64_t seed, std::uint64_t stream) :
+        distribution_(min, max)
+    {
+        // シードと乱数列の番号の両方から、乱数エンジンの初期状態を作る
+        std::seed_seq seq = {
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32),
+            static_cast<std::uint32_t>(stream),
+            static_cast<std::uint32_t>(stream >> 32)
+        };
+
+        // 乱数エンジン
+        randengine_ = std::mt19937(seq);
+    }
 }
 
 #endif  // _MYRAND_H_
@@ -11,7 +11,7 @@
 #pragma once
 
 #include "../../SFMT-src-1.5.1/SFMT.h"
-#include <cstdint>						// for std::int32_t
+#include <cstdint>						// for std::int32_t, std::uint32_t, std::uint64_t
 #include <random>                       // for std::random_device
 
 namespace myrandom {
@@ -25,12 +25,24 @@ namespace myrandom {
     public:
 		//! A constructor.
 		/*!
-			唯一のコンストラクタ
+			コンストラクタ
+			シードはランダムデバイスから得る
 			\param min 乱数分布の最小値
 			\param max 乱数分布の最大値
 		*/
         MyRandSfmt(std::int32_t min, std::int32_t max);
 
+		//! A constructor.
+		/*!
+			シードを指定するコンストラクタ
+			(seed, stream)の組ごとに異なる乱数列になり、同じ組なら、どのスレッドで生成しても同じ乱数列になる
+			\param min 乱数分布の最小値
+			\param max 乱数分布の最大値
+			\param seed 乱数列全体のシード
+			\param stream 乱数列の番号（試行の番号など）
+		*/
+        MyRandSfmt(std::int32_t min, std::int32_t max, std::uint64_t seed, std::uint64_t stream);
+
         //! A destructor.
         /*!
             デフォルトデストラクタ
@@ -50,6 +62,15 @@ namespace myrandom {
 			return static_cast<std::int32_t>(sfmt_genrand_uint32(&sfmt_) % (max_ - min_ + 1)) + min_;
         }
 
+        //!  A public member function.
+        /*!
+            (0, 1)の開区間で一様乱数を生成する（1 - uも(0, 1)に入る）
+        */
+        double myrand01()
+        {
+            return (static_cast<double>(sfmt_genrand_uint32(&sfmt_)) + 0.5) * (1.0 / 4294967296.0);
+        }
+
         // #endregion メンバ関数
 
         // #region メンバ変数
@@ -109,6 +130,22 @@ namespace myrandom {
         // 乱数エンジン
 		sfmt_init_gen_rand(&sfmt_, rnd());
     }
+
+    inline MyRandSfmt::MyRandSfmt(std::int32_t min, std::int32_t max, std::uint64_t seed, std::uint64_t stream)
+		: max_(max),
+		  min_(min)
+    {
+        // シードと乱数列の番号の両方を、初期化の鍵にする
+        std::uint32_t key[] = {
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32),
+            static_cast<std::uint32_t>(stream),
+            static_cast<std::uint32_t>(stream >> 32)
+        };
+
+        // 乱数エンジン
+		sfmt_init_by_array(&sfmt_, key, 4);
+    }
 }
 
 #endif  // _MYRANDSFMT_H_
@@ -0,0 +1,306 @@
+﻿/*! \file myrandsobol.h
+    \brief スクランブルしたSobol列で、(0, 1)^Dimの点を生成するクラスの宣言と実装
+    方向数はJoe and Kuo (2008)のnew-joe-kuo-6.21201の先頭の次元のもの
+    スクランブルは、ランダムな下三角行列による線形スクランブル（Matoušek）と、ランダムなデジタルシフト
+    スクランブルの乱数を変えた独立な複製の間のばらつきから、誤差を見積もれる（乱択準モンテカルロ法）
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _MYRANDSOBOL_H_
+#define _MYRANDSOBOL_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint32_t, std::uint64_t
+#include <random>   // for std::mt19937_64, std::random_device, std::seed_seq
+
+namespace myrandom {
+    //! A global variable (constant expression).
+    /*!
+        方向数を用意してある次元の数
+    */
+    static auto constexpr SOBOLDIMMAX = static_cast<std::size_t>(48);
+
+    //! A global variable (constant expression).
+    /*!
+        一つの座標のビット数（一つの複製で生成できる点の数は2^SOBOLBITS個まで）
+    */
+    static auto constexpr SOBOLBITS = 32U;
+
+    //! A structure.
+    /*!
+        一つの次元の方向数を作るための、原始多項式と初期値
+    */
+    struct SobolInitial {
+        //! A public member variable.
+        /*!
+            原始多項式の次数s
+        */
+        std::uint32_t s;
+
+        //! A public member variable.
+        /*!
+            原始多項式の係数（最高次と定数項を除く）を並べたビット列a
+        */
+        std::uint32_t a;
+
+        //! A public member variable.
+        /*!
+            方向数の初期値m_1, ..., m_s
+        */
+        std::array<std::uint32_t, 8> m;
+    };
+
+    //! A global variable (constant expression).
+    /*!
+        2次元目からSOBOLDIMMAX次元目までの方向数の原始多項式と初期値（1次元目はvan der Corput列）
+    */
+    static std::array<SobolInitial, SOBOLDIMMAX - 1> constexpr SOBOLINITIALS = { {
+        { 1,  0, { 1 } },
+        { 2,  1, { 1, 3 } },
+        { 3,  1, { 1, 3, 1 } },
+        { 3,  2, { 1, 1, 1 } },
+        { 4,  1, { 1, 1, 3, 3 } },
+        { 4,  4, { 1, 3, 5, 13 } },
+        { 5,  2, { 1, 1, 5, 5, 17 } },
+        { 5,  4, { 1, 1, 5, 5, 5 } },
+        { 5,  7, { 1, 1, 7, 11, 19 } },
+        { 5, 11, { 1, 1, 5, 1, 1 } },
+        { 5, 13, { 1, 1, 1, 3, 11 } },
+        { 5, 14, { 1, 3, 5, 5, 31 } },
+        { 6,  1, { 1, 3, 3, 9, 7, 49 } },
+        { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+        { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+        { 6, 19, { 1, 1, 1, 15, 7, 5 } },
+        { 6, 22, { 1, 3, 1, 15, 13, 25 } },
+        { 6, 25, { 1, 1, 5, 5, 19, 61 } },
+        { 7,  1, { 1, 3, 7, 11, 23, 15, 103 } },
+        { 7,  4, { 1, 3, 7, 13, 13, 15, 69 } },
+        { 7,  7, { 1, 1, 3, 13, 7, 35, 63 } },
+        { 7,  8, { 1, 3, 5, 9, 1, 25, 53 } },
+        { 7, 14, { 1, 3, 1, 13, 9, 35, 107 } },
+        { 7, 19, { 1, 3, 1, 5, 27, 61, 31 } },
+        { 7, 21, { 1, 1, 5, 11, 19, 41, 61 } },
+        { 7, 28, { 1, 3, 5, 3, 3, 13, 69 } },
+        { 7, 31, { 1, 1, 7, 13, 1, 19, 1 } },
+        { 7, 32, { 1, 3, 7, 5, 13, 19, 59 } },
+        { 7, 37, { 1, 1, 3, 9, 25, 29, 41 } },
+        { 7, 41, { 1, 3, 5, 13, 23, 1, 55 } },
+        { 7, 42, { 1, 3, 7, 3, 13, 59, 17 } },
+        { 7, 50, { 1, 3, 1, 3, 5, 53, 69 } },
+        { 7, 55, { 1, 1, 5, 5, 23, 33, 13 } },
+        { 7, 56, { 1, 1, 7, 7, 1, 61, 123 } },
+        { 7, 59, { 1, 1, 7, 9, 13, 61, 49 } },
+        { 7, 62, { 1, 3, 3, 5, 3, 55, 33 } },
+        { 8, 14, { 1, 3, 1, 15, 31, 13, 49, 245 } },
+        { 8, 21, { 1, 3, 5, 15, 31, 59, 63, 97 } },
+        { 8, 22, { 1, 3, 1, 11, 11, 11, 77, 249 } },
+        { 8, 38, { 1, 3, 1, 11, 27, 43, 71, 9 } },
+        { 8, 47, { 1, 1, 7, 15, 21, 11, 81, 45 } },
+        { 8, 49, { 1, 3, 7, 3, 25, 31, 65, 79 } },
+        { 8, 50, { 1, 3, 1, 1, 19, 11, 3, 205 } },
+        { 8, 52, { 1, 1, 5, 9, 19, 21, 29, 157 } },
+        { 8, 56, { 1, 3, 7, 11, 1, 33, 89, 185 } },
+        { 8, 67, { 1, 3, 3, 3, 15, 9, 79, 71 } },
+        { 8, 69, { 1, 3, 7, 11, 15, 39, 119, 27 } }
+    } };
+
+    //! A class template.
+    /*!
+        スクランブルしたSobol列の点を生成するクラス
+        点は番号から直接求めるので、どの順番で、どのスレッドで生成しても同じ点になる
+        \tparam Dim 次元の数（SOBOLDIMMAX以下）
+    */
+    template <std::size_t Dim>
+    class MyRandSobol final {
+        static_assert(Dim >= 1 && Dim <= SOBOLDIMMAX, "Dim must be between 1 and SOBOLDIMMAX");
+
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            コンストラクタ
+            スクランブルの乱数のシードはランダムデバイスから得る
+        */
+        MyRandSobol();
+
+        //! A constructor.
+        /*!
+            シードを指定するコンストラクタ
+            (seed, stream)の組ごとに異なるスクランブルになり、同じ組なら同じ点列になる
+            \param seed 乱数列全体のシード
+            \param stream スクランブルの番号（複製の番号など）
+        */
+        MyRandSobol(std::uint64_t seed, std::uint64_t stream);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~MyRandSobol() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function.
+        /*!
+            index番目の点を、(0, 1)の開区間の座標で求める
+            \param index 点の番号（2^SOBOLBITS未満）
+            \param u 点の座標を格納する配列
+        */
+        void point(std::uint32_t index, std::array<double, Dim> & u) const
+        {
+            // グレイコードの順番で並べた点なので、index ^ (index >> 1)の立っているビットの方向数を足し合わせる
+            auto const gray = index ^ (index >> 1);
+            for (auto d = 0U; d < Dim; d++) {
+                auto x = shift_[d];
+                for (auto g = gray, k = 0U; g; g >>= 1, k++) {
+                    if (g & 1U) {
+                        x ^= direction_[d][k];
+                    }
+                }
+
+                u[d] = (static_cast<double>(x) + 0.5) * (1.0 / 4294967296.0);
+            }
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            方向数を求め、乱数で線形スクランブルとデジタルシフトを行う
+            \param engine スクランブルに使う乱数エンジン
+        */
+        void initialize(std::mt19937_64 & engine);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            次元ごとの、スクランブルした方向数
+        */
+        std::array<std::array<std::uint32_t, SOBOLBITS>, Dim> direction_;
+
+        //! A private member variable.
+        /*!
+            次元ごとのデジタルシフト
+        */
+        std::array<std::uint32_t, Dim> shift_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        MyRandSobol(MyRandSobol const & dummy) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        MyRandSobol & operator=(MyRandSobol const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    template <std::size_t Dim>
+    MyRandSobol<Dim>::MyRandSobol()
+    {
+        // ランダムデバイス
+        std::random_device rnd;
+        std::seed_seq seq = { rnd(), rnd(), rnd(), rnd() };
+
+        std::mt19937_64 engine(seq);
+        initialize(engine);
+    }
+
+    template <std::size_t Dim>
+    MyRandSobol<Dim>::MyRandSobol(std::uint64_t seed, std::uint64_t stream)
+    {
+        // シードとスクランブルの番号の両方から、乱数エンジンの初期状態を作る
+        std::seed_seq seq = {
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32),
+            static_cast<std::uint32_t>(stream),
+            static_cast<std::uint32_t>(stream >> 32)
+        };
+
+        std::mt19937_64 engine(seq);
+        initialize(engine);
+    }
+
+    template <std::size_t Dim>
+    void MyRandSobol<Dim>::initialize(std::mt19937_64 & engine)
+    {
+        for (auto d = 0U; d < Dim; d++) {
+            // 方向数v_k = m_k / 2^k（上位ビットから並べる）
+            std::array<std::uint32_t, SOBOLBITS> v;
+            if (!d) {
+                for (auto k = 0U; k < SOBOLBITS; k++) {
+                    v[k] = 1U << (SOBOLBITS - 1 - k);
+                }
+            }
+            else {
+                auto const & init = SOBOLINITIALS[d - 1];
+                for (auto k = 0U; k < init.s; k++) {
+                    v[k] = init.m[k] << (SOBOLBITS - 1 - k);
+                }
+
+                // 漸化式v_k = a_1 v_(k-1) ^ ... ^ a_(s-1) v_(k-s+1) ^ v_(k-s) ^ (v_(k-s) >> s)
+                for (auto k = init.s; k < SOBOLBITS; k++) {
+                    v[k] = v[k - init.s] ^ (v[k - init.s] >> init.s);
+                    for (auto j = 1U; j < init.s; j++) {
+                        if ((init.a >> (init.s - 1 - j)) & 1U) {
+                            v[k] ^= v[k - j];
+                        }
+                    }
+                }
+            }
+
+            // 対角成分が1のランダムな下三角行列Lの行（上位の桁から数えてr番目の桁の出力に使う入力の桁）
+            std::array<std::uint32_t, SOBOLBITS> rows;
+            for (auto r = 0U; r < SOBOLBITS; r++) {
+                auto const diagonal = 1U << (SOBOLBITS - 1 - r);
+                auto const upper = static_cast<std::uint32_t>(~((static_cast<std::uint64_t>(diagonal) << 1) - 1));
+                rows[r] = diagonal | (static_cast<std::uint32_t>(engine()) & upper);
+            }
+
+            // 方向数にLを掛ける（出力のr番目の桁は、行と方向数の論理積のパリティ）
+            for (auto k = 0U; k < SOBOLBITS; k++) {
+                std::uint32_t x = 0;
+                for (auto r = 0U; r < SOBOLBITS; r++) {
+                    auto bits = rows[r] & v[k];
+                    auto parity = 0U;
+                    for (; bits; bits &= bits - 1) {
+                        parity ^= 1U;
+                    }
+
+                    x |= parity << (SOBOLBITS - 1 - r);
+                }
+
+                direction_[d][k] = x;
+            }
+
+            shift_[d] = static_cast<std::uint32_t>(engine());
+        }
+    }
+}
+
+#endif  // _MYRANDSOBOL_H_
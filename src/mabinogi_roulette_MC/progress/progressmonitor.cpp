@@ -0,0 +1,251 @@
+﻿/*! \file progressmonitor.cpp
+    \brief TBBのスケジューラを監視して、進捗と稼働状況を表示するクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "progressmonitor.h"
+#include <algorithm>                    // for std::min
+#include <iostream>                     // for std::cerr, std::cout
+#include <boost/format.hpp>             // for boost::format
+#include <tbb/task_arena.h>             // for tbb::this_task_arena::max_concurrency
+
+namespace progress {
+    namespace {
+        //! A function.
+        /*!
+            時間をミリ秒に変換する
+            \param nsec 時間(nsec)
+            \return 時間(msec)
+        */
+        double to_msec(std::int64_t nsec);
+
+        //! A function.
+        /*!
+            時刻をナノ秒に変換する
+            \param tp 時刻
+            \return 時刻(nsec)
+        */
+        std::int64_t to_nsec(checkpoint::Clock::time_point tp);
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドの枠を持っている監視クラスのオブジェクト
+        */
+        thread_local ProgressMonitor const * slotowner = nullptr;
+
+        //! A global variable (thread local).
+        /*!
+            このスレッドの枠の番号
+        */
+        thread_local std::int32_t slotindex = 0;
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    ProgressMonitor::ProgressMonitor(std::uint64_t total, std::chrono::milliseconds interval)
+        :   active_(0),
+            begin_(checkpoint::Clock::now()),
+            end_(),
+            interval_(interval),
+            peak_(0),
+            slots_(),
+            slotnum_(0),
+            stopped_(false),
+            total_(total)
+    {
+        observe(true);
+
+        if (interval_.count() > 0) {
+            reporter_ = std::thread([this] { report(); });
+        }
+    }
+
+    ProgressMonitor::~ProgressMonitor()
+    {
+        stop();
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void ProgressMonitor::on_scheduler_entry(bool worker)
+    {
+        auto & slot = this_thread_slot();
+        slot.worker.store(worker, std::memory_order_relaxed);
+        slot.entered.store(to_nsec(checkpoint::Clock::now()), std::memory_order_relaxed);
+
+        // 同時に入っていたスレッドの数の最大値を更新する
+        auto const active = ++active_;
+        auto peak = peak_.load();
+        while (active > peak && !peak_.compare_exchange_weak(peak, active)) {
+        }
+    }
+
+    void ProgressMonitor::on_scheduler_exit(bool)
+    {
+        auto & slot = this_thread_slot();
+        auto const entered = slot.entered.exchange(0, std::memory_order_relaxed);
+        if (entered) {
+            slot.arena.fetch_add(to_nsec(checkpoint::Clock::now()) - entered, std::memory_order_relaxed);
+        }
+
+        --active_;
+    }
+
+    void ProgressMonitor::print() const
+    {
+        auto const end = stopped_ ? end_ : checkpoint::Clock::now();
+        auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin_).count();
+        if (elapsed <= 0) {
+            return;
+        }
+
+        std::cout << "スレッドごとの稼働状況\n";
+
+        std::uint64_t trials = 0;
+        std::uint64_t draws = 0;
+        auto busy = 0LL;
+
+        auto const num = std::min(slotnum_.load(), MAXTHREADS);
+        for (auto i = 0; i < num; i++) {
+            auto const & slot = slots_[i];
+            auto const t = slot.trials.load(std::memory_order_relaxed);
+            auto const b = slot.busy.load(std::memory_order_relaxed);
+
+            // まだスケジューラから出ていなければ、止めた時刻までを加える
+            auto arena = slot.arena.load(std::memory_order_relaxed);
+            if (auto const entered = slot.entered.load(std::memory_order_relaxed)) {
+                arena += to_nsec(end) - entered;
+            }
+
+            std::cout << boost::format("  スレッド%d (%s): 試行 = %d回, 試行の時間 = %.1f (msec), スケジューラ内の時間 = %.1f (msec), 稼働率 = %.1f%%\n")
+                         % i
+                         % (slot.worker.load(std::memory_order_relaxed) ? "ワーカー" : "外部")
+                         % t
+                         % to_msec(b)
+                         % to_msec(arena)
+                         % (100.0 * static_cast<double>(b) / static_cast<double>(elapsed));
+
+            trials += t;
+            draws += slot.draws.load(std::memory_order_relaxed);
+            busy += b;
+        }
+
+        auto const sec = static_cast<double>(elapsed) * 1.0E-9;
+        auto const concurrency = tbb::this_task_arena::max_concurrency();
+
+        std::cout << boost::format("  全体: 経過時間 = %.1f (msec), 試行 = %.0f回/s, 抽選 = %.0f回/s, 同時に稼働したスレッドの最大数 = %d/%d, 並列化効率 = %.1f%%\n")
+                     % to_msec(elapsed)
+                     % (static_cast<double>(trials) / sec)
+                     % (static_cast<double>(draws) / sec)
+                     % peak_.load()
+                     % concurrency
+                     % (100.0 * static_cast<double>(busy) / (static_cast<double>(elapsed) * static_cast<double>(concurrency)));
+    }
+
+    void ProgressMonitor::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (stopped_) {
+                return;
+            }
+
+            stopped_ = true;
+            end_ = checkpoint::Clock::now();
+        }
+
+        stopcv_.notify_all();
+        if (reporter_.joinable()) {
+            reporter_.join();
+        }
+
+        observe(false);
+    }
+
+    void ProgressMonitor::trial_done(std::int32_t draws, checkpoint::Clock::duration elapsed)
+    {
+        // 書き込むのはこのスレッドだけなので、fetch_addではなくloadとstoreで足す
+        auto & slot = this_thread_slot();
+        slot.trials.store(slot.trials.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        slot.draws.store(slot.draws.load(std::memory_order_relaxed) + static_cast<std::uint64_t>(draws), std::memory_order_relaxed);
+        slot.busy.store(
+            slot.busy.load(std::memory_order_relaxed) + std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+            std::memory_order_relaxed);
+    }
+
+    ProgressMonitor::Slot & ProgressMonitor::this_thread_slot()
+    {
+        if (slotowner != this) {
+            slotowner = this;
+            slotindex = std::min(slotnum_.fetch_add(1, std::memory_order_relaxed), MAXTHREADS - 1);
+        }
+
+        return slots_[slotindex];
+    }
+
+    void ProgressMonitor::report()
+    {
+        auto const concurrency = tbb::this_task_arena::max_concurrency();
+
+        auto prevtime = begin_;
+        std::uint64_t prevtrials = 0;
+        std::uint64_t prevdraws = 0;
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!stopcv_.wait_for(lock, interval_, [this] { return stopped_; })) {
+            auto const now = checkpoint::Clock::now();
+
+            std::uint64_t trials = 0;
+            std::uint64_t draws = 0;
+            auto busy = 0LL;
+
+            auto const num = std::min(slotnum_.load(), MAXTHREADS);
+            for (auto i = 0; i < num; i++) {
+                trials += slots_[i].trials.load(std::memory_order_relaxed);
+                draws += slots_[i].draws.load(std::memory_order_relaxed);
+                busy += slots_[i].busy.load(std::memory_order_relaxed);
+            }
+
+            auto const elapsed = std::chrono::duration<double>(now - begin_).count();
+            auto const interval = std::chrono::duration<double>(now - prevtime).count();
+
+            // 残り時間は、始めてからの平均の速さで見積もる
+            auto const remaining = trials ?
+                elapsed * static_cast<double>(total_ - std::min(trials, total_)) / static_cast<double>(trials) :
+                0.0;
+
+            std::cerr << boost::format("進捗 %5.1f%% (%d/%d), 試行 = %.0f回/s, 抽選 = %.0f回/s, 残り約 %.1f s, 稼働スレッド = %d/%d, 並列化効率 = %.1f%%\n")
+                         % (100.0 * static_cast<double>(trials) / static_cast<double>(total_))
+                         % trials
+                         % total_
+                         % (static_cast<double>(trials - prevtrials) / interval)
+                         % (static_cast<double>(draws - prevdraws) / interval)
+                         % remaining
+                         % active_.load()
+                         % concurrency
+                         % (100.0 * static_cast<double>(busy) * 1.0E-9 / (elapsed * static_cast<double>(concurrency)));
+
+            prevtime = now;
+            prevtrials = trials;
+            prevdraws = draws;
+        }
+    }
+
+    // #endregion メンバ関数
+
+    namespace {
+        double to_msec(std::int64_t nsec)
+        {
+            return static_cast<double>(nsec) * 1.0E-6;
+        }
+
+        std::int64_t to_nsec(checkpoint::Clock::time_point tp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+        }
+    }
+}
@@ -0,0 +1,261 @@
+﻿/*! \file progressmonitor.h
+    \brief TBBのスケジューラを監視して、進捗と稼働状況を表示するクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _PROGRESSMONITOR_H_
+#define _PROGRESSMONITOR_H_
+
+#pragma once
+
+#include "../../checkpoint/profiler.h"
+#include <array>                        // for std::array
+#include <atomic>                       // for std::atomic
+#include <chrono>                       // for std::chrono::milliseconds
+#include <condition_variable>           // for std::condition_variable
+#include <cstdint>                      // for std::int32_t, std::int64_t, std::uint64_t
+#include <mutex>                        // for std::mutex
+#include <thread>                       // for std::thread
+#include <tbb/task_scheduler_observer.h>    // for tbb::task_scheduler_observer
+
+namespace progress {
+    //! A class.
+    /*!
+        TBBのスケジューラに出入りするスレッドを監視して、進捗と稼働状況を集計するクラス
+        生成すると監視を始め、一定間隔で標準エラー出力に進捗を表示する
+    */
+    class ProgressMonitor final : public tbb::task_scheduler_observer {
+        // #region クラス内クラスの宣言
+
+        //! A structure.
+        /*!
+            一つのスレッドの集計結果を記録する枠
+            書き込むのはそのスレッドだけだが、表示するスレッドから読むためアトミック変数にする
+        */
+        struct alignas(64) Slot {
+            //! A public member variable.
+            /*!
+                終わった試行回数
+            */
+            std::atomic<std::uint64_t> trials;
+
+            //! A public member variable.
+            /*!
+                抽選回数の合計
+            */
+            std::atomic<std::uint64_t> draws;
+
+            //! A public member variable.
+            /*!
+                試行にかかった時間の合計(nsec)
+            */
+            std::atomic<std::int64_t> busy;
+
+            //! A public member variable.
+            /*!
+                スケジューラに入っていた時間の合計(nsec)
+            */
+            std::atomic<std::int64_t> arena;
+
+            //! A public member variable.
+            /*!
+                スケジューラに入った時刻(nsec)（入っていなければ0）
+            */
+            std::atomic<std::int64_t> entered;
+
+            //! A public member variable.
+            /*!
+                TBBのワーカースレッドかどうか
+            */
+            std::atomic<bool> worker;
+        };
+
+        // #endregion クラス内クラスの宣言
+
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param total 全体の試行回数
+            \param interval 進捗を表示する間隔（0なら表示しない）
+        */
+        ProgressMonitor(std::uint64_t total, std::chrono::milliseconds interval);
+
+        //! A destructor.
+        /*!
+            デストラクタ
+        */
+        ~ProgressMonitor() override;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            スレッドがスケジューラに入ったときに呼ばれる
+            \param worker TBBのワーカースレッドかどうか
+        */
+        void on_scheduler_entry(bool worker) override;
+
+        //! A public member function.
+        /*!
+            スレッドがスケジューラから出たときに呼ばれる
+            \param worker TBBのワーカースレッドかどうか
+        */
+        void on_scheduler_exit(bool worker) override;
+
+        //! A public member function.
+        /*!
+            スレッドごとの稼働状況と、全体の処理速度と並列化効率を表示する
+            stopを呼んだスレッドから呼ぶこと
+        */
+        void print() const;
+
+        //! A public member function.
+        /*!
+            監視と進捗の表示を止める
+        */
+        void stop();
+
+        //! A public member function.
+        /*!
+            一つの試行が終わったことを記録する
+            \param draws その試行の抽選回数
+            \param elapsed その試行にかかった時間
+        */
+        void trial_done(std::int32_t draws, checkpoint::Clock::duration elapsed);
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            呼び出したスレッドの枠を返す
+            \return 呼び出したスレッドの枠
+        */
+        Slot & this_thread_slot();
+
+        //! A private member function.
+        /*!
+            一定間隔で進捗を標準エラー出力に表示する
+        */
+        void report();
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant expression).
+        /*!
+            スレッドごとに集計結果を記録する枠の数（これを超えたスレッドは最後の枠を共有する）
+        */
+        static auto constexpr MAXTHREADS = 256;
+
+        //! A private member variable.
+        /*!
+            スケジューラに入っているスレッドの数
+        */
+        std::atomic<std::int32_t> active_;
+
+        //! A private member variable.
+        /*!
+            監視を始めた時刻
+        */
+        checkpoint::Clock::time_point const begin_;
+
+        //! A private member variable.
+        /*!
+            監視を止めた時刻
+        */
+        checkpoint::Clock::time_point end_;
+
+        //! A private member variable (constant).
+        /*!
+            進捗を表示する間隔
+        */
+        std::chrono::milliseconds const interval_;
+
+        //! A private member variable.
+        /*!
+            reporter_を止めるためのミューテックス
+        */
+        std::mutex mtx_;
+
+        //! A private member variable.
+        /*!
+            スケジューラに同時に入っていたスレッドの数の最大値
+        */
+        std::atomic<std::int32_t> peak_;
+
+        //! A private member variable.
+        /*!
+            進捗を表示するスレッド
+        */
+        std::thread reporter_;
+
+        //! A private member variable.
+        /*!
+            スレッドごとの枠
+        */
+        std::array<Slot, MAXTHREADS> slots_;
+
+        //! A private member variable.
+        /*!
+            使われている枠の数
+        */
+        std::atomic<std::int32_t> slotnum_;
+
+        //! A private member variable.
+        /*!
+            監視を止めたかどうか
+        */
+        bool stopped_;
+
+        //! A private member variable.
+        /*!
+            reporter_を止めるための条件変数
+        */
+        std::condition_variable stopcv_;
+
+        //! A private member variable (constant).
+        /*!
+            全体の試行回数
+        */
+        std::uint64_t const total_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ProgressMonitor() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ProgressMonitor(ProgressMonitor const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ProgressMonitor & operator=(ProgressMonitor const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _PROGRESSMONITOR_H_
@@ -0,0 +1,217 @@
+﻿/*! \file batchmeans.cpp
+    \brief 試行をバッチに分けて、バッチごとのヒストグラムから統計量の標準誤差を求めるクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "batchmeans.h"
+#include <cmath>                // for std::sqrt
+#include <cstdint>              // for std::int32_t, std::uint32_t, std::uint64_t
+#include <limits>               // for std::numeric_limits
+#include <random>               // for std::mt19937_64, std::seed_seq, std::uniform_int_distribution
+#include <utility>              // for std::move
+#include <tbb/parallel_for.h>   // for tbb::parallel_for
+
+namespace statistics {
+    namespace {
+        //! A function.
+        /*!
+            複製ごとの、(n + 1)個目ごとの統計量から、(n + 1)個目ごとに複製の間の標準偏差を求める
+            \param values 複製ごとの、(n + 1)個目ごとの統計量
+            \param size 行・列またはマスの総数
+            \return (n + 1)個目ごとの標準偏差の可変長配列
+        */
+        std::vector<double> replicate_std_deviation(std::vector< std::vector<double> > const & values, std::size_t size);
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    BatchMeans::BatchMeans(std::size_t size, std::size_t maxbatches)
+        : maxbatches_(maxbatches), size_(size)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    void BatchMeans::add(LevelAccumulator const & acc)
+    {
+        if (batches_.size() >= maxbatches_) {
+            // (2i)番目と(2i + 1)番目のバッチを一つにまとめ、バッチの数を半分にする
+            auto const half = batches_.size() / 2;
+            for (auto i = 0U; i < half; i++) {
+                auto merged = std::move(batches_[2 * i]);
+                for (auto n = 0U; n < size_; n++) {
+                    merged[n].merge(batches_[2 * i + 1][n]);
+                }
+
+                batches_[i] = std::move(merged);
+                fillsums_[i] = fillsums_[2 * i] + fillsums_[2 * i + 1];
+            }
+
+            if (batches_.size() % 2) {
+                batches_[half] = std::move(batches_.back());
+                fillsums_[half] = std::move(fillsums_.back());
+                batches_.resize(half + 1);
+                fillsums_.resize(half + 1);
+            }
+            else {
+                batches_.resize(half);
+                fillsums_.resize(half);
+            }
+        }
+
+        batches_.push_back(acc.histograms());
+        fillsums_.push_back(acc.fillavg() * static_cast<double>(acc.trials()));
+    }
+
+    std::vector<double> BatchMeans::mean_se() const
+    {
+        return standard_error([this](auto i, auto n) { return batches_[i][n].mean(); });
+    }
+
+    std::vector<double> BatchMeans::quantile_se(double p) const
+    {
+        return standard_error([this, p](auto i, auto n) { return static_cast<double>(batches_[i][n].quantile(p)); });
+    }
+
+    SummarySe BatchMeans::summary_se(std::size_t replicates, std::uint64_t seed) const
+    {
+        SummarySe se;
+        se.mean = mean_se();
+        se.std_deviation = standard_error([this](auto i, auto n) { return batches_[i][n].std_deviation(); });
+        se.fillavg = standard_error([this](auto i, auto n) {
+            auto const total = batches_[i][n].total();
+            return total ? fillsums_[i][n] / static_cast<double>(total) : 0.0;
+        });
+
+        bootstrap(replicates, seed, se);
+
+        return se;
+    }
+
+    void BatchMeans::bootstrap(std::size_t replicates, std::uint64_t seed, SummarySe & se) const
+    {
+        auto const b = batches_.size();
+        se.median.assign(size_, std::numeric_limits<double>::infinity());
+        se.mode.assign(size_, std::numeric_limits<double>::infinity());
+        if (b < 2 || replicates < 2) {
+            return;
+        }
+
+        // 複製ごとの、(n + 1)個目ごとの中央値と最頻値
+        std::vector< std::vector<double> > medians(replicates, std::vector<double>(size_));
+        std::vector< std::vector<double> > modes(replicates, std::vector<double>(size_));
+
+        tbb::parallel_for(
+            static_cast<std::size_t>(0),
+            replicates,
+            [this, b, &medians, &modes, seed](auto r) {
+            // 複製の番号から乱数の状態を決めるので、スレッドの割り当てによらず同じ結果になる
+            std::seed_seq seq = {
+                static_cast<std::uint32_t>(seed),
+                static_cast<std::uint32_t>(seed >> 32),
+                static_cast<std::uint32_t>(r),
+                static_cast<std::uint32_t>(static_cast<std::uint64_t>(r) >> 32)
+            };
+            std::mt19937_64 engine(seq);
+            std::uniform_int_distribution<std::size_t> dist(0, b - 1);
+
+            // バッチごとの、復元抽出で選ばれた回数
+            std::vector<std::uint64_t> multiplicity(b, 0);
+            for (auto i = 0U; i < b; i++) {
+                multiplicity[dist(engine)]++;
+            }
+
+            for (auto n = 0U; n < size_; n++) {
+                Histogram hist;
+                for (auto i = 0U; i < b; i++) {
+                    if (!multiplicity[i]) {
+                        continue;
+                    }
+
+                    auto const & counts = batches_[i][n].counts();
+                    for (auto v = 0U; v < counts.size(); v++) {
+                        if (counts[v]) {
+                            hist.add(static_cast<std::int32_t>(v), multiplicity[i] * counts[v]);
+                        }
+                    }
+                }
+
+                medians[r][n] = static_cast<double>(hist.median());
+                modes[r][n] = static_cast<double>(hist.mode());
+            }
+        });
+
+        se.median = replicate_std_deviation(medians, size_);
+        se.mode = replicate_std_deviation(modes, size_);
+    }
+
+    template <typename Statistic>
+    std::vector<double> BatchMeans::standard_error(Statistic statistic) const
+    {
+        auto const b = batches_.size();
+        std::vector<double> se(size_, std::numeric_limits<double>::infinity());
+        if (b < 2) {
+            return se;
+        }
+
+        std::vector<double> values(b), weights(b);
+        for (auto n = 0U; n < size_; n++) {
+            // バッチごとの統計量と、試行回数の割合による重み
+            auto total = 0.0;
+            for (auto i = 0U; i < b; i++) {
+                values[i] = statistic(i, n);
+                weights[i] = static_cast<double>(batches_[i][n].total());
+                total += weights[i];
+            }
+
+            auto avg = 0.0;
+            for (auto i = 0U; i < b; i++) {
+                weights[i] /= total;
+                avg += weights[i] * values[i];
+            }
+
+            // Var = b / (b - 1) * Σ w_i^2 (x_i - avg)^2（バッチの大きさが等しければ、バッチ平均の分散 / b になる）
+            auto sum = 0.0;
+            for (auto i = 0U; i < b; i++) {
+                auto const d = values[i] - avg;
+                sum += weights[i] * weights[i] * d * d;
+            }
+
+            se[n] = std::sqrt(sum * static_cast<double>(b) / static_cast<double>(b - 1));
+        }
+
+        return se;
+    }
+
+    // #endregion メンバ関数
+
+    namespace {
+        std::vector<double> replicate_std_deviation(std::vector< std::vector<double> > const & values, std::size_t size)
+        {
+            auto const r = static_cast<double>(values.size());
+
+            std::vector<double> sd(size);
+            for (auto n = 0U; n < size; n++) {
+                auto avg = 0.0;
+                for (auto const & v : values) {
+                    avg += v[n];
+                }
+                avg /= r;
+
+                auto sum = 0.0;
+                for (auto const & v : values) {
+                    auto const d = v[n] - avg;
+                    sum += d * d;
+                }
+
+                sd[n] = std::sqrt(sum / (r - 1.0));
+            }
+
+            return sd;
+        }
+    }
+}
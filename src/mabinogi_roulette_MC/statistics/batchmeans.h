@@ -0,0 +1,215 @@
+﻿/*! \file batchmeans.h
+    \brief 試行をバッチに分けて、バッチごとのヒストグラムから統計量の標準誤差を求めるクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BATCHMEANS_H_
+#define _BATCHMEANS_H_
+
+#pragma once
+
+#include "histogram.h"
+#include "levelaccumulator.h"
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::uint64_t
+#include <valarray>             // for std::valarray
+#include <vector>               // for std::vector
+
+namespace statistics {
+    //! A structure.
+    /*!
+        (n + 1)個目ごとの、表示する統計量の標準誤差を格納する構造体
+    */
+    struct SummarySe {
+        //! A public member variable.
+        /*!
+            平均の標準誤差（バッチ平均法）
+        */
+        std::vector<double> mean;
+
+        //! A public member variable.
+        /*!
+            中央値の標準誤差（ブートストラップ法）
+        */
+        std::vector<double> median;
+
+        //! A public member variable.
+        /*!
+            最頻値の標準誤差（ブートストラップ法）
+        */
+        std::vector<double> mode;
+
+        //! A public member variable.
+        /*!
+            標準偏差の標準誤差（バッチ平均法）
+        */
+        std::vector<double> std_deviation;
+
+        //! A public member variable.
+        /*!
+            埋まっているマスまたは行・列の平均個数の標準誤差（バッチ平均法）
+        */
+        std::vector<double> fillavg;
+    };
+
+    //! A class.
+    /*!
+        (n + 1)個目ごとの試行回数のヒストグラムを、バッチごとに保持するクラス
+        バッチごとの統計量のばらつきから、全体の統計量の標準誤差を求める（バッチ平均法）
+        バッチの大きさが異なるときは、試行回数で重みをつける
+        中央値と最頻値は、バッチを復元抽出して足し合わせたヒストグラムから求める（ブートストラップ法）
+        バッチの数が上限に達したら隣り合うバッチを二つずつまとめるので、試行回数によらずメモリ使用量は一定になる
+    */
+    class BatchMeans final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param size 行・列またはマスの総数
+            \param maxbatches 保持するバッチの数の上限（2以上の偶数）
+        */
+        explicit BatchMeans(std::size_t size, std::size_t maxbatches = 128);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~BatchMeans() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            一つのバッチの結果を加える
+            バッチの数が上限に達していたら、先に隣り合うバッチを二つずつまとめる
+            \param acc そのバッチの集計結果
+        */
+        void add(LevelAccumulator const & acc);
+
+        //! A public member function.
+        /*!
+            加えたバッチの数を返す
+            \return バッチの数
+        */
+        std::size_t batches() const
+        {
+            return batches_.size();
+        }
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとに、平均の標準誤差を求める
+            バッチが二つ未満なら無限大を返す
+            \return (n + 1)個目ごとの平均の標準誤差の可変長配列
+        */
+        std::vector<double> mean_se() const;
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとに、p分位点の標準誤差を求める
+            バッチが二つ未満なら無限大を返す
+            \param p 割合（0 < p < 1）
+            \return (n + 1)個目ごとのp分位点の標準誤差の可変長配列
+        */
+        std::vector<double> quantile_se(double p) const;
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとに、表示する全ての統計量の標準誤差を求める
+            平均、標準偏差、埋まっている個数の平均はバッチ平均法で求める
+            中央値と最頻値は、バッチごとに求めるとばらつきが大きく偏るので、ブートストラップ法で求める
+            バッチが二つ未満なら無限大を返す
+            \param replicates ブートストラップ法の復元抽出の回数（2未満なら中央値と最頻値の標準誤差は無限大になる）
+            \param seed ブートストラップ法の乱数のシード
+            \return (n + 1)個目ごとの統計量の標準誤差
+        */
+        SummarySe summary_se(std::size_t replicates, std::uint64_t seed) const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            バッチを復元抽出して足し合わせたヒストグラムから、中央値と最頻値を求めることを繰り返し、
+            (n + 1)個目ごとに、複製の間の標準偏差を標準誤差として求める
+            復元抽出は複製ごとに独立な乱数で並列に行うので、同じシードなら実行するたびに同じ結果になる
+            \param replicates 復元抽出の回数
+            \param seed 乱数のシード
+            \param se 中央値と最頻値の標準誤差を書き込む構造体
+        */
+        void bootstrap(std::size_t replicates, std::uint64_t seed, SummarySe & se) const;
+
+        //! A private member function template.
+        /*!
+            (n + 1)個目ごとに、バッチごとの統計量の重み付きのばらつきから、全体の統計量の標準誤差を求める
+            \param statistic (バッチの番号, n)から統計量を求める関数オブジェクト
+            \return (n + 1)個目ごとの標準誤差の可変長配列
+        */
+        template <typename Statistic>
+        std::vector<double> standard_error(Statistic statistic) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            バッチごとの、(n + 1)個目ごとの試行回数のヒストグラム
+        */
+        std::vector< std::vector<Histogram> > batches_;
+
+        //! A private member variable.
+        /*!
+            バッチごとの、(n + 1)個目ごとの埋まっているマスまたは行・列の数の総和
+        */
+        std::vector< std::valarray<double> > fillsums_;
+
+        //! A private member variable (constant).
+        /*!
+            保持するバッチの数の上限
+        */
+        std::size_t const maxbatches_;
+
+        //! A private member variable (constant).
+        /*!
+            行・列またはマスの総数
+        */
+        std::size_t const size_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        BatchMeans() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        BatchMeans(BatchMeans const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        BatchMeans & operator=(BatchMeans const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _BATCHMEANS_H_
@@ -0,0 +1,176 @@
+﻿/*! \file histogram.cpp
+    \brief 小さな非負の整数の度数を数える、密なヒストグラムのクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "histogram.h"
+#include <algorithm>                                // for std::clamp, std::max
+#include <cmath>                                    // for std::ceil, std::floor, std::sqrt
+#include <boost/format.hpp>                         // for boost::format
+#include <boost/math/special_functions/erf.hpp>     // for boost::math::erf_inv
+
+namespace statistics {
+    // #region コンストラクタ・デストラクタ
+
+    Histogram::Histogram(std::int32_t bins)
+        : counts_(static_cast<std::size_t>(std::max(bins, 0)), 0)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    double Histogram::mean() const
+    {
+        if (!total_) {
+            return 0.0;
+        }
+
+        // 総和は整数で求めるので、丸め誤差はなく、割り算の一回だけになる
+        std::uint64_t sum = 0;
+        for (auto v = 0U; v < counts_.size(); v++) {
+            sum += static_cast<std::uint64_t>(v) * counts_[v];
+        }
+
+        return static_cast<double>(sum) / static_cast<double>(total_);
+    }
+
+    std::pair<double, double> Histogram::mean_ci(double confidence) const
+    {
+        auto const avg = mean();
+        if (total_ < 2) {
+            return std::make_pair(avg, avg);
+        }
+
+        // 標本標準偏差（不偏分散の平方根）から標準誤差を求める
+        auto const n = static_cast<double>(total_);
+        auto const sd = std_deviation() * std::sqrt(n / (n - 1.0));
+        auto const half = normal_critical_value(confidence) * sd / std::sqrt(n);
+
+        return std::make_pair(avg - half, avg + half);
+    }
+
+    std::int32_t Histogram::median() const
+    {
+        if (!total_) {
+            return 0;
+        }
+
+        if (total_ % 2) {
+            // 度数の合計が奇数なら中央の値を返す
+            return value_at((total_ - 1) / 2);
+        }
+        else {
+            // 度数の合計が偶数なら中央二つの平均を返す
+            return (value_at(total_ / 2 - 1) + value_at(total_ / 2)) / 2;
+        }
+    }
+
+    void Histogram::merge(Histogram const & other)
+    {
+        if (other.counts_.size() > counts_.size()) {
+            counts_.resize(other.counts_.size(), 0);
+        }
+
+        for (auto v = 0U; v < other.counts_.size(); v++) {
+            counts_[v] += other.counts_[v];
+        }
+
+        total_ += other.total_;
+    }
+
+    std::int32_t Histogram::mode() const
+    {
+        auto mode = 0U;
+        for (auto v = 1U; v < counts_.size(); v++) {
+            if (counts_[v] > counts_[mode]) {
+                mode = v;
+            }
+        }
+
+        return static_cast<std::int32_t>(mode);
+    }
+
+    void Histogram::outputcsv(std::ostream & os) const
+    {
+        for (auto v = 0U; v < counts_.size(); v++) {
+            if (counts_[v]) {
+                os << boost::format("%d,%d\n") % v % counts_[v];
+            }
+        }
+    }
+
+    std::int32_t Histogram::quantile(double p) const
+    {
+        if (!total_) {
+            return 0;
+        }
+
+        // 順位ceil(n × p)（1から始まる）の値
+        auto const rank = static_cast<std::uint64_t>(std::ceil(static_cast<double>(total_) * p));
+
+        return value_at(std::clamp<std::uint64_t>(rank, 1, total_) - 1);
+    }
+
+    std::pair<std::int32_t, std::int32_t> Histogram::quantile_ci(double p, double confidence) const
+    {
+        if (!total_) {
+            return std::make_pair(0, 0);
+        }
+
+        // p分位点より小さい標本の数は二項分布Bin(n, p)に従うので、
+        // その信頼区間の両端を順位とする順序統計量を区間の両端にする
+        auto const n = static_cast<double>(total_);
+        auto const half = normal_critical_value(confidence) * std::sqrt(n * p * (1.0 - p));
+        auto const lower = std::clamp(std::floor(n * p - half), 1.0, n);
+        auto const upper = std::clamp(std::ceil(n * p + half), 1.0, n);
+
+        return std::make_pair(
+            value_at(static_cast<std::uint64_t>(lower) - 1),
+            value_at(static_cast<std::uint64_t>(upper) - 1));
+    }
+
+    double Histogram::std_deviation() const
+    {
+        if (!total_) {
+            return 0.0;
+        }
+
+        auto const avg = mean();
+
+        auto sum = 0.0;
+        for (auto v = 0U; v < counts_.size(); v++) {
+            auto const d = static_cast<double>(v) - avg;
+            sum += d * d * static_cast<double>(counts_[v]);
+        }
+
+        return std::sqrt(sum / static_cast<double>(total_));
+    }
+
+    std::int32_t Histogram::value_at(std::uint64_t rank) const
+    {
+        std::uint64_t cumulative = 0;
+        for (auto v = 0U; v < counts_.size(); v++) {
+            cumulative += counts_[v];
+            if (rank < cumulative) {
+                return static_cast<std::int32_t>(v);
+            }
+        }
+
+        return static_cast<std::int32_t>(counts_.size()) - 1;
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    double normal_critical_value(double confidence)
+    {
+        return std::sqrt(2.0) * boost::math::erf_inv(confidence);
+    }
+
+    // #endregion 非メンバ関数
+}
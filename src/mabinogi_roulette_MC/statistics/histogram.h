@@ -0,0 +1,223 @@
+﻿/*! \file histogram.h
+    \brief 小さな非負の整数の度数を数える、密なヒストグラムのクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _HISTOGRAM_H_
+#define _HISTOGRAM_H_
+
+#pragma once
+
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int32_t, std::uint64_t
+#include <ostream>              // for std::ostream
+#include <utility>              // for std::pair
+#include <vector>               // for std::vector
+
+namespace statistics {
+    //! A class.
+    /*!
+        値を添字とする度数の配列で、小さな非負の整数の分布を数えるクラス
+        平均、標準偏差、中央値、最頻値、分位点とそれらの信頼区間、分布は、全て値の範囲の大きさ(bins)に比例する時間で求まる
+        度数は整数なので、mergeで足し合わせる順番によらず同じになり、そこから値の順に求める統計量も、ビット単位で同じになる
+    */
+    class Histogram final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param bins 最初に確保する値の範囲（値がこれ以上になったら広げる）
+        */
+        explicit Histogram(std::int32_t bins = 0);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~Histogram() = default;
+
+        //! A copy constructor.
+        /*!
+            デフォルトコピーコンストラクタ
+        */
+        Histogram(Histogram const &) = default;
+
+        //! A move constructor.
+        /*!
+            デフォルトムーブコンストラクタ
+        */
+        Histogram(Histogram &&) = default;
+
+        //! operator=().
+        /*!
+            デフォルトコピー代入演算子
+            \return コピー先のオブジェクト
+        */
+        Histogram & operator=(Histogram const &) = default;
+
+        //! operator=().
+        /*!
+            デフォルトムーブ代入演算子
+            \return ムーブ先のオブジェクト
+        */
+        Histogram & operator=(Histogram &&) = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            値を数える
+            \param value 値（0以上）
+            \param count 数える回数
+        */
+        void add(std::int32_t value, std::uint64_t count = 1)
+        {
+            if (static_cast<std::size_t>(value) >= counts_.size()) {
+                counts_.resize(value + 1, 0);
+            }
+
+            counts_[value] += count;
+            total_ += count;
+        }
+
+        //! A public member function.
+        /*!
+            値ごとの度数を返す
+            \return 値を添字とする度数の可変長配列
+        */
+        std::vector<std::uint64_t> const & counts() const
+        {
+            return counts_;
+        }
+
+        //! A public member function.
+        /*!
+            平均を求める
+            \return 平均
+        */
+        double mean() const;
+
+        //! A public member function.
+        /*!
+            平均の信頼区間を、正規近似（標本標準偏差 / √度数の合計）で求める
+            \param confidence 信頼係数（0.95なら95%信頼区間）
+            \return 信頼区間の下限と上限のstd::pair
+        */
+        std::pair<double, double> mean_ci(double confidence) const;
+
+        //! A public member function.
+        /*!
+            中央値を求める
+            度数の合計が偶数なら、中央の二つの値の平均（切り捨て）を返す
+            \return 中央値
+        */
+        std::int32_t median() const;
+
+        //! A public member function.
+        /*!
+            別のヒストグラムの度数を足し合わせる
+            \param other 足し合わせるヒストグラム
+        */
+        void merge(Histogram const & other);
+
+        //! A public member function.
+        /*!
+            最頻値を求める（度数が同じなら小さい方の値）
+            \return 最頻値
+        */
+        std::int32_t mode() const;
+
+        //! A public member function.
+        /*!
+            度数が0でない値と、その度数を「値,度数」の形式で一行ずつ出力する
+            \param os 出力先のストリーム
+        */
+        void outputcsv(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            p分位点（度数の累積の割合がp以上になる最小の値）を求める
+            \param p 割合（0 < p < 1）
+            \return p分位点
+        */
+        std::int32_t quantile(double p) const;
+
+        //! A public member function.
+        /*!
+            p分位点の信頼区間を、順序統計量の順位が二項分布に従うことから（正規近似で）求める
+            分布の形を仮定しないが、値が整数なので、区間の両端は観測された値になる
+            \param p 割合（0 < p < 1）
+            \param confidence 信頼係数（0.95なら95%信頼区間）
+            \return 信頼区間の下限と上限のstd::pair
+        */
+        std::pair<std::int32_t, std::int32_t> quantile_ci(double p, double confidence) const;
+
+        //! A public member function.
+        /*!
+            標準偏差（母標準偏差）を求める
+            \return 標準偏差
+        */
+        double std_deviation() const;
+
+        //! A public member function.
+        /*!
+            度数の合計を返す
+            \return 度数の合計
+        */
+        std::uint64_t total() const
+        {
+            return total_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            小さい方から数えてrank番目（0から始まる）の値を求める
+            \param rank 順位
+            \return rank番目の値
+        */
+        std::int32_t value_at(std::uint64_t rank) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            値を添字とする度数の可変長配列
+        */
+        std::vector<std::uint64_t> counts_;
+
+        //! A private member variable.
+        /*!
+            度数の合計
+        */
+        std::uint64_t total_ = 0;
+
+        // #endregion メンバ変数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        両側の信頼係数に対応する標準正規分布の分位点を求める
+        \param confidence 信頼係数（0.95なら1.96）
+        \return 標準正規分布の分位点
+    */
+    double normal_critical_value(double confidence);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _HISTOGRAM_H_
@@ -0,0 +1,85 @@
+﻿/*! \file jointhistogram.cpp
+    \brief 試行回数と埋まっている数の組を数える、二次元のヒストグラムのクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "jointhistogram.h"
+#include <boost/format.hpp>     // for boost::format
+
+namespace statistics {
+    // #region メンバ関数
+
+    std::uint64_t JointHistogram::fillsum() const
+    {
+        std::uint64_t sum = 0;
+        for (auto m = 0U; m < rows_.size(); m++) {
+            sum += static_cast<std::uint64_t>(m) * rows_[m].total();
+        }
+
+        return sum;
+    }
+
+    Histogram JointHistogram::marginal() const
+    {
+        Histogram hist;
+        for (auto const & row : rows_) {
+            hist.merge(row);
+        }
+
+        return hist;
+    }
+
+    void JointHistogram::merge(JointHistogram const & other)
+    {
+        if (other.rows_.size() > rows_.size()) {
+            rows_.resize(other.rows_.size());
+        }
+
+        for (auto m = 0U; m < other.rows_.size(); m++) {
+            rows_[m].merge(other.rows_[m]);
+        }
+    }
+
+    ConditionalMoments JointHistogram::moments() const
+    {
+        ConditionalMoments moments;
+        for (auto m = 0U; m < rows_.size(); m++) {
+            auto const & counts = rows_[m].counts();
+            for (auto v = 0U; v < counts.size(); v++) {
+                if (counts[v]) {
+                    moments.add(static_cast<std::int32_t>(v), static_cast<std::int32_t>(m), counts[v]);
+                }
+            }
+        }
+
+        return moments;
+    }
+
+    std::size_t JointHistogram::nonzeros() const
+    {
+        std::size_t count = 0;
+        for (auto const & row : rows_) {
+            for (auto const c : row.counts()) {
+                count += c ? 1 : 0;
+            }
+        }
+
+        return count;
+    }
+
+    void JointHistogram::outputcsv(std::ostream & os, std::size_t n) const
+    {
+        for (auto m = 0U; m < rows_.size(); m++) {
+            auto const & counts = rows_[m].counts();
+            for (auto v = 0U; v < counts.size(); v++) {
+                if (counts[v]) {
+                    os << boost::format("%d,%d,%d,%d\n") % n % v % m % counts[v];
+                }
+            }
+        }
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,104 @@
+﻿/*! \file jointhistogram.h
+    \brief 試行回数と埋まっている数の組を数える、二次元のヒストグラムのクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _JOINTHISTOGRAM_H_
+#define _JOINTHISTOGRAM_H_
+
+#pragma once
+
+#include "histogram.h"
+#include "variancereduction.h"
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int32_t, std::uint64_t
+#include <ostream>              // for std::ostream
+#include <vector>               // for std::vector
+
+namespace statistics {
+    //! A class.
+    /*!
+        (n + 1)個目の行・列またはマスが埋まったときの、試行回数と埋まっているマスまたは行・列の数の同時分布を数えるヒストグラム
+        埋まっている数ごとに試行回数のヒストグラムを持つので、一回加えるのにかかる時間は一定で、試行の結果そのものは保持しない
+        出力するときは、度数が0でない組だけを書き出す
+    */
+    class JointHistogram final {
+    public:
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            試行回数と埋まっている数の組を一つ数える
+            \param value 試行回数（0以上）
+            \param m 埋まっている数（0以上）
+        */
+        void add(std::int32_t value, std::int32_t m)
+        {
+            if (static_cast<std::size_t>(m) >= rows_.size()) {
+                rows_.resize(m + 1);
+            }
+
+            rows_[m].add(value);
+        }
+
+        //! A public member function.
+        /*!
+            埋まっている数の総和を求める
+            \return 埋まっている数の総和
+        */
+        std::uint64_t fillsum() const;
+
+        //! A public member function.
+        /*!
+            埋まっている数によらない、試行回数のヒストグラム（周辺分布）を求める
+            \return 試行回数のヒストグラム
+        */
+        Histogram marginal() const;
+
+        //! A public member function.
+        /*!
+            別のヒストグラムの度数を足し合わせる
+            \param other 足し合わせるヒストグラム
+        */
+        void merge(JointHistogram const & other);
+
+        //! A public member function.
+        /*!
+            埋まっている数ごとの、試行回数の度数・総和・二乗和を求める（制御変量法に使う）
+            \return 埋まっている数ごとの試行回数の集計結果
+        */
+        ConditionalMoments moments() const;
+
+        //! A public member function.
+        /*!
+            度数が0でない組の数を返す
+            \return 度数が0でない組の数
+        */
+        std::size_t nonzeros() const;
+
+        //! A public member function.
+        /*!
+            度数が0でない組を、"n,試行回数,埋まっている数,度数"の形式で一行ずつcsv形式で出力する
+            \param os 出力先のストリーム
+            \param n 何個目の行・列またはマスか（1から数える）
+        */
+        void outputcsv(std::ostream & os, std::size_t n) const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            埋まっている数を添字とする、試行回数のヒストグラムの可変長配列
+        */
+        std::vector<Histogram> rows_;
+
+        // #endregion メンバ変数
+    };
+}
+
+#endif  // _JOINTHISTOGRAM_H_
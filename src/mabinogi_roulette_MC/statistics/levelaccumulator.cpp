@@ -0,0 +1,65 @@
+﻿/*! \file levelaccumulator.cpp
+    \brief 試行の結果を、(n + 1)個目ごとのヒストグラムに逐次加えていくクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "levelaccumulator.h"
+
+namespace statistics {
+    // #region コンストラクタ・デストラクタ
+
+    LevelAccumulator::LevelAccumulator(std::size_t size)
+        : antithetic_(size), joint_(size)
+    {
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    std::vector<ConditionalMoments> LevelAccumulator::conditional() const
+    {
+        std::vector<ConditionalMoments> conditional;
+        conditional.reserve(joint_.size());
+        for (auto const & joint : joint_) {
+            conditional.push_back(joint.moments());
+        }
+
+        return conditional;
+    }
+
+    std::valarray<double> LevelAccumulator::fillavg() const
+    {
+        std::valarray<double> avg(joint_.size());
+        for (auto n = 0U; n < joint_.size(); n++) {
+            avg[n] = trials_ ? static_cast<double>(joint_[n].fillsum()) / static_cast<double>(trials_) : 0.0;
+        }
+
+        return avg;
+    }
+
+    std::vector<Histogram> LevelAccumulator::histograms() const
+    {
+        std::vector<Histogram> histograms;
+        histograms.reserve(joint_.size());
+        for (auto const & joint : joint_) {
+            histograms.push_back(joint.marginal());
+        }
+
+        return histograms;
+    }
+
+    void LevelAccumulator::merge(LevelAccumulator const & other)
+    {
+        for (auto n = 0U; n < joint_.size(); n++) {
+            joint_[n].merge(other.joint_[n]);
+            antithetic_[n].merge(other.antithetic_[n]);
+        }
+
+        trials_ += other.trials_;
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,203 @@
+﻿/*! \file levelaccumulator.h
+    \brief 試行の結果を、(n + 1)個目ごとのヒストグラムに逐次加えていくクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _LEVELACCUMULATOR_H_
+#define _LEVELACCUMULATOR_H_
+
+#pragma once
+
+#include "histogram.h"
+#include "jointhistogram.h"
+#include "variancereduction.h"
+#include "../montecarlo/montecarlo.h"
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::uint64_t
+#include <valarray>             // for std::valarray
+#include <vector>               // for std::vector
+
+namespace statistics {
+    //! A class.
+    /*!
+        試行の結果を、(n + 1)個目の行・列またはマスが埋まったときの、試行回数と埋まっているマスまたは行・列の数の同時分布に、一回ずつ加えていくクラス
+        試行回数のヒストグラム、埋まっている数の総和、埋まっている数ごとの試行回数の総和・二乗和（制御変量法に使う）は、全て同時分布から求める
+        対称変量法で組にした試行は、組の和も数える
+        試行の結果そのものは保持しないので、試行回数によらずメモリ使用量は一定になる
+        スレッドごとに一つずつ持ち、最後にmergeでまとめる（全て整数なので、まとめる順番によらず結果は同じになる）
+    */
+    class LevelAccumulator final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param size 行・列またはマスの総数
+        */
+        explicit LevelAccumulator(std::size_t size);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~LevelAccumulator() = default;
+
+        //! A copy constructor.
+        /*!
+            デフォルトコピーコンストラクタ
+        */
+        LevelAccumulator(LevelAccumulator const &) = default;
+
+        //! A move constructor.
+        /*!
+            デフォルトムーブコンストラクタ
+        */
+        LevelAccumulator(LevelAccumulator &&) = default;
+
+        //! operator=().
+        /*!
+            デフォルトコピー代入演算子
+            \return コピー先のオブジェクト
+        */
+        LevelAccumulator & operator=(LevelAccumulator const &) = default;
+
+        //! operator=().
+        /*!
+            デフォルトムーブ代入演算子
+            \return ムーブ先のオブジェクト
+        */
+        LevelAccumulator & operator=(LevelAccumulator &&) = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            一回の試行の結果を加える
+            \param res 一回の試行の、(n + 1)個目ごとの（試行回数, 埋まっている数）の可変長配列
+        */
+        void add(std::vector<montecarlo::mypair2> const & res)
+        {
+            for (auto n = 0U; n < joint_.size(); n++) {
+                joint_[n].add(res[n].first, res[n].second);
+            }
+
+            trials_++;
+        }
+
+        //! A public member function.
+        /*!
+            対称変量法で組にした二回の試行の結果を加える
+            \param res1 一回目の試行の結果
+            \param res2 一回目と対称な二回目の試行の結果
+        */
+        void add_pair(std::vector<montecarlo::mypair2> const & res1, std::vector<montecarlo::mypair2> const & res2)
+        {
+            add(res1);
+            add(res2);
+
+            for (auto n = 0U; n < antithetic_.size(); n++) {
+                antithetic_[n].add(res1[n].first, res2[n].first);
+            }
+        }
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとの、対称変量法で組にした試行回数の集計結果を返す
+            \return (n + 1)個目ごとの組の集計結果の可変長配列
+        */
+        std::vector<PairMoments> const & antithetic() const
+        {
+            return antithetic_;
+        }
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとの、埋まっているマスまたは行・列の数ごとの試行回数の集計結果を、同時分布から求める
+            \return (n + 1)個目ごとの集計結果の可変長配列
+        */
+        std::vector<ConditionalMoments> conditional() const;
+
+        //! A public member function.
+        /*!
+            埋まっているマスまたは行・列の平均個数を求める
+            \return (n + 1)個目ごとの、埋まっているマスまたは行・列の平均個数
+        */
+        std::valarray<double> fillavg() const;
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとの試行回数のヒストグラムを、同時分布の周辺分布として求める
+            \return (n + 1)個目ごとの試行回数のヒストグラムの可変長配列
+        */
+        std::vector<Histogram> histograms() const;
+
+        //! A public member function.
+        /*!
+            (n + 1)個目ごとの、試行回数と埋まっているマスまたは行・列の数の同時分布を返す
+            \return (n + 1)個目ごとの同時分布の可変長配列
+        */
+        std::vector<JointHistogram> const & joint() const
+        {
+            return joint_;
+        }
+
+        //! A public member function.
+        /*!
+            別のオブジェクトの結果を足し合わせる
+            \param other 足し合わせるオブジェクト
+        */
+        void merge(LevelAccumulator const & other);
+
+        //! A public member function.
+        /*!
+            加えた試行の回数を返す
+            \return 加えた試行の回数
+        */
+        std::uint64_t trials() const
+        {
+            return trials_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            (n + 1)個目ごとの、対称変量法で組にした試行回数の集計結果
+        */
+        std::vector<PairMoments> antithetic_;
+
+        //! A private member variable.
+        /*!
+            (n + 1)個目ごとの、試行回数と埋まっているマスまたは行・列の数の同時分布
+        */
+        std::vector<JointHistogram> joint_;
+
+        //! A private member variable.
+        /*!
+            加えた試行の回数
+        */
+        std::uint64_t trials_ = 0;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        LevelAccumulator() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _LEVELACCUMULATOR_H_
@@ -0,0 +1,162 @@
+﻿/*! \file statistics.cpp
+    \brief モンテカルロ・シミュレーションの結果を集計する関数の実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "statistics.h"
+#include "levelaccumulator.h"
+#include <cmath>                                // for std::sqrt
+#include <iterator>                             // for std::begin
+#include <unordered_map>                        // for std::unordered_map
+#include <boost/range/algorithm.hpp>            // for boost::max_element, boost::sort, boost::transform
+#include <tbb/blocked_range.h>                  // for tbb::blocked_range
+#include <tbb/parallel_reduce.h>                // for tbb::parallel_reduce
+
+namespace statistics {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            eval_histogramsで、一つのタスクが走査する試行回数の目安
+        */
+        static auto constexpr HISTOGRAMGRAINSIZE = 16384U;
+    }
+
+    // #region 非メンバ関数
+
+    std::pair< std::valarray<double>, std::valarray<double> > eval_average(mcresult_t const & mcresult, std::size_t size)
+    {
+        // 試行回数
+        auto const mcmax = mcresult.size();
+
+        // モンテカルロ・シミュレーションの平均試行回数の結果を格納した可変長配列
+        std::valarray<double> trialavg(size);
+
+        // モンテカルロ・シミュレーションのn回目の試行で、埋まっているマスの数を格納した可変長配列
+        std::valarray<double> fillavg(size);
+
+        // 行・列の総数分繰り返す
+        for (auto n = 0U; n < size; n++) {
+            // 総和を0で初期化（試行回数が多いとstd::int32_tではあふれるので、std::int64_tにする）
+            std::int64_t trialsum = 0;
+            std::int64_t fillsum = 0;
+
+            // 試行回数分繰り返す
+            for (auto j = 0U; j < mcmax; j++) {
+                // j回目の結果を加える
+                trialsum += mcresult[j][n].first;
+                fillsum += mcresult[j][n].second;
+            }
+
+            // 平均を算出してn行・列目のtrialavg、fillavgに代入
+            trialavg[n] = static_cast<double>(trialsum) / static_cast<double>(mcmax);
+            fillavg[n] = static_cast<double>(fillsum) / static_cast<double>(mcmax);
+        }
+
+        return std::make_pair(std::move(trialavg), std::move(fillavg));
+    }
+
+    std::pair< std::vector<Histogram>, std::valarray<double> > eval_histograms(mcresult_t const & mcresult, std::size_t size)
+    {
+        // 試行を分割して並列に走査し、途中の結果を足し合わせる
+        // 足し合わせるのは整数の度数と総和だけなので、分割のされ方によらず結果は同じになる
+        auto sum = tbb::parallel_reduce(
+            tbb::blocked_range<std::size_t>(0, mcresult.size(), HISTOGRAMGRAINSIZE),
+            LevelAccumulator(size),
+            [&mcresult](auto const & range, LevelAccumulator partial) {
+            // 一回の試行の結果はメモリ上で連続しているので、試行ごとに全ての行・列またはマスを処理する
+            for (auto j = range.begin(); j != range.end(); ++j) {
+                partial.add(mcresult[j]);
+            }
+
+            return partial;
+        },
+            [](LevelAccumulator lhs, LevelAccumulator const & rhs) {
+            lhs.merge(rhs);
+
+            return lhs;
+        });
+
+        return std::make_pair(sum.histograms(), sum.fillavg());
+    }
+
+    std::int32_t eval_median(mcresult_t const & mcresult, std::int32_t n)
+    {
+        // 試行回数
+        auto const mcmax = mcresult.size();
+
+        // 中央値を求めるために必要な可変長配列
+        std::vector<std::int32_t> medtmp(mcmax);
+
+        // 中央値を求めるために必要な可変長配列を、モンテカルロ法の結果から生成
+        boost::transform(
+            mcresult,
+            medtmp.begin(),
+            [n](auto const & res) { return res[n].first; });
+
+        // 中央値を求めるためにソートする
+        boost::sort(medtmp);
+
+        // 中央値を求める
+        if (mcmax % 2) {
+            // 要素が奇数個なら中央の要素を返す
+            return medtmp[(mcmax - 1) / 2];
+        }
+        else {
+            // 要素が偶数個なら中央二つの平均を返す
+            return (medtmp[(mcmax / 2) - 1] + medtmp[mcmax / 2]) / 2;
+        }
+    }
+
+    std::pair<std::int32_t, mymap> eval_mode(mcresult_t const & mcresult, std::int32_t n)
+    {
+        // (n + 1)個目の行・列が埋まったときの分布
+        std::unordered_map<std::int32_t, std::uint64_t> distmap;
+
+        // distmapを埋める
+        for (auto const & res : mcresult) {
+            // (n + 1)個目の行・列が埋まったときの回数をkeyとする
+            auto const key = res[n].first;
+
+            // keyが存在するかどうか
+            auto itr = distmap.find(key);
+            if (itr == distmap.end()) {
+                // keyが存在しなかったので、そのキーでハッシュを拡張（値1）
+                distmap.emplace(key, 1);
+            }
+            else {
+                // keyが指す値を更新
+                itr->second++;
+            }
+        }
+
+        // 最頻値を探索
+        auto const mode = boost::max_element(
+            distmap,
+            [](auto const & p1, auto const & p2) { return p1.second < p2.second; })->first;
+
+        // 最頻値と(n + 1)個目の行・列が埋まったときの分布をpairにして返す
+        return std::make_pair(mode, mymap(distmap.begin(), distmap.end()));
+    }
+
+    double eval_std_deviation(double avg, mcresult_t const & mcresult, std::int32_t n)
+    {
+        // 標準偏差を求めるために必要な可変長配列
+        std::valarray<double> devtmp(mcresult.size());
+
+        // 標準偏差の計算
+        boost::transform(
+            mcresult,
+            std::begin(devtmp),
+            [avg, n](auto const & res) {
+            auto const val = static_cast<double>(res[n].first);
+            return (val - avg) * (val - avg);
+        });
+
+        // 標準偏差を求める
+        return std::sqrt(devtmp.sum() / static_cast<double>(mcresult.size()));
+    }
+
+    // #endregion 非メンバ関数
+}
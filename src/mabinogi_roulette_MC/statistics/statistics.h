@@ -0,0 +1,90 @@
+﻿/*! \file statistics.h
+    \brief モンテカルロ・シミュレーションの結果を集計する関数の宣言
+    集計にはeval_histogramsを使う。eval_average、eval_median、eval_mode、eval_std_deviationは、
+    その結果と比べるための素朴な実装（ソートとハッシュ表）として残してある
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _STATISTICS_H_
+#define _STATISTICS_H_
+
+#pragma once
+
+#include "histogram.h"
+#include "../montecarlo/montecarlo.h"
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::int32_t, std::uint64_t
+#include <map>                                  // for std::map
+#include <utility>                              // for std::pair
+#include <valarray>                             // for std::valarray
+#include <vector>                               // for std::vector
+#include <tbb/concurrent_vector.h>              // for tbb::concurrent_vector
+
+namespace statistics {
+    //! A typedef.
+    /*!
+        (n + 1)個目の行・列が埋まったときの分布を格納するためのmapの型
+    */
+    using mymap = std::map<std::int32_t, std::uint64_t>;
+
+    //! A typedef.
+    /*!
+        モンテカルロ・シミュレーションの結果を格納する二次元可変長配列の型
+    */
+    using mcresult_t = tbb::concurrent_vector< std::vector<montecarlo::mypair2> >;
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        (n + 1)個目の行・列またはマスが埋まったときの平均試行回数、埋まっているマスまたは行・列の平均個数を求める
+        \param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        \param size 行・列またはマスの総数
+        \return (n + 1)個目の行・列が埋まったときの平均試行回数、埋まっているマスの平均個数が格納された可変長配列のstd::pair
+    */
+    std::pair< std::valarray<double>, std::valarray<double> > eval_average(mcresult_t const & mcresult, std::size_t size);
+
+    //! A function.
+    /*!
+        全ての(n + 1)について、(n + 1)個目の行・列またはマスが埋まったときの試行回数のヒストグラムと、
+        埋まっているマスまたは行・列の平均個数を、結果を一度だけ走査して求める
+        \param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        \param size 行・列またはマスの総数
+        \return 試行回数のヒストグラムの可変長配列と、埋まっているマスまたは行・列の平均個数の可変長配列のstd::pair
+    */
+    std::pair< std::vector<Histogram>, std::valarray<double> > eval_histograms(mcresult_t const & mcresult, std::size_t size);
+
+    //! A function.
+    /*!
+        (n + 1)個目の行・列が埋まったときの中央値を求める
+        \param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        \param n (n + 1)個目の数値n
+        \return (n + 1)個目の行・列が埋まったときの中央値
+    */
+    std::int32_t eval_median(mcresult_t const & mcresult, std::int32_t n);
+
+    //! A function.
+    /*!
+        (n + 1)個目の行・列が埋まったときの最頻値と分布を求める
+        \param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        \param n (n + 1)個目の数値n
+        \return (n + 1)個目の行・列が埋まったときの最頻値と分布のstd::pair
+    */
+    std::pair<std::int32_t, mymap> eval_mode(mcresult_t const & mcresult, std::int32_t n);
+
+    //! A function.
+    /*!
+        (n + 1)個目の行・列が埋まったときの標準偏差を求める
+        \param avg (n + 1)個目の行・列が埋まったときの平均試行回数
+        \param mcresult モンテカルロ・シミュレーションの結果が格納された二次元可変長配列
+        \param n (n + 1)個目の数値n
+        \return (n + 1)個目の行・列が埋まったときの標準偏差
+    */
+    double eval_std_deviation(double avg, mcresult_t const & mcresult, std::int32_t n);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _STATISTICS_H_
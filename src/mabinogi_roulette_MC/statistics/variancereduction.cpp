@@ -0,0 +1,123 @@
+﻿/*! \file variancereduction.cpp
+    \brief 平均試行回数の分散を減らす推定量（制御変量法、対称変量法）のための集計クラスと関数の実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "variancereduction.h"
+#include <algorithm>            // for std::max
+#include <cmath>                // for std::sqrt
+#include <limits>               // for std::numeric_limits
+
+namespace statistics {
+    // #region メンバ関数
+
+    VarianceReductionResult ConditionalMoments::control_variate(std::vector<double> const & g) const
+    {
+        // y、x = y - g(m)の総和、二乗和、積和を、mごとの整数の集計から求める
+        auto n = 0.0, sy = 0.0, syy = 0.0, sx = 0.0, sxx = 0.0, sxy = 0.0;
+        for (auto m = 0U; m < counts_.size(); m++) {
+            if (!counts_[m]) {
+                continue;
+            }
+
+            auto const c = static_cast<double>(counts_[m]);
+            auto const s1 = static_cast<double>(sums_[m]);
+            auto const s2 = static_cast<double>(squares_[m]);
+            auto const mu = g[m];
+
+            n += c;
+            sy += s1;
+            syy += s2;
+            sx += s1 - c * mu;
+            sxx += s2 - 2.0 * mu * s1 + c * mu * mu;
+            sxy += s2 - mu * s1;
+        }
+
+        if (n < 2.0) {
+            return { n > 0.0 ? sy / n : 0.0, std::numeric_limits<double>::infinity(), 1.0 };
+        }
+
+        auto const ybar = sy / n, xbar = sx / n;
+        auto const vary = (syy - n * ybar * ybar) / (n - 1.0);
+        auto const varx = (sxx - n * xbar * xbar) / (n - 1.0);
+        auto const cov = (sxy - n * xbar * ybar) / (n - 1.0);
+
+        // xの分散が0なら、yはg(m)で決まっている
+        if (varx <= 0.0) {
+            return { ybar, 0.0, std::numeric_limits<double>::infinity() };
+        }
+
+        // E[x] = 0なので、推定量はybar - beta * xbar、分散は回帰の残差の分散になる
+        auto const beta = cov / varx;
+        // 丸め誤差より小さい残差は0とみなす（yがg(m)で決まっているとき）
+        auto const residual = vary - cov * beta > vary * 1.0E-12 ? vary - cov * beta : 0.0;
+
+        return {
+            ybar - beta * xbar,
+            std::sqrt(residual / n),
+            residual > 0.0 ? vary / residual : std::numeric_limits<double>::infinity()
+        };
+    }
+
+    void ConditionalMoments::merge(ConditionalMoments const & other)
+    {
+        if (other.counts_.size() > counts_.size()) {
+            counts_.resize(other.counts_.size(), 0);
+            sums_.resize(other.counts_.size(), 0);
+            squares_.resize(other.counts_.size(), 0);
+        }
+
+        for (auto m = 0U; m < other.counts_.size(); m++) {
+            counts_[m] += other.counts_[m];
+            sums_[m] += other.sums_[m];
+            squares_[m] += other.squares_[m];
+        }
+    }
+
+    VarianceReductionResult PairMoments::estimate(double variance) const
+    {
+        auto const p = static_cast<double>(pairs_);
+        if (pairs_ < 2) {
+            return { pairs_ ? static_cast<double>(sum_) / (2.0 * p) : 0.0, std::numeric_limits<double>::infinity(), 1.0 };
+        }
+
+        // 組の平均(y1 + y2) / 2の分散から、平均の標準誤差を求める
+        auto const sbar = static_cast<double>(sum_) / p;
+        auto const vars = (static_cast<double>(square_) - p * sbar * sbar) / (p - 1.0);
+        auto const varmean = std::max(vars, 0.0) / 4.0 / p;
+
+        // 組にしないで2p回試行したときの、平均の分散と比べる
+        auto const plain = variance / (2.0 * p);
+
+        return {
+            sbar / 2.0,
+            std::sqrt(varmean),
+            varmean > 0.0 ? plain / varmean : std::numeric_limits<double>::infinity()
+        };
+    }
+
+    void PairMoments::merge(PairMoments const & other)
+    {
+        pairs_ += other.pairs_;
+        sum_ += other.sum_;
+        square_ += other.square_;
+    }
+
+    // #endregion メンバ関数
+
+    // #region 非メンバ関数
+
+    std::vector<double> coupon_collector_means(std::size_t size)
+    {
+        std::vector<double> mu(size + 1, 0.0);
+        for (auto m = 1U; m <= size; m++) {
+            mu[m] = mu[m - 1] + static_cast<double>(size) / static_cast<double>(size - m + 1);
+        }
+
+        return mu;
+    }
+
+    // #endregion 非メンバ関数
+}
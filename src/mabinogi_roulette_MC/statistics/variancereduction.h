@@ -0,0 +1,202 @@
+﻿/*! \file variancereduction.h
+    \brief 平均試行回数の分散を減らす推定量（制御変量法、対称変量法）のための集計クラスと関数の宣言
+    集計は全て整数で行うので、まとめる順番によらず結果は同じになる
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _VARIANCEREDUCTION_H_
+#define _VARIANCEREDUCTION_H_
+
+#pragma once
+
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int32_t, std::uint64_t
+#include <vector>               // for std::vector
+
+namespace statistics {
+    //! A structure.
+    /*!
+        分散を減らした推定量の結果を格納する構造体
+    */
+    struct VarianceReductionResult {
+        //! A public member variable.
+        /*!
+            平均の推定値
+        */
+        double mean;
+
+        //! A public member variable.
+        /*!
+            推定値の標準誤差
+        */
+        double se;
+
+        //! A public member variable.
+        /*!
+            単純な平均の標準誤差に対する比（分散の比、1より大きければ分散が減った）
+        */
+        double vrf;
+    };
+
+    //! A class.
+    /*!
+        観測値yを、条件となる小さな非負の整数mごとに分けて、度数、総和、二乗和を数えるクラス
+        mの関数g(m)の期待値が既知なら、y - g(m)を制御変量とする推定量を求められる
+    */
+    class ConditionalMoments final {
+    public:
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            観測値を加える
+            \param y 観測値（0以上）
+            \param m 条件となる値（0以上）
+            \param count 加える個数
+        */
+        void add(std::int32_t y, std::int32_t m, std::uint64_t count = 1)
+        {
+            if (static_cast<std::size_t>(m) >= counts_.size()) {
+                counts_.resize(m + 1, 0);
+                sums_.resize(m + 1, 0);
+                squares_.resize(m + 1, 0);
+            }
+
+            auto const v = static_cast<std::uint64_t>(y);
+            counts_[m] += count;
+            sums_[m] += v * count;
+            squares_[m] += v * v * count;
+        }
+
+        //! A public member function.
+        /*!
+            別のオブジェクトの結果を足し合わせる
+            \param other 足し合わせるオブジェクト
+        */
+        void merge(ConditionalMoments const & other);
+
+        //! A public member function.
+        /*!
+            y - g(m)を、期待値が0の制御変量とした推定量を求める
+            yとy - g(m)の回帰係数は標本から求める
+            \param g 条件となる値mごとの、yの条件付き期待値E[y | m]（mの添字で引く）
+            \return 推定量の結果
+        */
+        VarianceReductionResult control_variate(std::vector<double> const & g) const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            mごとの度数
+        */
+        std::vector<std::uint64_t> counts_;
+
+        //! A private member variable.
+        /*!
+            mごとのyの二乗和
+        */
+        std::vector<std::uint64_t> squares_;
+
+        //! A private member variable.
+        /*!
+            mごとのyの総和
+        */
+        std::vector<std::uint64_t> sums_;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        対称変量法で組にした二つの観測値の和の、度数、総和、二乗和を数えるクラス
+    */
+    class PairMoments final {
+    public:
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            一組の観測値を加える
+            \param y1 一つ目の観測値（0以上）
+            \param y2 二つ目の観測値（0以上）
+        */
+        void add(std::int32_t y1, std::int32_t y2)
+        {
+            auto const s = static_cast<std::uint64_t>(y1) + static_cast<std::uint64_t>(y2);
+            pairs_++;
+            sum_ += s;
+            square_ += s * s;
+        }
+
+        //! A public member function.
+        /*!
+            対称変量法の推定量を求める
+            \param variance 一つの観測値の分散（組にしない単純な平均の標準誤差と比べるのに使う）
+            \return 推定量の結果
+        */
+        VarianceReductionResult estimate(double variance) const;
+
+        //! A public member function.
+        /*!
+            別のオブジェクトの結果を足し合わせる
+            \param other 足し合わせるオブジェクト
+        */
+        void merge(PairMoments const & other);
+
+        //! A public member function.
+        /*!
+            加えた組の数を返す
+            \return 組の数
+        */
+        std::uint64_t pairs() const
+        {
+            return pairs_;
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            組の数
+        */
+        std::uint64_t pairs_ = 0;
+
+        //! A private member variable.
+        /*!
+            組の和の二乗和
+        */
+        std::uint64_t square_ = 0;
+
+        //! A private member variable.
+        /*!
+            組の和の総和
+        */
+        std::uint64_t sum_ = 0;
+
+        // #endregion メンバ変数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        クーポンコレクター問題で、m種類（m = 0, 1, ..., size）を集めるまでの抽選回数の期待値を求める
+        size種類の数字から一様に引くとき、E[T_m] = size * (1 / size + 1 / (size - 1) + ... + 1 / (size - m + 1))
+        \param size 数字の種類の数
+        \return mの添字で引く期待値の可変長配列
+    */
+    std::vector<double> coupon_collector_means(std::size_t size);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _VARIANCEREDUCTION_H_
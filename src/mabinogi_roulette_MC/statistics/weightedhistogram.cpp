@@ -0,0 +1,87 @@
+﻿/*! \file weightedhistogram.cpp
+    \brief 重点サンプリングの重みをつけて小さな非負の整数を数える、密なヒストグラムのクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "weightedhistogram.h"
+#include <algorithm>                                // for std::max, std::min
+#include <cmath>                                    // for std::sqrt
+#include <boost/format.hpp>                         // for boost::format
+
+namespace statistics {
+    // #region メンバ関数
+
+    double WeightedHistogram::effective_samples() const
+    {
+        auto sum = 0.0, square = 0.0;
+        for (auto v = 0U; v < sums_.size(); v++) {
+            sum += sums_[v];
+            square += squares_[v];
+        }
+
+        return square > 0.0 ? sum * sum / square : 0.0;
+    }
+
+    TailEstimate WeightedHistogram::lower_tail(std::int32_t value) const
+    {
+        return estimate(0, static_cast<std::size_t>(std::max(value + 1, 0)));
+    }
+
+    void WeightedHistogram::merge(WeightedHistogram const & other)
+    {
+        if (other.sums_.size() > sums_.size()) {
+            sums_.resize(other.sums_.size(), 0.0);
+            squares_.resize(other.squares_.size(), 0.0);
+        }
+
+        for (auto v = 0U; v < other.sums_.size(); v++) {
+            sums_[v] += other.sums_[v];
+            squares_[v] += other.squares_[v];
+        }
+
+        samples_ += other.samples_;
+    }
+
+    void WeightedHistogram::outputcsv(std::ostream & os) const
+    {
+        os << "value,probability,probability_se,lower_tail,lower_tail_se,upper_tail,upper_tail_se\n";
+
+        for (auto v = 0U; v < sums_.size(); v++) {
+            if (sums_[v] > 0.0) {
+                auto const p = estimate(v, v + 1);
+                auto const lower = lower_tail(static_cast<std::int32_t>(v));
+                auto const upper = upper_tail(static_cast<std::int32_t>(v));
+                os << boost::format("%d,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e\n") % v % p.probability % p.se % lower.probability % lower.se % upper.probability % upper.se;
+            }
+        }
+    }
+
+    TailEstimate WeightedHistogram::upper_tail(std::int32_t value) const
+    {
+        return estimate(static_cast<std::size_t>(std::max(value, 0)), sums_.size());
+    }
+
+    TailEstimate WeightedHistogram::estimate(std::size_t first, std::size_t last) const
+    {
+        if (!samples_) {
+            return { 0.0, 0.0 };
+        }
+
+        // 試行ごとの観測値はw・1{値が[first, last)}なので、その平均と、平均の標準誤差を求める
+        auto sum = 0.0, square = 0.0;
+        for (auto v = first; v < std::min(last, sums_.size()); v++) {
+            sum += sums_[v];
+            square += squares_[v];
+        }
+
+        auto const n = static_cast<double>(samples_);
+        auto const p = sum / n;
+        auto const var = std::max(square / n - p * p, 0.0);
+
+        return { p, samples_ > 1 ? std::sqrt(var / (n - 1.0)) : 0.0 };
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,152 @@
+﻿/*! \file weightedhistogram.h
+    \brief 重点サンプリングの重みをつけて小さな非負の整数を数える、密なヒストグラムのクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _WEIGHTEDHISTOGRAM_H_
+#define _WEIGHTEDHISTOGRAM_H_
+
+#pragma once
+
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int32_t, std::uint64_t
+#include <ostream>              // for std::ostream
+#include <vector>               // for std::vector
+
+namespace statistics {
+    //! A structure.
+    /*!
+        裾の確率の推定値を格納する構造体
+    */
+    struct TailEstimate {
+        //! A public member variable.
+        /*!
+            確率の推定値
+        */
+        double probability;
+
+        //! A public member variable.
+        /*!
+            推定値の標準誤差
+        */
+        double se;
+    };
+
+    //! A class.
+    /*!
+        値を添字とする配列に、重み（尤度比）の総和と二乗和を数えるヒストグラム
+        試行回数で割った重みの総和が、その値をとる確率の不偏推定値になる
+        重みは浮動小数点数なので、同じ結果を得るには、足し合わせる順番を決めておかなければならない
+    */
+    class WeightedHistogram final {
+    public:
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            値を一つ、重みをつけて加える
+            \param value 値（0以上）
+            \param weight 重み
+        */
+        void add(std::int32_t value, double weight)
+        {
+            if (static_cast<std::size_t>(value) >= sums_.size()) {
+                sums_.resize(value + 1, 0.0);
+                squares_.resize(value + 1, 0.0);
+            }
+
+            sums_[value] += weight;
+            squares_[value] += weight * weight;
+            samples_++;
+        }
+
+        //! A public member function.
+        /*!
+            重みの和から求めた有効試行回数(Σw)^2 / Σw^2を返す
+            \return 有効試行回数
+        */
+        double effective_samples() const;
+
+        //! A public member function.
+        /*!
+            値が指定された値以下になる確率を推定する
+            \param value 値
+            \return 確率の推定値と標準誤差
+        */
+        TailEstimate lower_tail(std::int32_t value) const;
+
+        //! A public member function.
+        /*!
+            別のヒストグラムの重みを足し合わせる
+            \param other 足し合わせるヒストグラム
+        */
+        void merge(WeightedHistogram const & other);
+
+        //! A public member function.
+        /*!
+            値ごとの確率と、値以下・値以上になる確率を、標準誤差とともにcsv形式で出力する
+            \param os 出力先のストリーム
+        */
+        void outputcsv(std::ostream & os) const;
+
+        //! A public member function.
+        /*!
+            加えた値の個数（試行回数）を返す
+            \return 加えた値の個数
+        */
+        std::uint64_t samples() const
+        {
+            return samples_;
+        }
+
+        //! A public member function.
+        /*!
+            値が指定された値以上になる確率を推定する
+            \param value 値
+            \return 確率の推定値と標準誤差
+        */
+        TailEstimate upper_tail(std::int32_t value) const;
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            添字が[first, last)の重みから、確率を推定する
+            \param first 最初の添字
+            \param last 最後の添字の次
+            \return 確率の推定値と標準誤差
+        */
+        TailEstimate estimate(std::size_t first, std::size_t last) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            加えた値の個数
+        */
+        std::uint64_t samples_ = 0;
+
+        //! A private member variable.
+        /*!
+            値を添字とする重みの二乗和の可変長配列
+        */
+        std::vector<double> squares_;
+
+        //! A private member variable.
+        /*!
+            値を添字とする重みの総和の可変長配列
+        */
+        std::vector<double> sums_;
+
+        // #endregion メンバ変数
+    };
+}
+
+#endif  // _WEIGHTEDHISTOGRAM_H_
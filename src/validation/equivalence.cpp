@@ -0,0 +1,254 @@
+﻿/*! \file equivalence.cpp
+    \brief 二つの分布が同じかどうかを調べる検定の関数の実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "equivalence.h"
+#include "exactsolver.h"
+#include <algorithm>                                  // for std::max, std::min
+#include <cmath>                                    // for std::erfc, std::exp, std::fabs, std::sqrt
+#include <cstddef>                                  // for std::size_t
+#include <utility>                                  // for std::pair
+#include <boost/math/special_functions/gamma.hpp>   // for boost::math::gamma_q
+
+namespace validation {
+    namespace {
+        //! A function.
+        /*!
+            カイ二乗分布の上側確率を求める
+            \param statistic カイ二乗統計量
+            \param dof 自由度
+            \return 上側確率
+        */
+        double chi2_pvalue(double statistic, std::int32_t dof);
+
+        //! A function.
+        /*!
+            ヒストグラムのi番目の度数を返す（範囲外なら0）
+            \param h ヒストグラム
+            \param i 添字
+            \return 度数
+        */
+        double frequency(statistics::Histogram const & h, std::size_t i);
+
+        //! A function.
+        /*!
+            コルモゴロフ分布の上側確率 Q(λ) = 2Σ(-1)^(j-1) exp(-2j^2λ^2) を求める
+            \param lambda λ
+            \return 上側確率
+        */
+        double kolmogorov_q(double lambda);
+
+        //! A function.
+        /*!
+            標準正規分布の両側p値を求める
+            \param z z値
+            \return 両側p値
+        */
+        double normal_two_sided(double z);
+
+        //! A function.
+        /*!
+            ヒストグラムの不偏分散を求める
+            \param h ヒストグラム
+            \return 不偏分散
+        */
+        double unbiased_variance(statistics::Histogram const & h);
+    }
+
+    // #region 非メンバ関数
+
+    TestResult chi2_two_sample(statistics::Histogram const & x, statistics::Histogram const & y)
+    {
+        auto const nx = static_cast<double>(x.total());
+        auto const ny = static_cast<double>(y.total());
+        auto const n = nx + ny;
+        if (nx <= 0.0 || ny <= 0.0) {
+            return { 0.0, 1.0 };
+        }
+
+        // 期待度数が両方とも5以上になるまで値をまとめた区間の、二つの標本の度数
+        std::vector<std::pair<double, double>> bins;
+        auto ox = 0.0, oy = 0.0;
+        auto const size = std::max(x.counts().size(), y.counts().size());
+        for (auto i = 0U; i < size; i++) {
+            ox += frequency(x, i);
+            oy += frequency(y, i);
+
+            if ((ox + oy) * std::min(nx, ny) / n >= 5.0) {
+                bins.emplace_back(ox, oy);
+                ox = oy = 0.0;
+            }
+        }
+
+        if (ox + oy > 0.0) {
+            if (bins.empty()) {
+                bins.emplace_back(ox, oy);
+            }
+            else {
+                bins.back().first += ox;
+                bins.back().second += oy;
+            }
+        }
+
+        auto statistic = 0.0;
+        for (auto const & b : bins) {
+            auto const c = b.first + b.second;
+            auto const ex = c * nx / n;
+            auto const ey = c * ny / n;
+            statistic += (b.first - ex) * (b.first - ex) / ex + (b.second - ey) * (b.second - ey) / ey;
+        }
+
+        return { statistic, chi2_pvalue(statistic, static_cast<std::int32_t>(bins.size()) - 1) };
+    }
+
+    TestResult chi2_goodness(statistics::Histogram const & x, std::vector<double> const & pmf)
+    {
+        auto const n = static_cast<double>(x.total());
+        if (n <= 0.0) {
+            return { 0.0, 1.0 };
+        }
+
+        // 期待度数が5以上になるまで値をまとめた区間の、観測度数と期待度数
+        std::vector<std::pair<double, double>> bins;
+        auto o = 0.0, p = 0.0, cumulative = 0.0;
+        for (auto i = 0U; i < pmf.size(); i++) {
+            o += frequency(x, i);
+            p += pmf[i];
+
+            if (n * p >= 5.0) {
+                bins.emplace_back(o, n * p);
+                cumulative += p;
+                o = p = 0.0;
+            }
+        }
+
+        // 残りの値と、確率質量関数の範囲外の値は最後の区間に含める
+        for (auto i = pmf.size(); i < x.counts().size(); i++) {
+            o += frequency(x, i);
+        }
+
+        if (bins.empty()) {
+            return { 0.0, 1.0 };
+        }
+
+        bins.back().first += o;
+        bins.back().second = n * (1.0 - (cumulative - bins.back().second / n));
+
+        auto statistic = 0.0;
+        for (auto const & b : bins) {
+            statistic += (b.first - b.second) * (b.first - b.second) / b.second;
+        }
+
+        return { statistic, chi2_pvalue(statistic, static_cast<std::int32_t>(bins.size()) - 1) };
+    }
+
+    TestResult ks_two_sample(statistics::Histogram const & x, statistics::Histogram const & y)
+    {
+        auto const nx = static_cast<double>(x.total());
+        auto const ny = static_cast<double>(y.total());
+        if (nx <= 0.0 || ny <= 0.0) {
+            return { 0.0, 1.0 };
+        }
+
+        auto d = 0.0, fx = 0.0, fy = 0.0;
+        auto const size = std::max(x.counts().size(), y.counts().size());
+        for (auto i = 0U; i < size; i++) {
+            fx += frequency(x, i) / nx;
+            fy += frequency(y, i) / ny;
+            d = std::max(d, std::fabs(fx - fy));
+        }
+
+        // Numerical Recipesの補正を入れた漸近式
+        auto const en = std::sqrt(nx * ny / (nx + ny));
+
+        return { d, kolmogorov_q((en + 0.12 + 0.11 / en) * d) };
+    }
+
+    TestResult z_means(statistics::Histogram const & x, statistics::Histogram const & y)
+    {
+        auto const nx = static_cast<double>(x.total());
+        auto const ny = static_cast<double>(y.total());
+        auto const mx = x.mean(), vx = unbiased_variance(x);
+        auto const my = y.mean(), vy = unbiased_variance(y);
+
+        auto const se = std::sqrt(vx / nx + vy / ny);
+        if (!(se > 0.0)) {
+            return { 0.0, mx == my ? 1.0 : 0.0 };
+        }
+
+        auto const z = (mx - my) / se;
+
+        return { z, normal_two_sided(z) };
+    }
+
+    TestResult z_mean_exact(statistics::Histogram const & x, std::vector<double> const & pmf)
+    {
+        auto const n = static_cast<double>(x.total());
+        auto const mx = x.mean();
+        auto const [mean, var] = pmf_moments(pmf);
+
+        auto const se = std::sqrt(var / n);
+        if (!(se > 0.0)) {
+            return { 0.0, mx == mean ? 1.0 : 0.0 };
+        }
+
+        auto const z = (mx - mean) / se;
+
+        return { z, normal_two_sided(z) };
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        double chi2_pvalue(double statistic, std::int32_t dof)
+        {
+            if (dof <= 0) {
+                return 1.0;
+            }
+
+            return boost::math::gamma_q(static_cast<double>(dof) / 2.0, statistic / 2.0);
+        }
+
+        double frequency(statistics::Histogram const & h, std::size_t i)
+        {
+            return i < h.counts().size() ? static_cast<double>(h.counts()[i]) : 0.0;
+        }
+
+        double kolmogorov_q(double lambda)
+        {
+            if (lambda < 0.2) {
+                return 1.0;
+            }
+
+            auto sum = 0.0, sign = 1.0;
+            for (auto j = 1; j <= 100; j++) {
+                auto const term = sign * std::exp(-2.0 * j * j * lambda * lambda);
+                sum += term;
+                if (std::fabs(term) < 1.0E-12 * std::fabs(sum)) {
+                    break;
+                }
+
+                sign = -sign;
+            }
+
+            return std::min(std::max(2.0 * sum, 0.0), 1.0);
+        }
+
+        double normal_two_sided(double z)
+        {
+            return std::erfc(std::fabs(z) / std::sqrt(2.0));
+        }
+
+        double unbiased_variance(statistics::Histogram const & h)
+        {
+            // Histogram::std_deviationは母標準偏差なので、n / (n - 1)を掛ける
+            auto const n = static_cast<double>(h.total());
+            auto const sd = h.std_deviation();
+
+            return n > 1.0 ? sd * sd * n / (n - 1.0) : 0.0;
+        }
+    }
+}
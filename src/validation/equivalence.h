@@ -0,0 +1,89 @@
+﻿/*! \file equivalence.h
+    \brief 二つの分布が同じかどうかを調べる検定の関数の宣言
+    標本は、シミュレーション本体と同じstatistics::Histogramで受け取る
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _EQUIVALENCE_H_
+#define _EQUIVALENCE_H_
+
+#pragma once
+
+#include "../mabinogi_roulette_MC/statistics/histogram.h"
+#include <vector>               // for std::vector
+
+namespace validation {
+    //! A structure.
+    /*!
+        検定の結果を格納する構造体
+    */
+    struct TestResult {
+        //! A public member variable.
+        /*!
+            検定統計量
+        */
+        double statistic;
+
+        //! A public member variable.
+        /*!
+            p値
+        */
+        double pvalue;
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        二標本のカイ二乗検定（同質性の検定）を行う
+        期待度数が5未満になる値は、隣の値とまとめる
+        \param x 一つ目の標本のヒストグラム
+        \param y 二つ目の標本のヒストグラム
+        \return カイ二乗統計量とp値
+    */
+    TestResult chi2_two_sample(statistics::Histogram const & x, statistics::Histogram const & y);
+
+    //! A function.
+    /*!
+        確率質量関数に対するカイ二乗適合度検定を行う
+        期待度数が5未満になる値は隣の値とまとめ、確率質量関数の範囲外の値は最後の区間に含める
+        \param x 標本のヒストグラム
+        \param pmf 添字を値とする確率の可変長配列
+        \return カイ二乗統計量とp値
+    */
+    TestResult chi2_goodness(statistics::Histogram const & x, std::vector<double> const & pmf);
+
+    //! A function.
+    /*!
+        二標本のコルモゴロフ–スミルノフ検定を行う
+        p値は連続分布の漸近式で求めるので、離散分布では保守的（大きめ）になる
+        \param x 一つ目の標本のヒストグラム
+        \param y 二つ目の標本のヒストグラム
+        \return 経験分布関数の差の最大値とp値
+    */
+    TestResult ks_two_sample(statistics::Histogram const & x, statistics::Histogram const & y);
+
+    //! A function.
+    /*!
+        二標本の平均の差のz検定を行う
+        \param x 一つ目の標本のヒストグラム
+        \param y 二つ目の標本のヒストグラム
+        \return z値と両側p値
+    */
+    TestResult z_means(statistics::Histogram const & x, statistics::Histogram const & y);
+
+    //! A function.
+    /*!
+        標本平均が、確率質量関数の平均と等しいかどうかのz検定を行う
+        \param x 標本のヒストグラム
+        \param pmf 添字を値とする確率の可変長配列
+        \return z値と両側p値
+    */
+    TestResult z_mean_exact(statistics::Histogram const & x, std::vector<double> const & pmf);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _EQUIVALENCE_H_
@@ -0,0 +1,206 @@
+﻿/*! \file exactsolver.cpp
+    \brief 行・列が埋まるまでの回数の分布を厳密に求めるクラスの実装
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "exactsolver.h"
+#include <algorithm>            // for std::next_permutation
+#include <bitset>               // for std::bitset
+#include <cstdint>              // for std::uint64_t
+#include <numeric>              // for std::iota
+
+namespace validation {
+    namespace {
+        //! A function.
+        /*!
+            行・列ごとに、その行・列のマスのビットを立てたマスクを求める
+            \param row 行のサイズ
+            \param column 列のサイズ
+            \return 行・列のマスクの可変長配列（行、列の順）
+        */
+        std::vector<std::uint64_t> line_masks(std::int32_t row, std::int32_t column);
+
+        //! A function.
+        /*!
+            埋まっている行・列の数を数える
+            \param masks 行・列のマスクの可変長配列
+            \param filled 当たったマスのビットを立てたマスク
+            \return 埋まっている行・列の数
+        */
+        std::int32_t count_lines(std::vector<std::uint64_t> const & masks, std::uint64_t filled);
+    }
+
+    // #region コンストラクタ・デストラクタ
+
+    ExactSolver::ExactSolver(std::int32_t row, std::int32_t column, double tail)
+    {
+        auto const cells = row * column;
+        auto const lines = row + column;
+        auto const masks = line_masks(row, column);
+
+        // count[m][l]は、m個のマスからなる部分集合のうち、ちょうどl本の行・列が埋まっているものの数
+        std::vector<std::vector<std::uint64_t>> count(cells + 1, std::vector<std::uint64_t>(lines + 1, 0));
+        for (auto filled = 0ULL; filled < (1ULL << cells); filled++) {
+            count[std::bitset<64>(filled).count()][count_lines(masks, filled)]++;
+        }
+
+        // m個目のマスが埋まったときの行・列の数の分布は、m個のマスからなる部分集合の中での分布そのものになる
+        celllinespmf_.assign(cells, std::vector<double>(lines + 1, 0.0));
+        for (auto m = 1; m <= cells; m++) {
+            std::uint64_t total = 0;
+            for (auto l = 0; l <= lines; l++) {
+                total += count[m][l];
+            }
+
+            for (auto l = 0; l <= lines; l++) {
+                celllinespmf_[m - 1][l] = static_cast<double>(count[m][l]) / static_cast<double>(total);
+            }
+        }
+
+        // 最初のm個のマスでk本以上埋まっている確率から、k本目が埋まったときのマスの数の分布を求める
+        cellspmf_.assign(lines, std::vector<double>(cells + 1, 0.0));
+        for (auto k = 1; k <= lines; k++) {
+            auto prev = 0.0;
+            for (auto m = 0; m <= cells; m++) {
+                std::uint64_t total = 0, atleast = 0;
+                for (auto l = 0; l <= lines; l++) {
+                    total += count[m][l];
+                    if (l >= k) {
+                        atleast += count[m][l];
+                    }
+                }
+
+                auto const cdf = static_cast<double>(atleast) / static_cast<double>(total);
+                cellspmf_[k - 1][m] = cdf - prev;
+                prev = cdf;
+            }
+        }
+
+        // dist[i]は、n回抽選した時点でちょうどi個のマスが当たっている確率
+        // m個目のマスがn回目に当たる確率は、dist(n - 1回目)[m - 1] × (cells - m + 1) / cellsになる
+        auto const n0 = static_cast<double>(cells);
+        std::vector<double> dist(cells + 1, 0.0), next(cells + 1, 0.0);
+        dist[0] = 1.0;
+
+        // まだ全てのマスが当たっていない確率がtail未満になったら打ち切る
+        // （1 - dist[cells]では丸め誤差でtailを下回らないことがあるので、直接足し合わせる）
+        auto const remaining = [&dist, cells] {
+            auto sum = 0.0;
+            for (auto i = 0; i < cells; i++) {
+                sum += dist[i];
+            }
+
+            return sum;
+        };
+
+        drawspmf_.assign(lines, std::vector<double>(1, 0.0));
+        celldrawspmf_.assign(cells, std::vector<double>(1, 0.0));
+        for (auto n = 1; remaining() >= tail; n++) {
+            for (auto & pmf : drawspmf_) {
+                pmf.push_back(0.0);
+            }
+
+            for (auto m = 1; m <= cells; m++) {
+                auto const p = dist[m - 1] * static_cast<double>(cells - m + 1) / n0;
+                celldrawspmf_[m - 1].push_back(p);
+                for (auto k = 0; k < lines; k++) {
+                    drawspmf_[k][n] += cellspmf_[k][m] * p;
+                }
+            }
+
+            next[0] = 0.0;
+            for (auto i = 1; i <= cells; i++) {
+                next[i] = dist[i] * static_cast<double>(i) / n0 + dist[i - 1] * static_cast<double>(cells - i + 1) / n0;
+            }
+
+            dist.swap(next);
+        }
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region 非メンバ関数
+
+    std::vector<std::vector<double>> exhaustive_cells_pmf(std::int32_t row, std::int32_t column)
+    {
+        auto const cells = row * column;
+        auto const lines = row + column;
+        auto const masks = line_masks(row, column);
+
+        std::vector<std::vector<std::uint64_t>> count(lines, std::vector<std::uint64_t>(cells + 1, 0));
+        std::uint64_t total = 0;
+
+        std::vector<std::int32_t> order(cells);
+        std::iota(order.begin(), order.end(), 0);
+
+        do {
+            // 順番にマスを埋めていき、k本目が埋まったときのマスの数を数える
+            std::uint64_t filled = 0;
+            auto k = 0;
+            for (auto m = 1; m <= cells; m++) {
+                filled |= 1ULL << order[m - 1];
+                for (auto const l = count_lines(masks, filled); k < l; k++) {
+                    count[k][m]++;
+                }
+            }
+
+            total++;
+        } while (std::next_permutation(order.begin(), order.end()));
+
+        std::vector<std::vector<double>> pmf(lines, std::vector<double>(cells + 1, 0.0));
+        for (auto k = 0; k < lines; k++) {
+            for (auto m = 0; m <= cells; m++) {
+                pmf[k][m] = static_cast<double>(count[k][m]) / static_cast<double>(total);
+            }
+        }
+
+        return pmf;
+    }
+
+    std::pair<double, double> pmf_moments(std::vector<double> const & pmf)
+    {
+        auto mean = 0.0;
+        for (auto i = 0U; i < pmf.size(); i++) {
+            mean += static_cast<double>(i) * pmf[i];
+        }
+
+        auto var = 0.0;
+        for (auto i = 0U; i < pmf.size(); i++) {
+            auto const d = static_cast<double>(i) - mean;
+            var += d * d * pmf[i];
+        }
+
+        return std::make_pair(mean, var);
+    }
+
+    // #endregion 非メンバ関数
+
+    namespace {
+        std::vector<std::uint64_t> line_masks(std::int32_t row, std::int32_t column)
+        {
+            std::vector<std::uint64_t> masks(row + column, 0);
+            for (auto r = 0; r < row; r++) {
+                for (auto c = 0; c < column; c++) {
+                    masks[r] |= 1ULL << (r * column + c);
+                    masks[row + c] |= 1ULL << (r * column + c);
+                }
+            }
+
+            return masks;
+        }
+
+        std::int32_t count_lines(std::vector<std::uint64_t> const & masks, std::uint64_t filled)
+        {
+            auto cnt = 0;
+            for (auto const mask : masks) {
+                if ((filled & mask) == mask) {
+                    cnt++;
+                }
+            }
+
+            return cnt;
+        }
+    }
+}
@@ -0,0 +1,195 @@
+﻿/*! \file exactsolver.h
+    \brief 行・列が埋まるまでの回数の分布を厳密に求めるクラスの宣言
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _EXACTSOLVER_H_
+#define _EXACTSOLVER_H_
+
+#pragma once
+
+#include <cstdint>              // for std::int32_t
+#include <utility>              // for std::pair
+#include <vector>               // for std::vector
+
+namespace validation {
+    //! A class.
+    /*!
+        k本目の行・列が埋まるまでの抽選回数と、その時点で埋まっているマスの数の分布と、
+        m個目のマスが埋まるまでの抽選回数と、その時点で埋まっている行・列の数の分布を厳密に求めるクラス
+        抽選は全てのマスの数字から一様に（重複を許して）引くので、初めて当たるマスの順番は一様なランダムな順列になり、
+        その順番と、新しいマスが当たるまでの待ち回数（幾何分布）とは独立になることを利用する
+        マスの部分集合を全て数え上げるので、マス数が25程度までの盤面にしか使えない
+    */
+    class ExactSolver final {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            全てのマスの部分集合を数え上げて、分布を求める
+            \param row 行のサイズ
+            \param column 列のサイズ
+            \param tail 抽選回数の分布を打ち切る裾の確率
+        */
+        ExactSolver(std::int32_t row, std::int32_t column, double tail = 1.0E-15);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ExactSolver() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            m個目のマスが埋まるまでの抽選回数の確率質量関数（クーポンコレクター問題の分布）を返す
+            打ち切った裾の確率は含まない
+            \param m 何個目のマスか（1から始まる）
+            \return 添字を抽選回数とする確率の可変長配列
+        */
+        std::vector<double> const & cell_draws_pmf(std::int32_t m) const
+        {
+            return celldrawspmf_[m - 1];
+        }
+
+        //! A public member function.
+        /*!
+            m個目のマスが埋まったときに、埋まっている行・列の数の確率質量関数を返す
+            \param m 何個目のマスか（1から始まる）
+            \return 添字を行・列の数とする確率の可変長配列
+        */
+        std::vector<double> const & cell_lines_pmf(std::int32_t m) const
+        {
+            return celllinespmf_[m - 1];
+        }
+
+        //! A public member function.
+        /*!
+            マスの総数を返す
+            \return マスの総数
+        */
+        std::int32_t cells() const
+        {
+            return static_cast<std::int32_t>(celllinespmf_.size());
+        }
+
+        //! A public member function.
+        /*!
+            k本目の行・列が埋まったときに、埋まっているマスの数の確率質量関数を返す
+            \param k 何本目の行・列か（1から始まる）
+            \return 添字をマスの数とする確率の可変長配列
+        */
+        std::vector<double> const & cells_pmf(std::int32_t k) const
+        {
+            return cellspmf_[k - 1];
+        }
+
+        //! A public member function.
+        /*!
+            k本目の行・列が埋まるまでの抽選回数の確率質量関数を返す
+            打ち切った裾の確率は含まない
+            \param k 何本目の行・列か（1から始まる）
+            \return 添字を抽選回数とする確率の可変長配列
+        */
+        std::vector<double> const & draws_pmf(std::int32_t k) const
+        {
+            return drawspmf_[k - 1];
+        }
+
+        //! A public member function.
+        /*!
+            行・列の総数を返す
+            \return 行・列の総数
+        */
+        std::int32_t lines() const
+        {
+            return static_cast<std::int32_t>(cellspmf_.size());
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            マスごとの、抽選回数の確率質量関数
+        */
+        std::vector<std::vector<double>> celldrawspmf_;
+
+        //! A private member variable.
+        /*!
+            マスごとの、埋まっている行・列の数の確率質量関数
+        */
+        std::vector<std::vector<double>> celllinespmf_;
+
+        //! A private member variable.
+        /*!
+            行・列ごとの、埋まっているマスの数の確率質量関数
+        */
+        std::vector<std::vector<double>> cellspmf_;
+
+        //! A private member variable.
+        /*!
+            行・列ごとの、抽選回数の確率質量関数
+        */
+        std::vector<std::vector<double>> drawspmf_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ExactSolver() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        ExactSolver(ExactSolver const &) = delete;
+
+        //! operator=() (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        ExactSolver & operator=(ExactSolver const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region 非メンバ関数
+
+    //! A function.
+    /*!
+        マスが当たる順番を全て数え上げて、k本目の行・列が埋まったときに埋まっているマスの数の確率質量関数を求める
+        ExactSolverの検証用で、(行 × 列)!通りを数え上げるので、3 × 3程度の盤面にしか使えない
+        \param row 行のサイズ
+        \param column 列のサイズ
+        \return 行・列ごとの、添字をマスの数とする確率の可変長配列
+    */
+    std::vector<std::vector<double>> exhaustive_cells_pmf(std::int32_t row, std::int32_t column);
+
+    //! A function.
+    /*!
+        確率質量関数の平均と分散を求める
+        \param pmf 添字を値とする確率の可変長配列
+        \return 平均と分散のstd::pair
+    */
+    std::pair<double, double> pmf_moments(std::vector<double> const & pmf);
+
+    // #endregion 非メンバ関数
+}
+
+#endif  // _EXACTSOLVER_H_
@@ -0,0 +1,642 @@
+﻿/*! \file validation.cpp
+    \brief 二つのカーネル・乱数の組み合わせが、同じ分布を与えるかどうかを検証する
+
+    Copyright ©  2026 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "equivalence.h"
+#include "exactsolver.h"
+#include "../checkpoint/trialtrace.h"
+#include "../mabinogi_roulette_MC/montecarlo/geometric.h"
+#include "../mabinogi_roulette_MC/montecarlo/montecarlo.h"
+#include "../mabinogi_roulette_MC/montecarlo/tilting.h"
+#include "../mabinogi_roulette_MC/montecarlo/trialblock.h"
+#include "../mabinogi_roulette_MC/myrandom/myrand.h"
+#include "../mabinogi_roulette_MC/myrandom/myrandsfmt.h"
+#include "../mabinogi_roulette_MC/statistics/histogram.h"
+#include "../mabinogi_roulette_MC/statistics/weightedhistogram.h"
+#include <algorithm>                            // for std::max, std::min
+#include <array>                                // for std::array
+#include <atomic>                               // for std::atomic
+#include <cmath>                                // for std::fabs
+#include <cstdint>                              // for std::int32_t, std::uint64_t
+#include <cstdlib>                              // for EXIT_FAILURE
+#include <iostream>                             // for std::cerr, std::cout
+#include <limits>                               // for std::numeric_limits
+#include <optional>                             // for std::nullopt, std::optional
+#include <stdexcept>                            // for std::invalid_argument
+#include <string>                               // for std::string
+#include <vector>                               // for std::vector
+#include <boost/format.hpp>                     // for boost::format
+#include <boost/program_options.hpp>            // for boost::program_options
+#include <tbb/combinable.h>                     // for tbb::combinable
+#include <tbb/parallel_for.h>                   // for tbb::parallel_for
+
+namespace {
+    //! A global variable (constant expression).
+    /*!
+        既定の候補（SSE2が使えるならSFMT）
+    */
+#ifdef HAVE_SSE2
+    static auto constexpr DEFAULTCANDIDATE = "MyRandSfmt";
+#else
+    static auto constexpr DEFAULTCANDIDATE = "MyRand";
+#endif
+
+    //! A structure.
+    /*!
+        k本目の行・列が埋まるまでの抽選回数と、その時点で埋まっているマスの数のヒストグラムと、
+        m個目のマスが埋まるまでの抽選回数と、その時点で埋まっている行・列の数のヒストグラムを格納する構造体
+    */
+    struct LevelHistograms {
+        //! A public member variable.
+        /*!
+            行・列ごとの、抽選回数のヒストグラム
+        */
+        std::array<statistics::Histogram, montecarlo::ROWCOLUMN> draws;
+
+        //! A public member variable.
+        /*!
+            行・列ごとの、埋まっているマスの数のヒストグラム
+        */
+        std::array<statistics::Histogram, montecarlo::ROWCOLUMN> cells;
+
+        //! A public member variable.
+        /*!
+            マスごとの、抽選回数のヒストグラム
+        */
+        std::array<statistics::Histogram, montecarlo::BOARDSIZE> draws2;
+
+        //! A public member variable.
+        /*!
+            マスごとの、埋まっている行・列の数のヒストグラム
+        */
+        std::array<statistics::Histogram, montecarlo::BOARDSIZE> lines2;
+    };
+
+    //! A structure.
+    /*!
+        一つの検定の結果と、その検定を識別する情報を格納する構造体
+    */
+    struct TestRow {
+        //! A public member variable.
+        /*!
+            量の名称（行・列ごとのdrawsまたはcells、マスごとのdraws2またはlines2）
+        */
+        char const * quantity;
+
+        //! A public member variable.
+        /*!
+            何本目の行・列か、または何個目のマスか
+        */
+        std::int32_t level;
+
+        //! A public member variable.
+        /*!
+            検定の名称
+        */
+        std::string test;
+
+        //! A public member variable.
+        /*!
+            検定の結果
+        */
+        validation::TestResult result;
+    };
+
+    //! A function.
+    /*!
+        ExactSolverを、3 × 3の盤面で全ての順番を数え上げた結果と比べる
+        \return 一致したかどうか
+    */
+    bool check_exact_solver();
+
+    //! A function.
+    /*!
+        試行回数が2^31と2^32を超えても、度数、総和、試行の番号があふれないことを確かめる
+        \return あふれなかったかどうか
+    */
+    bool check_64bit_counters();
+
+    //! A function.
+    /*!
+        待ち時間の分布を傾けた重点サンプリングで推定した、行・列が埋まるまでの抽選回数の下側の裾の確率を、厳密解と比べる
+        \param solver 厳密解
+        \param trials 重点サンプリングの試行回数
+        \return 全ての行・列で、厳密解との差が標準誤差の5倍以内だったかどうか
+    */
+    bool check_rare_event(validation::ExactSolver const & solver, std::uint64_t trials);
+
+    //! A function.
+    /*!
+        量と何本目（何個目）かから、厳密解の確率質量関数を引く
+        \param solver 厳密解
+        \param quantity 量の名称（draws、cells、draws2、lines2）
+        \param k 何本目の行・列か、または何個目のマスか
+        \return 確率質量関数
+    */
+    std::vector<double> const & exact_pmf(validation::ExactSolver const & solver, std::string const & quantity, std::int32_t k);
+
+    //! A function.
+    /*!
+        量と何本目（何個目）かから、ヒストグラムを引く
+        \param h ヒストグラム
+        \param quantity 量の名称（draws、cells、draws2、lines2）
+        \param k 何本目の行・列か、または何個目のマスか
+        \return ヒストグラム
+    */
+    statistics::Histogram const & level_histogram(LevelHistograms const & h, std::string const & quantity, std::int32_t k);
+
+    //! A function template.
+    /*!
+        試行の番号が2^31と2^32をまたぐ範囲を、本体と同じmontecarlo::for_each_trialで走査し、
+        全ての試行をちょうど一回ずつ行うことと、それぞれの試行が(seed, 試行の番号 / SEEDBLOCK)の乱数列の、ブロックの中の順番の位置の乱数を使うことを確かめる
+        \param name 乱数の名称
+        \return 試行の回数と乱数列の割り当てが、全て正しかったかどうか
+    */
+    template <typename MyRandom>
+    bool check_trial_blocks(char const * name);
+
+    //! A function template.
+    /*!
+        乱数列の番号（試行のブロックの番号）が2^31と2^32の前後で、(seed, 乱数列の番号)から作った乱数列が、2^32の位だけが異なる番号の乱数列と異なることを確かめる
+        \param name 乱数の名称
+        \return 全ての試行を走査し、乱数列が全て異なっていたかどうか
+    */
+    template <typename MyRandom>
+    bool check_trial_streams(char const * name);
+
+    //! A function.
+    /*!
+        一つの組み合わせのシミュレーションを実行する
+        \param name 組み合わせの名称（MyRand、MyRandSfmt、Geometric）
+        \param trials 試行回数
+        \return ヒストグラム
+    */
+    LevelHistograms run_engine(std::string const & name, std::uint64_t trials);
+
+    //! A function.
+    /*!
+        指定された乱数で、montecarloImpl（GeometricがtrueならmontecarloGeometric）のシミュレーションを実行する
+        本体と同じmontecarlo::for_each_trialで、乱数のオブジェクトはSEEDBLOCK個の試行のブロックごとに生成する
+        \param trials 試行回数
+        \return ヒストグラム
+    */
+    template <typename MyRandom, bool Geometric = false>
+    LevelHistograms simulate(std::uint64_t trials);
+}
+
+int main(int argc, char * argv[])
+{
+    namespace po = boost::program_options;
+
+    // コマンドラインオプションの定義
+    po::options_description desc("オプション");
+    desc.add_options()
+        ("help,h", "ヘルプを表示する")
+        ("reference", po::value<std::string>()->default_value("MyRand"), "基準にする組み合わせ（MyRand、MyRandSfmt、Geometric）")
+        ("candidate", po::value<std::string>()->default_value(DEFAULTCANDIDATE), "検証する組み合わせ（MyRand、MyRandSfmt、Geometric）")
+        ("trials", po::value<std::uint64_t>()->default_value(100000), "それぞれの組み合わせの試行回数")
+        ("alpha", po::value<double>()->default_value(0.01), "全ての検定を合わせた有意水準（Bonferroniの補正で検定ごとの有意水準にする）")
+        ("no-exact", "厳密解との比較を行わない")
+        ("verbose", "全ての検定の結果を表示する");
+
+    // コマンドラインオプションを解析
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (po::error const & e) {
+        std::cerr << e.what() << '\n' << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc;
+
+        return 0;
+    }
+
+    auto passed = check_exact_solver();
+    passed &= check_64bit_counters();
+
+    auto const trials = vm["trials"].as<std::uint64_t>();
+    auto const refname = vm["reference"].as<std::string>();
+    auto const candname = vm["candidate"].as<std::string>();
+
+    LevelHistograms ref, cand;
+    try {
+        std::cout << boost::format("基準: %s, %d回\n") % refname % trials << std::flush;
+        ref = run_engine(refname, trials);
+
+        std::cout << boost::format("候補: %s, %d回\n") % candname % trials << std::flush;
+        cand = run_engine(candname, trials);
+    }
+    catch (std::invalid_argument const & e) {
+        std::cerr << e.what() << '\n' << desc;
+
+        return EXIT_FAILURE;
+    }
+
+    std::optional<validation::ExactSolver> exact;
+    if (!vm.count("no-exact")) {
+        exact.emplace(static_cast<std::int32_t>(montecarlo::ROW), static_cast<std::int32_t>(montecarlo::COLUMN));
+        passed &= check_rare_event(*exact, trials);
+    }
+
+    // 全ての検定を行う（行・列ごとの量の後に、マスごとの量を並べる）
+    std::vector<TestRow> rows;
+    auto const test = [&cand, candname, &exact, &ref, refname, &rows](char const * quantity, std::int32_t levels) {
+        for (auto k = 1; k <= levels; k++) {
+            auto const & x = level_histogram(ref, quantity, k);
+            auto const & y = level_histogram(cand, quantity, k);
+
+            rows.push_back({ quantity, k, "KS", validation::ks_two_sample(x, y) });
+            rows.push_back({ quantity, k, "chi2", validation::chi2_two_sample(x, y) });
+            rows.push_back({ quantity, k, "z", validation::z_means(x, y) });
+
+            if (exact) {
+                auto const & pmf = exact_pmf(*exact, quantity, k);
+                rows.push_back({ quantity, k, "chi2/exact/" + refname, validation::chi2_goodness(x, pmf) });
+                rows.push_back({ quantity, k, "chi2/exact/" + candname, validation::chi2_goodness(y, pmf) });
+                rows.push_back({ quantity, k, "z/exact/" + refname, validation::z_mean_exact(x, pmf) });
+                rows.push_back({ quantity, k, "z/exact/" + candname, validation::z_mean_exact(y, pmf) });
+            }
+        }
+    };
+
+    for (auto const quantity : { "draws", "cells" }) {
+        test(quantity, static_cast<std::int32_t>(montecarlo::ROWCOLUMN));
+    }
+
+    for (auto const quantity : { "draws2", "lines2" }) {
+        test(quantity, static_cast<std::int32_t>(montecarlo::BOARDSIZE));
+    }
+
+    auto const alpha = vm["alpha"].as<double>() / static_cast<double>(rows.size());
+    auto const verbose = vm.count("verbose") > 0;
+
+    std::cout << boost::format("検定の数 = %d, 検定ごとの有意水準 = %.3e\n") % rows.size() % alpha;
+    std::cout << boost::format("%-6s %5s %12s %12s %12s %12s  %s\n") % "value" % "level" % "mean(ref)" % "mean(cand)" % "mean(exact)" % "min p-value" % "result";
+
+    // 量と行・列（マス）ごとに、平均と最小のp値をまとめて表示する
+    for (auto i = 0U; i < rows.size();) {
+        auto j = i;
+        auto minp = 1.0;
+        auto ok = true;
+        while (j < rows.size() && rows[j].level == rows[i].level && rows[j].quantity == rows[i].quantity) {
+            minp = std::min(minp, rows[j].result.pvalue);
+            ok &= rows[j].result.pvalue >= alpha;
+            j++;
+        }
+
+        auto const k = rows[i].level;
+        auto const & x = level_histogram(ref, rows[i].quantity, k);
+        auto const & y = level_histogram(cand, rows[i].quantity, k);
+
+        std::cout << boost::format("%-6s %5d %12.4f %12.4f ") % rows[i].quantity % k % x.mean() % y.mean();
+        if (exact) {
+            std::cout << boost::format("%12.4f ") % validation::pmf_moments(exact_pmf(*exact, rows[i].quantity, k)).first;
+        }
+        else {
+            std::cout << boost::format("%12s ") % "-";
+        }
+        std::cout << boost::format("%12.3e  %s\n") % minp % (ok ? "PASS" : "FAIL");
+
+        for (; i < j; i++) {
+            if (verbose || rows[i].result.pvalue < alpha) {
+                std::cout << boost::format("    %-28s statistic = %12.5g, p-value = %.3e%s\n")
+                             % rows[i].test
+                             % rows[i].result.statistic
+                             % rows[i].result.pvalue
+                             % (rows[i].result.pvalue < alpha ? "  <- FAIL" : "");
+            }
+        }
+
+        passed &= ok;
+    }
+
+    std::cout << (passed ? "結果: PASS\n" : "結果: FAIL\n");
+
+    return passed ? 0 : EXIT_FAILURE;
+}
+
+namespace {
+    bool check_exact_solver()
+    {
+        auto const row = 3, column = 3;
+
+        validation::ExactSolver const solver(row, column);
+        auto const exhaustive = validation::exhaustive_cells_pmf(row, column);
+
+        auto maxdiff = 0.0;
+        for (auto k = 1; k <= solver.lines(); k++) {
+            auto const & pmf = solver.cells_pmf(k);
+            for (auto m = 0U; m < pmf.size(); m++) {
+                maxdiff = std::max(maxdiff, std::fabs(pmf[m] - exhaustive[k - 1][m]));
+            }
+        }
+
+        auto const ok = maxdiff < 1.0E-12;
+        std::cout << boost::format("厳密解の検証（3 × 3の盤面の全ての順番と比較）: 最大の差 = %.3e  %s\n") % maxdiff % (ok ? "PASS" : "FAIL");
+
+        return ok;
+    }
+
+    bool check_rare_event(validation::ExactSolver const & solver, std::uint64_t trials)
+    {
+        // 全てのマスが埋まる平均試行回数（約95回）よりずっと少ない抽選回数
+        auto constexpr DRAWS = 40;
+
+        montecarlo::ExponentialTilting const tilting(montecarlo::ExponentialTilting::solve(DRAWS));
+
+        std::vector<statistics::WeightedHistogram> hists(montecarlo::ROWCOLUMN);
+        for (auto trial = static_cast<std::uint64_t>(0); trial < trials; trial++) {
+            myrandom::MyRand mr(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE), 1, trial);
+            montecarlo::uniforms_t u;
+            montecarlo::fill_uniforms(mr, u);
+
+            montecarlo::weights_t weights;
+            auto const res = tilting.sample(u, weights);
+            for (auto k = 0U; k < montecarlo::ROWCOLUMN; k++) {
+                hists[k].add(res.first[k].first, weights[res.first[k].second - 1]);
+            }
+        }
+
+        // 厳密解との差を、標準誤差を単位として測る
+        auto maxz = 0.0, rarest = 1.0;
+        for (auto k = 1; k <= solver.lines(); k++) {
+            auto const & pmf = solver.draws_pmf(k);
+            auto exact = 0.0;
+            for (auto v = 0; v <= DRAWS && v < static_cast<std::int32_t>(pmf.size()); v++) {
+                exact += pmf[v];
+            }
+
+            auto const t = hists[k - 1].lower_tail(DRAWS);
+            maxz = std::max(maxz, t.se > 0.0 ? std::fabs(t.probability - exact) / t.se : (t.probability == exact ? 0.0 : std::numeric_limits<double>::infinity()));
+            rarest = std::min(rarest, exact);
+        }
+
+        auto const ok = maxz < 5.0;
+        std::cout << boost::format("重点サンプリングの検証（抽選回数が%d回以下になる確率（最小%.3e）を厳密解と比較）: 最大の差 = 標準誤差の%.2f倍  %s\n") % DRAWS % rarest % maxz % (ok ? "PASS" : "FAIL");
+
+        return ok;
+    }
+
+    std::vector<double> const & exact_pmf(validation::ExactSolver const & solver, std::string const & quantity, std::int32_t k)
+    {
+        if (quantity == "draws") {
+            return solver.draws_pmf(k);
+        }
+        else if (quantity == "cells") {
+            return solver.cells_pmf(k);
+        }
+        else if (quantity == "draws2") {
+            return solver.cell_draws_pmf(k);
+        }
+
+        return solver.cell_lines_pmf(k);
+    }
+
+    statistics::Histogram const & level_histogram(LevelHistograms const & h, std::string const & quantity, std::int32_t k)
+    {
+        if (quantity == "draws") {
+            return h.draws[k - 1];
+        }
+        else if (quantity == "cells") {
+            return h.cells[k - 1];
+        }
+        else if (quantity == "draws2") {
+            return h.draws2[k - 1];
+        }
+
+        return h.lines2[k - 1];
+    }
+
+    bool check_64bit_counters()
+    {
+        auto constexpr TWO31 = static_cast<std::uint64_t>(1) << 31;
+        auto constexpr TWO32 = static_cast<std::uint64_t>(1) << 32;
+
+        // 度数が2^32のヒストグラム（合計2^33回）
+        statistics::Histogram hist;
+        hist.add(10, TWO32);
+        hist.add(20, TWO32);
+
+        // 度数が2^31を超えるヒストグラムを二つ足し合わせる（合計2^32 + 2回）
+        statistics::Histogram lhs, rhs;
+        lhs.add(5, TWO31 + 1);
+        rhs.add(5, TWO31 + 1);
+        lhs.merge(rhs);
+
+        auto const histok = hist.total() == 2 * TWO32
+                         && hist.counts()[20] == TWO32
+                         && hist.mean() == 15.0
+                         && hist.median() == 15
+                         && hist.mode() == 10
+                         && hist.quantile(0.25) == 10
+                         && hist.quantile(0.75) == 20
+                         && lhs.total() == TWO32 + 2
+                         && lhs.counts()[5] == TWO32 + 2
+                         && lhs.mean() == 5.0;
+
+        std::cout << boost::format("64ビットの度数（合計 = 2^33回, 2^32 + 2回）: %s\n") % (histok ? "PASS" : "FAIL");
+
+        auto ok = histok;
+        ok &= check_trial_blocks<myrandom::MyRand>("MyRand");
+        ok &= check_trial_streams<myrandom::MyRand>("MyRand");
+#ifdef HAVE_SSE2
+        ok &= check_trial_blocks<myrandom::MyRandSfmt>("MyRandSfmt");
+        ok &= check_trial_streams<myrandom::MyRandSfmt>("MyRandSfmt");
+#endif
+
+        return ok;
+    }
+
+    template <typename MyRandom>
+    bool check_trial_blocks(char const * name)
+    {
+        auto constexpr TWO32 = static_cast<std::uint64_t>(1) << 32;
+        auto constexpr DRAWS = 4;
+        auto const seed = static_cast<std::uint64_t>(12345);
+
+        // 前後に2ブロックずつ取り、最後のブロックは途中で終わるようにする
+        auto constexpr BEFORE = 2 * montecarlo::SEEDBLOCK;
+        auto constexpr AFTER = 2 * montecarlo::SEEDBLOCK + montecarlo::SEEDBLOCK / 2;
+
+        std::uint64_t trials = 0, mismatched = 0;
+        auto ok = true;
+        for (auto const step : { static_cast<std::uint64_t>(1), static_cast<std::uint64_t>(2) }) {
+            for (auto const boundary : { TWO32 >> 1, TWO32 }) {
+                auto const begin = boundary - BEFORE;
+                auto const end = boundary + AFTER;
+
+                // 本体と同じく、終わった試行回数を試行の番号の続きで数える
+                std::atomic<std::uint64_t> completed(begin);
+                std::vector<std::atomic<std::int32_t>> visits(end - begin);
+                std::vector<std::array<std::int32_t, DRAWS>> numbers(end - begin);
+                montecarlo::for_each_trial<MyRandom>(
+                    begin,
+                    end,
+                    step,
+                    std::make_optional(seed),
+                    true,
+                    [begin, &completed, &numbers, step, &visits](std::uint64_t trial, MyRandom * mr) {
+                    visits[trial - begin]++;
+                    for (auto & x : numbers[trial - begin]) {
+                        x = mr->myrand();
+                    }
+
+                    completed += step;
+                });
+
+                // ブロックごとに乱数列を作り直し、ブロックの中の試行の順番に乱数を取り出して比べる
+                for (auto block = begin / montecarlo::SEEDBLOCK; block * montecarlo::SEEDBLOCK < end; block++) {
+                    MyRandom ref(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE), seed, block);
+                    for (auto trial = block * montecarlo::SEEDBLOCK; trial < std::min(end, (block + 1) * montecarlo::SEEDBLOCK); trial++) {
+                        auto const expected = (trial - begin) % step == 0 ? 1 : 0;
+                        ok &= visits[trial - begin] == expected;
+                        if (!expected) {
+                            continue;
+                        }
+
+                        trials += step;
+                        for (auto const x : numbers[trial - begin]) {
+                            if (x != ref.myrand()) {
+                                mismatched++;
+                            }
+                        }
+                    }
+                }
+
+                ok &= completed == end;
+            }
+        }
+
+        ok &= !mismatched;
+        std::cout << boost::format("2^31と2^32をまたぐ試行のブロック（%s）: 試行 = %d回, 乱数列の割り当ての誤り = %d回  %s\n")
+                     % name
+                     % trials
+                     % mismatched
+                     % (ok ? "PASS" : "FAIL");
+
+        return ok;
+    }
+
+    template <typename MyRandom>
+    bool check_trial_streams(char const * name)
+    {
+        auto constexpr TWO32 = static_cast<std::uint64_t>(1) << 32;
+        auto constexpr HALFWIDTH = static_cast<std::uint64_t>(1000);
+
+        // std::uint64_tの添字で、2^31と2^32をまたぐ乱数列の番号を並列に走査する
+        std::atomic<std::uint64_t> visited(0), same(0);
+        for (auto const boundary : { TWO32 >> 1, TWO32 }) {
+            tbb::parallel_for(
+                boundary - HALFWIDTH,
+                boundary + HALFWIDTH,
+                [&same, &visited](auto trial) {
+                // 試行の番号を32ビットに切り詰めると、2^32だけ離れた試行が同じ乱数列になってしまう
+                auto const seed = static_cast<std::uint64_t>(12345);
+                MyRandom mr(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE), seed, trial);
+                MyRandom other(1, static_cast<std::int32_t>(montecarlo::BOARDSIZE), seed, trial ^ TWO32);
+
+                // 16回続けて同じ数字になる確率は25^-16なので、偶然一致することはない
+                auto equal = true;
+                for (auto i = 0; i < 16; i++) {
+                    equal &= mr.myrand() == other.myrand();
+                }
+
+                if (equal) {
+                    same++;
+                }
+                visited++;
+            });
+        }
+
+        auto const ok = visited == 4 * HALFWIDTH && !same;
+        std::cout << boost::format("2^31と2^32をまたぐ試行の番号（%s）: 走査 = %d回, 2^32だけ離れた試行と同じ乱数列 = %d回  %s\n")
+                     % name
+                     % visited.load()
+                     % same.load()
+                     % (ok ? "PASS" : "FAIL");
+
+        return ok;
+    }
+
+    LevelHistograms run_engine(std::string const & name, std::uint64_t trials)
+    {
+        if (name == "MyRand") {
+            return simulate<myrandom::MyRand>(trials);
+        }
+#ifdef HAVE_SSE2
+        else if (name == "MyRandSfmt") {
+            return simulate<myrandom::MyRandSfmt>(trials);
+        }
+#endif
+        else if (name == "Geometric") {
+            return simulate<myrandom::MyRand, true>(trials);
+        }
+
+        throw std::invalid_argument("不明な組み合わせです: " + name);
+    }
+
+    template <typename MyRandom, bool Geometric>
+    LevelHistograms simulate(std::uint64_t trials)
+    {
+        tbb::combinable<LevelHistograms> local;
+
+        montecarlo::for_each_trial<MyRandom>(
+            static_cast<std::uint64_t>(0),
+            trials,
+            static_cast<std::uint64_t>(1),
+            std::nullopt,
+            true,
+            [&local](std::uint64_t, MyRandom * pmr) {
+            auto & mr = *pmr;
+            auto const res = [&mr] {
+                if constexpr (Geometric) {
+                    montecarlo::uniforms_t u;
+                    montecarlo::fill_uniforms(mr, u);
+
+                    return montecarlo::montecarloGeometric(u);
+                }
+                else {
+                    checkpoint::TrialTrace<false> trace;
+
+                    return montecarlo::montecarloImpl(mr, trace);
+                }
+            }();
+
+            auto & h = local.local();
+            for (auto k = 0U; k < montecarlo::ROWCOLUMN; k++) {
+                h.draws[k].add(res.first[k].first);
+                h.cells[k].add(res.first[k].second);
+            }
+
+            for (auto m = 0U; m < montecarlo::BOARDSIZE; m++) {
+                h.draws2[m].add(res.second[m].first);
+                h.lines2[m].add(res.second[m].second);
+            }
+        });
+
+        // スレッドごとのヒストグラムを足し合わせる
+        LevelHistograms sum;
+        local.combine_each([&sum](LevelHistograms const & h) {
+            for (auto k = 0U; k < montecarlo::ROWCOLUMN; k++) {
+                sum.draws[k].merge(h.draws[k]);
+                sum.cells[k].merge(h.cells[k]);
+            }
+
+            for (auto m = 0U; m < montecarlo::BOARDSIZE; m++) {
+                sum.draws2[m].merge(h.draws2[m]);
+                sum.lines2[m].merge(h.lines2[m]);
+            }
+        });
+
+        return sum;
+    }
+}